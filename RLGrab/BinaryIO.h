@@ -0,0 +1,215 @@
+#pragma once
+
+// Minimal little-endian binary encoding helpers for the plugin's own
+// on-disk formats (state handoff, exports, sighting history). Fixed-size
+// integers are little-endian whatever the host order; on little-endian hosts
+// (every Windows target) StoreLE/LoadLE compile to plain copies.
+//
+// BinaryReader never throws and never reads past the end: the first short
+// read flips ok() to false and every later read returns zeros, so decoders
+// can read a whole record and check ok() once.
+//
+// Portable, header-only.
+
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+template <typename T>
+inline void StoreLE(void* out, T v)
+{
+	static_assert(std::is_integral_v<T>);
+	if constexpr (std::endian::native == std::endian::little)
+	{
+		std::memcpy(out, &v, sizeof(v));
+	}
+	else
+	{
+		auto u = (std::make_unsigned_t<T>)v;
+		for (size_t i = 0; i < sizeof(T); ++i)
+			static_cast<uint8_t*>(out)[i] = (uint8_t)(u >> (8 * i));
+	}
+}
+
+template <typename T>
+inline T LoadLE(const void* in)
+{
+	static_assert(std::is_integral_v<T>);
+	if constexpr (std::endian::native == std::endian::little)
+	{
+		T v;
+		std::memcpy(&v, in, sizeof(v));
+		return v;
+	}
+	else
+	{
+		std::make_unsigned_t<T> u = 0;
+		for (size_t i = 0; i < sizeof(T); ++i)
+			u |= (std::make_unsigned_t<T>)static_cast<const uint8_t*>(in)[i] << (8 * i);
+		return (T)u;
+	}
+}
+
+class BinaryWriter
+{
+public:
+	void U8(uint8_t v) { buffer.push_back((char)v); }
+	void U32(uint32_t v) { Fixed(v); }
+	void U64(uint64_t v) { Fixed(v); }
+	void I32(int32_t v) { Fixed(v); }
+
+	// LEB128; most counts and lengths fit in one byte.
+	void VarU64(uint64_t v)
+	{
+		while (v >= 0x80)
+		{
+			buffer.push_back((char)(v | 0x80));
+			v >>= 7;
+		}
+		buffer.push_back((char)v);
+	}
+
+	// Zigzag, so small negative deltas stay short too.
+	void VarI64(int64_t v) { VarU64(((uint64_t)v << 1) ^ (uint64_t)(v >> 63)); }
+
+	void Str(std::string_view s)
+	{
+		VarU64(s.size());
+		buffer.append(s.data(), s.size());
+	}
+
+	void Raw(const void* p, size_t n) { buffer.append(static_cast<const char*>(p), n); }
+
+	// Overwrites a previously written fixed-size field (e.g. a length).
+	void PatchU64(size_t at, uint64_t v) { StoreLE(&buffer[at], v); }
+
+	size_t Size() const { return buffer.size(); }
+	const std::string& Data() const { return buffer; }
+	std::string& Data() { return buffer; }
+
+private:
+	template <typename T>
+	void Fixed(T v)
+	{
+		char bytes[sizeof(T)];
+		StoreLE(bytes, v);
+		Raw(bytes, sizeof(bytes));
+	}
+
+	std::string buffer;
+};
+
+class BinaryReader
+{
+public:
+	BinaryReader(const void* data, size_t size)
+		: p(static_cast<const uint8_t*>(data)), end(static_cast<const uint8_t*>(data) + size)
+	{
+	}
+
+	bool ok() const { return good; }
+	size_t Remaining() const { return (size_t)(end - p); }
+	const uint8_t* Cursor() const { return p; }
+
+	uint8_t U8()
+	{
+		uint8_t v = 0;
+		Raw(&v, 1);
+		return v;
+	}
+
+	uint32_t U32() { return Fixed<uint32_t>(); }
+	uint64_t U64() { return Fixed<uint64_t>(); }
+	int32_t I32() { return Fixed<int32_t>(); }
+
+	uint64_t VarU64()
+	{
+		uint64_t v = 0;
+		for (int shift = 0; shift < 64; shift += 7)
+		{
+			if (!good || p >= end)
+			{
+				good = false;
+				return 0;
+			}
+			uint8_t b = *p++;
+			v |= (uint64_t)(b & 0x7F) << shift;
+			if ((b & 0x80) == 0)
+				return v;
+		}
+		good = false;
+		return 0;
+	}
+
+	int64_t VarI64()
+	{
+		uint64_t v = VarU64();
+		return (int64_t)(v >> 1) ^ -(int64_t)(v & 1);
+	}
+
+	// Zero-copy view into the source buffer.
+	std::string_view StrView()
+	{
+		uint64_t n = VarU64();
+		if (!good || n > Remaining())
+		{
+			good = false;
+			return {};
+		}
+		std::string_view s(reinterpret_cast<const char*>(p), (size_t)n);
+		p += n;
+		return s;
+	}
+
+	std::string Str() { return std::string(StrView()); }
+
+	void Raw(void* out, size_t n)
+	{
+		if (!good || n > Remaining())
+		{
+			good = false;
+			std::memset(out, 0, n);
+			return;
+		}
+		std::memcpy(out, p, n);
+		p += n;
+	}
+
+	void Skip(size_t n)
+	{
+		if (!good || n > Remaining())
+		{
+			good = false;
+			return;
+		}
+		p += n;
+	}
+
+private:
+	template <typename T>
+	T Fixed()
+	{
+		uint8_t bytes[sizeof(T)];
+		Raw(bytes, sizeof(bytes)); // zeros on a short read
+		return LoadLE<T>(bytes);
+	}
+
+	const uint8_t* p;
+	const uint8_t* end;
+	bool good = true;
+};
+
+// FNV-1a, used as a cheap integrity check on our own files.
+inline uint64_t Fnv1a64(const void* data, size_t n, uint64_t h = 0xCBF29CE484222325ull)
+{
+	const uint8_t* b = static_cast<const uint8_t*>(data);
+	for (size_t i = 0; i < n; ++i)
+	{
+		h ^= b[i];
+		h *= 0x100000001B3ull;
+	}
+	return h;
+}
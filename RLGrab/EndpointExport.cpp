@@ -0,0 +1,405 @@
+#include "EndpointExport.h"
+#include "BinaryIO.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <system_error>
+#include <unordered_map>
+
+namespace
+{
+	constexpr size_t kFetchBatch = 4096;       // rows per fetch (one lock hold in the plugin)
+	constexpr size_t kBlockRows = 65536;       // rows per columnar block
+	constexpr size_t kFlushBytes = 1 << 20;    // buffered writer threshold
+
+	constexpr uint32_t kColumnarMagic = 0x58474C52; // "RLGX"
+	constexpr uint32_t kColumnarVersion = 1;
+	constexpr uint32_t kBlockMarker = 0x314B4C42;   // "BLK1"
+	constexpr uint32_t kEndMarker = 0x31444E45;     // "END1"
+
+	// Accumulates output and hands it to the stream in large writes.
+	class BufferedFileWriter
+	{
+	public:
+		bool Open(const std::string& path)
+		{
+			out.open(path, std::ios::out | std::ios::binary | std::ios::trunc);
+			buffer.reserve(kFlushBytes + (kFlushBytes >> 2));
+			return out.is_open();
+		}
+
+		std::string& Buffer() { return buffer; }
+
+		bool MaybeFlush() { return buffer.size() < kFlushBytes || Flush(); }
+
+		bool Flush()
+		{
+			if (!buffer.empty())
+				out.write(buffer.data(), (std::streamsize)buffer.size());
+			buffer.clear();
+			return (bool)out;
+		}
+
+		bool Close()
+		{
+			bool ok = Flush();
+			out.close();
+			return ok && !out.fail();
+		}
+
+	private:
+		std::ofstream out;
+		std::string buffer;
+	};
+
+	void AppendUnsigned(std::string& out, uint64_t v)
+	{
+		char buf[24];
+		int n = std::snprintf(buf, sizeof(buf), "%llu", (unsigned long long)v);
+		out.append(buf, (size_t)n);
+	}
+
+	// Streams rows into blocks; the dictionary carries over between blocks
+	// and only new entries are written with each block.
+	class ColumnarEncoder
+	{
+	public:
+		ColumnarEncoder()
+		{
+			Intern("");
+		}
+
+		void Header(std::string& out)
+		{
+			BinaryWriter w;
+			w.U32(kColumnarMagic);
+			w.U32(kColumnarVersion);
+			out += w.Data();
+		}
+
+		void Add(const EndpointRecord& record)
+		{
+			rows.push_back(&record);
+		}
+
+		size_t Pending() const { return rows.size(); }
+
+		// Encodes the pending rows as one block. Rows must stay alive until then.
+		void FlushBlock(std::string& out)
+		{
+			if (rows.empty())
+				return;
+
+			size_t dictBefore = dictionary.size();
+			std::vector<uint32_t> nameIds, sourceIds;
+			nameIds.reserve(rows.size());
+			sourceIds.reserve(rows.size());
+			for (const EndpointRecord* r : rows)
+			{
+				nameIds.push_back(Intern(r->serverName));
+				sourceIds.push_back(Intern(r->source));
+				for (const auto& f : r->fields)
+					Intern(f.first);
+			}
+
+			BinaryWriter w;
+			w.U32(kBlockMarker);
+			size_t lengthAt = w.Size();
+			w.U64(0);
+			size_t bodyStart = w.Size();
+
+			w.VarU64(rows.size());
+			w.VarU64(dictionary.size() - dictBefore);
+			for (size_t i = dictBefore; i < dictionary.size(); ++i)
+				w.Str(dictionary[i]);
+
+			for (uint32_t id : nameIds)
+				w.VarU64(id);
+			for (uint32_t id : sourceIds)
+				w.VarU64(id);
+			for (const EndpointRecord* r : rows)
+				w.Str(r->gameUrl);
+
+			uint64_t previous = 0;
+			for (const EndpointRecord* r : rows)
+			{
+				w.VarI64((int64_t)(r->firstSeenMs - previous));
+				previous = r->firstSeenMs;
+			}
+			for (const EndpointRecord* r : rows)
+				w.VarI64((int64_t)(r->lastSeenMs - r->firstSeenMs));
+
+			for (const EndpointRecord* r : rows)
+			{
+				w.VarU64(r->fields.size());
+				for (const auto& f : r->fields)
+				{
+					w.VarU64(ids[f.first]);
+					w.Str(f.second);
+				}
+			}
+
+			w.PatchU64(lengthAt, w.Size() - bodyStart);
+			out += w.Data();
+			total += rows.size();
+			rows.clear();
+		}
+
+		void Trailer(std::string& out)
+		{
+			BinaryWriter w;
+			w.U32(kEndMarker);
+			w.U64(total);
+			out += w.Data();
+		}
+
+	private:
+		uint32_t Intern(const std::string& s)
+		{
+			auto [it, inserted] = ids.try_emplace(s, (uint32_t)dictionary.size());
+			if (inserted)
+				dictionary.push_back(s);
+			return it->second;
+		}
+
+		std::unordered_map<std::string, uint32_t> ids;
+		std::vector<std::string> dictionary;
+		std::vector<const EndpointRecord*> rows;
+		uint64_t total = 0;
+	};
+}
+
+bool ParseExportFormat(const std::string& name, ExportFormat& out)
+{
+	if (name == "csv")
+		out = ExportFormat::Csv;
+	else if (name == "jsonl" || name == "json")
+		out = ExportFormat::JsonLines;
+	else if (name == "bin" || name == "columnar")
+		out = ExportFormat::Columnar;
+	else
+		return false;
+	return true;
+}
+
+const char* ExportFileExtension(ExportFormat format)
+{
+	switch (format)
+	{
+	case ExportFormat::Csv: return ".csv";
+	case ExportFormat::JsonLines: return ".jsonl";
+	case ExportFormat::Columnar: return ".rlgx";
+	}
+	return "";
+}
+
+void AppendCsvField(std::string& out, const std::string& value)
+{
+	if (value.find_first_of(",\"\r\n") == std::string::npos)
+	{
+		out += value;
+		return;
+	}
+	out += '"';
+	for (char c : value)
+	{
+		if (c == '"')
+			out += '"';
+		out += c;
+	}
+	out += '"';
+}
+
+void AppendJsonString(std::string& out, const std::string& value)
+{
+	out += '"';
+	for (unsigned char c : value)
+	{
+		switch (c)
+		{
+		case '"': out += "\\\""; break;
+		case '\\': out += "\\\\"; break;
+		case '\n': out += "\\n"; break;
+		case '\r': out += "\\r"; break;
+		case '\t': out += "\\t"; break;
+		default:
+			if (c < 0x20)
+			{
+				char buf[8];
+				std::snprintf(buf, sizeof(buf), "\\u%04x", c);
+				out += buf;
+			}
+			else
+			{
+				out += (char)c;
+			}
+		}
+	}
+	out += '"';
+}
+
+void AppendCsvHeader(std::string& out, const std::vector<std::string>& extraColumns, bool withTimes)
+{
+	out += "source,label,serverName,gameUrl";
+	if (withTimes)
+		out += ",firstSeenMs,lastSeenMs";
+	for (const auto& column : extraColumns)
+	{
+		out += ',';
+		AppendCsvField(out, column);
+	}
+	out += '\n';
+}
+
+void AppendCsvRecord(std::string& out, const EndpointRecord& record, const std::vector<std::string>& extraColumns, bool withTimes)
+{
+	AppendCsvField(out, record.source);
+	out += ',';
+	AppendCsvField(out, record.label);
+	out += ',';
+	AppendCsvField(out, record.serverName);
+	out += ',';
+	AppendCsvField(out, record.gameUrl);
+	if (withTimes)
+	{
+		out += ',';
+		AppendUnsigned(out, record.firstSeenMs);
+		out += ',';
+		AppendUnsigned(out, record.lastSeenMs);
+	}
+	for (const auto& column : extraColumns)
+	{
+		out += ',';
+		if (const std::string* v = record.Field(column))
+			AppendCsvField(out, *v);
+	}
+	out += '\n';
+}
+
+void AppendJsonRecord(std::string& out, const EndpointRecord& record, bool withTimes)
+{
+	out += "{\"source\":";
+	AppendJsonString(out, record.source);
+	out += ",\"label\":";
+	AppendJsonString(out, record.label);
+	out += ",\"serverName\":";
+	AppendJsonString(out, record.serverName);
+	out += ",\"gameUrl\":";
+	AppendJsonString(out, record.gameUrl);
+	if (withTimes)
+	{
+		out += ",\"firstSeenMs\":";
+		AppendUnsigned(out, record.firstSeenMs);
+		out += ",\"lastSeenMs\":";
+		AppendUnsigned(out, record.lastSeenMs);
+	}
+	out += ",\"fields\":{";
+	for (size_t i = 0; i < record.fields.size(); ++i)
+	{
+		if (i > 0)
+			out += ',';
+		AppendJsonString(out, record.fields[i].first);
+		out += ':';
+		AppendJsonString(out, record.fields[i].second);
+	}
+	out += "}}\n";
+}
+
+bool ExportEndpoints(const ExportRequest& request, std::string* error)
+{
+	auto fail = [&](const std::string& why)
+		{
+			if (error)
+				*error = why;
+			return false;
+		};
+
+	std::string tmp = request.path + ".partial";
+	BufferedFileWriter writer;
+	if (!writer.Open(tmp))
+		return fail("cannot create " + tmp);
+
+	auto abandon = [&](const std::string& why)
+		{
+			writer.Close();
+			std::error_code ec;
+			std::filesystem::remove(tmp, ec);
+			return fail(why);
+		};
+
+	ColumnarEncoder columnar;
+	std::string& out = writer.Buffer();
+	switch (request.format)
+	{
+	case ExportFormat::Csv:
+		AppendCsvHeader(out, request.extraColumns, true);
+		break;
+	case ExportFormat::Columnar:
+		columnar.Header(out);
+		break;
+	case ExportFormat::JsonLines:
+		break;
+	}
+
+	// Columnar blocks keep pointers into the batches until they are encoded.
+	std::vector<std::vector<EndpointRecord>> held;
+	std::vector<EndpointRecord> batch;
+
+	for (uint64_t first = 0; first < request.totalRows; first += kFetchBatch)
+	{
+		if (request.cancel && request.cancel->load())
+			return abandon("cancelled");
+
+		size_t count = (size_t)std::min<uint64_t>(kFetchBatch, request.totalRows - first);
+		batch.clear();
+		if (!request.fetch(first, count, batch))
+			return abandon("endpoint store changed during export");
+
+		switch (request.format)
+		{
+		case ExportFormat::Csv:
+			for (const auto& r : batch)
+				AppendCsvRecord(out, r, request.extraColumns, true);
+			break;
+		case ExportFormat::JsonLines:
+			for (const auto& r : batch)
+				AppendJsonRecord(out, r, true);
+			break;
+		case ExportFormat::Columnar:
+			held.push_back(std::move(batch));
+			batch = std::vector<EndpointRecord>();
+			for (const auto& r : held.back())
+				columnar.Add(r);
+			if (columnar.Pending() >= kBlockRows)
+			{
+				columnar.FlushBlock(out);
+				held.clear();
+			}
+			break;
+		}
+
+		if (!writer.MaybeFlush())
+			return abandon("write to " + tmp + " failed");
+		if (request.progressRows)
+			request.progressRows->store(first + count);
+	}
+
+	if (request.format == ExportFormat::Columnar)
+	{
+		columnar.FlushBlock(out);
+		columnar.Trailer(out);
+	}
+	if (!writer.Close())
+		return abandon("write to " + tmp + " failed");
+
+	std::error_code ec;
+	std::filesystem::rename(tmp, request.path, ec);
+	if (ec)
+	{
+		std::filesystem::remove(tmp, ec);
+		return fail("cannot rename " + tmp + " to " + request.path);
+	}
+	return true;
+}
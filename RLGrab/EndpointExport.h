@@ -0,0 +1,73 @@
+#pragma once
+
+// Streaming export of stored endpoints to CSV, JSON Lines or a compact
+// columnar binary file.
+//
+// Records are pulled from the caller in batches and encoded through a
+// buffered writer, so neither the store nor the output is ever held in
+// memory as a whole. The file is written under a temporary name and renamed
+// into place only when complete.
+//
+// Columnar binary layout (little-endian, varints are LEB128, "zz" = zigzag):
+//   header   "RLGX" u32 version=1
+//   block*   u32 marker "BLK1", u64 byteLength of the rest of the block,
+//            varint rowCount,
+//            dictionary delta: varint n, n x str   (appended to the string
+//                                                  dictionary; id 0 is "")
+//            serverName column: rowCount x varint dict id
+//            source column:     rowCount x varint dict id
+//            gameUrl column:    rowCount x str
+//            firstSeen column:  rowCount x zz varint delta from previous row
+//                               (the first row of a block from 0)
+//            lastSeen column:   rowCount x zz varint (lastSeen - firstSeen)
+//            fields column:     rowCount x (varint n, n x (varint key id, str value))
+//   trailer  u32 marker "END1", u64 total rows
+// A str is a varint length followed by the bytes.
+//
+// Portable, no SDK dependencies.
+
+#include "EndpointRecord.h"
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+enum class ExportFormat
+{
+	Csv,
+	JsonLines,
+	Columnar,
+};
+
+// "csv", "jsonl" or "bin"; false for anything else.
+bool ParseExportFormat(const std::string& name, ExportFormat& out);
+const char* ExportFileExtension(ExportFormat format);
+
+// Text encoders shared with the headless scanner. `extraColumns` names the
+// rule fields that get their own CSV column; JSON writes all fields.
+void AppendCsvField(std::string& out, const std::string& value);
+void AppendJsonString(std::string& out, const std::string& value);
+void AppendCsvHeader(std::string& out, const std::vector<std::string>& extraColumns, bool withTimes);
+void AppendCsvRecord(std::string& out, const EndpointRecord& record, const std::vector<std::string>& extraColumns, bool withTimes);
+void AppendJsonRecord(std::string& out, const EndpointRecord& record, bool withTimes);
+
+struct ExportRequest
+{
+	std::string path;
+	ExportFormat format = ExportFormat::Csv;
+	std::vector<std::string> extraColumns; // CSV only
+	uint64_t totalRows = 0;                // rows the fetcher will be asked for
+
+	// Appends rows [first, first + count) to `out`, oldest first. Returning
+	// false aborts the export (e.g. the store was reset meanwhile).
+	std::function<bool(uint64_t first, size_t count, std::vector<EndpointRecord>& out)> fetch;
+
+	std::atomic<uint64_t>* progressRows = nullptr; // updated after every batch
+	const std::atomic<bool>* cancel = nullptr;
+};
+
+// Runs the export on the calling thread. Returns false with `error` on I/O
+// failure, cancellation or an aborted fetch; no partial file is left behind.
+bool ExportEndpoints(const ExportRequest& request, std::string* error = nullptr);
@@ -0,0 +1,554 @@
+#include "EndpointQuery.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+
+namespace
+{
+	// Ranges longer than this are not counted exactly when picking the
+	// driving index; they just rank behind every range that fits.
+	constexpr uint64_t kProbeLimit = 512;
+
+	std::string Fold(std::string_view s)
+	{
+		std::string out(s);
+		for (char& c : out)
+			c = (char)std::tolower((unsigned char)c);
+		return out;
+	}
+
+	bool StartsWith(std::string_view s, std::string_view prefix)
+	{
+		return s.size() >= prefix.size() && s.compare(0, prefix.size(), prefix) == 0;
+	}
+
+	bool ParseUnsigned(std::string_view s, uint64_t& out)
+	{
+		if (s.empty() || s.size() > 19)
+			return false;
+		uint64_t v = 0;
+		for (char c : s)
+		{
+			if (c < '0' || c > '9')
+				return false;
+			v = v * 10 + (uint64_t)(c - '0');
+		}
+		out = v;
+		return true;
+	}
+
+	bool ParseIpv4(std::string_view s, uint32_t& out)
+	{
+		uint32_t v = 0;
+		for (int octet = 0; octet < 4; ++octet)
+		{
+			if (octet > 0)
+			{
+				if (s.empty() || s[0] != '.')
+					return false;
+				s.remove_prefix(1);
+			}
+			size_t digits = 0;
+			uint32_t part = 0;
+			while (digits < s.size() && digits < 4 && s[digits] >= '0' && s[digits] <= '9')
+				part = part * 10 + (uint32_t)(s[digits++] - '0');
+			if (digits == 0 || digits > 3 || part > 255)
+				return false;
+			s.remove_prefix(digits);
+			v = (v << 8) | part;
+		}
+		if (!s.empty())
+			return false;
+		out = v;
+		return true;
+	}
+
+	// Hex groups on one side of "::"; a dotted IPv4 tail counts as two groups.
+	bool ParseIpv6Groups(std::string_view s, std::vector<uint16_t>& groups, bool allowV4Tail)
+	{
+		if (s.empty())
+			return true;
+		size_t start = 0;
+		while (true)
+		{
+			size_t colon = s.find(':', start);
+			std::string_view part = s.substr(start, colon == std::string_view::npos ? std::string_view::npos : colon - start);
+			if (colon == std::string_view::npos && allowV4Tail && part.find('.') != std::string_view::npos)
+			{
+				uint32_t v4;
+				if (!ParseIpv4(part, v4))
+					return false;
+				groups.push_back((uint16_t)(v4 >> 16));
+				groups.push_back((uint16_t)(v4 & 0xFFFF));
+				return true;
+			}
+			if (part.empty() || part.size() > 4)
+				return false;
+			uint16_t g = 0;
+			for (char c : part)
+			{
+				int d = std::isdigit((unsigned char)c) ? c - '0'
+					: (c >= 'a' && c <= 'f') ? c - 'a' + 10
+					: (c >= 'A' && c <= 'F') ? c - 'A' + 10 : -1;
+				if (d < 0)
+					return false;
+				g = (uint16_t)((g << 4) | d);
+			}
+			groups.push_back(g);
+			if (colon == std::string_view::npos)
+				return true;
+			start = colon + 1;
+		}
+	}
+
+	IpKey MaskLow(IpKey key, int prefixBits)
+	{
+		if (prefixBits <= 0)
+			return {};
+		if (prefixBits < 64)
+			return { key.hi & ~(UINT64_MAX >> prefixBits), 0 };
+		if (prefixBits < 128)
+			return { key.hi, key.lo & ~(UINT64_MAX >> (prefixBits - 64)) };
+		return key;
+	}
+
+	IpKey MaskHigh(IpKey key, int prefixBits)
+	{
+		if (prefixBits <= 0)
+			return { UINT64_MAX, UINT64_MAX };
+		if (prefixBits < 64)
+			return { key.hi | (UINT64_MAX >> prefixBits), UINT64_MAX };
+		if (prefixBits < 128)
+			return { key.hi, key.lo | (UINT64_MAX >> (prefixBits - 64)) };
+		return key;
+	}
+
+	int64_t DaysFromCivil(int64_t y, unsigned m, unsigned d)
+	{
+		y -= m <= 2;
+		const int64_t era = (y >= 0 ? y : y - 399) / 400;
+		const unsigned yoe = (unsigned)(y - era * 400);
+		const unsigned doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+		const unsigned doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+		return era * 146097 + (int64_t)doe - 719468;
+	}
+
+	void CivilFromDays(int64_t z, int64_t& y, unsigned& m, unsigned& d)
+	{
+		z += 719468;
+		const int64_t era = (z >= 0 ? z : z - 146096) / 146097;
+		const unsigned doe = (unsigned)(z - era * 146097);
+		const unsigned yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+		const unsigned doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+		const unsigned mp = (5 * doy + 2) / 153;
+		d = doy - (153 * mp + 2) / 5 + 1;
+		m = mp < 10 ? mp + 3 : mp - 9;
+		y = (int64_t)yoe + era * 400 + (m <= 2);
+	}
+
+	// "7d" / "15m" ago, "2026-10-19[T14:30[:05]]" UTC, or raw unix ms.
+	bool ParseTime(std::string_view s, uint64_t nowMs, uint64_t& out)
+	{
+		if (s.empty())
+			return false;
+
+		uint64_t unit = 0;
+		switch (s.back())
+		{
+		case 's': unit = 1000ull; break;
+		case 'm': unit = 60ull * 1000; break;
+		case 'h': unit = 3600ull * 1000; break;
+		case 'd': unit = 86400ull * 1000; break;
+		case 'w': unit = 7ull * 86400 * 1000; break;
+		}
+		uint64_t n;
+		if (unit != 0 && ParseUnsigned(s.substr(0, s.size() - 1), n))
+		{
+			uint64_t ago = n * unit;
+			out = ago >= nowMs ? 0 : nowMs - ago;
+			return true;
+		}
+
+		if (s.size() >= 10 && s[4] == '-' && s[7] == '-')
+		{
+			uint64_t y, mo, d, h = 0, mi = 0, sec = 0;
+			if (!ParseUnsigned(s.substr(0, 4), y) || !ParseUnsigned(s.substr(5, 2), mo) || !ParseUnsigned(s.substr(8, 2), d))
+				return false;
+			std::string_view rest = s.substr(10);
+			if (!rest.empty())
+			{
+				if (rest.size() < 6 || (rest[0] != 'T' && rest[0] != 't') || rest[3] != ':'
+					|| !ParseUnsigned(rest.substr(1, 2), h) || !ParseUnsigned(rest.substr(4, 2), mi))
+					return false;
+				rest.remove_prefix(6);
+				if (!rest.empty() && (rest.size() != 3 || rest[0] != ':' || !ParseUnsigned(rest.substr(1), sec)))
+					return false;
+			}
+			if (mo < 1 || mo > 12 || d < 1 || d > 31 || h > 23 || mi > 59 || sec > 60)
+				return false;
+			int64_t days = DaysFromCivil((int64_t)y, (unsigned)mo, (unsigned)d);
+			if (days < 0)
+				return false;
+			out = (((uint64_t)days * 24 + h) * 60 + mi) * 60 * 1000 + sec * 1000;
+			return true;
+		}
+
+		return ParseUnsigned(s, out);
+	}
+}
+
+bool ParseIpAddress(std::string_view text, IpKey& out, bool* isV4)
+{
+	uint32_t v4;
+	if (ParseIpv4(text, v4))
+	{
+		out = { 0, 0x0000FFFF00000000ull | v4 };
+		if (isV4)
+			*isV4 = true;
+		return true;
+	}
+
+	auto zone = text.find('%');
+	if (zone != std::string_view::npos)
+		text = text.substr(0, zone);
+
+	std::vector<uint16_t> head, tail;
+	auto gap = text.find("::");
+	if (gap == std::string_view::npos)
+	{
+		if (!ParseIpv6Groups(text, head, true) || head.size() != 8)
+			return false;
+	}
+	else
+	{
+		if (text.find("::", gap + 1) != std::string_view::npos)
+			return false;
+		if (!ParseIpv6Groups(text.substr(0, gap), head, false) || !ParseIpv6Groups(text.substr(gap + 2), tail, true))
+			return false;
+		if (head.size() + tail.size() > 7)
+			return false;
+		head.resize(8 - tail.size(), 0);
+		head.insert(head.end(), tail.begin(), tail.end());
+	}
+
+	IpKey key;
+	for (int i = 0; i < 4; ++i)
+		key.hi = (key.hi << 16) | head[i];
+	for (int i = 4; i < 8; ++i)
+		key.lo = (key.lo << 16) | head[i];
+	out = key;
+	if (isV4)
+		*isV4 = false;
+	return true;
+}
+
+void SplitGameUrl(std::string_view gameUrl, std::string_view& host, std::string_view& port)
+{
+	host = gameUrl;
+	port = std::string_view();
+	if (!gameUrl.empty() && gameUrl[0] == '[')
+	{
+		size_t close = gameUrl.find(']');
+		if (close == std::string_view::npos)
+			return;
+		host = gameUrl.substr(1, close - 1);
+		if (close + 1 < gameUrl.size() && gameUrl[close + 1] == ':')
+			port = gameUrl.substr(close + 2);
+		return;
+	}
+
+	// One colon is "ip:port"; more than one is a bare IPv6 address.
+	size_t colon = gameUrl.find(':');
+	if (colon != std::string_view::npos && gameUrl.find(':', colon + 1) == std::string_view::npos)
+	{
+		host = gameUrl.substr(0, colon);
+		port = gameUrl.substr(colon + 1);
+	}
+}
+
+bool ParseGameUrlAddress(std::string_view gameUrl, IpKey& out)
+{
+	std::string_view host, port;
+	SplitGameUrl(gameUrl, host, port);
+	return ParseIpAddress(host, out);
+}
+
+bool ParseQueryTime(std::string_view s, uint64_t nowMs, uint64_t& out)
+{
+	return ParseTime(s, nowMs, out);
+}
+
+std::string FormatUnixMs(uint64_t unixMs)
+{
+	uint64_t secs = unixMs / 1000;
+	int64_t y;
+	unsigned m, d;
+	CivilFromDays((int64_t)(secs / 86400), y, m, d);
+	unsigned daySecs = (unsigned)(secs % 86400);
+
+	char buf[32];
+	std::snprintf(buf, sizeof(buf), "%04lld-%02u-%02u %02u:%02u:%02u",
+		(long long)y, m, d, daySecs / 3600, daySecs / 60 % 60, daySecs % 60);
+	return buf;
+}
+
+bool ParseEndpointFilter(std::string_view expression, uint64_t nowMs, EndpointFilter& out, std::string* error)
+{
+	EndpointFilter filter;
+	auto fail = [&](std::string_view term, const char* why)
+		{
+			if (error)
+				*error = std::string(why) + ": " + std::string(term);
+			return false;
+		};
+
+	size_t pos = 0;
+	while (pos < expression.size())
+	{
+		while (pos < expression.size() && std::isspace((unsigned char)expression[pos]))
+			++pos;
+		size_t end = pos;
+		while (end < expression.size() && !std::isspace((unsigned char)expression[end]))
+			++end;
+		std::string_view term = expression.substr(pos, end - pos);
+		pos = end;
+		if (term.empty())
+			continue;
+
+		if (StartsWith(term, "name:"))
+		{
+			std::string_view prefix = term.substr(5);
+			if (!prefix.empty() && prefix.back() == '*')
+				prefix.remove_suffix(1);
+			filter.hasName = true;
+			filter.namePrefix = Fold(prefix);
+		}
+		else if (StartsWith(term, "ip:"))
+		{
+			std::string_view addr = term.substr(3);
+			uint64_t bits = 0;
+			bool hasBits = false;
+			auto slash = addr.find('/');
+			if (slash != std::string_view::npos)
+			{
+				if (!ParseUnsigned(addr.substr(slash + 1), bits))
+					return fail(term, "bad prefix length");
+				hasBits = true;
+				addr = addr.substr(0, slash);
+			}
+
+			IpKey key;
+			bool isV4 = false;
+			if (!ParseIpAddress(addr, key, &isV4))
+				return fail(term, "bad address");
+			if ((isV4 && bits > 32) || bits > 128)
+				return fail(term, "bad prefix length");
+			int prefixBits = isV4 ? 96 + (int)(hasBits ? bits : 32) : (int)(hasBits ? bits : 128);
+
+			filter.hasIp = true;
+			filter.ipLow = MaskLow(key, prefixBits);
+			filter.ipHigh = MaskHigh(key, prefixBits);
+		}
+		else if (StartsWith(term, "limit:"))
+		{
+			uint64_t n;
+			if (!ParseUnsigned(term.substr(6), n) || n == 0)
+				return fail(term, "bad limit");
+			filter.limit = (size_t)std::min<uint64_t>(n, 100000);
+		}
+		else if (StartsWith(term, "first") || StartsWith(term, "last"))
+		{
+			bool first = term[0] == 'f';
+			std::string_view rest = term.substr(first ? 5 : 4);
+			std::string_view op = StartsWith(rest, ">=") || StartsWith(rest, "<=") ? rest.substr(0, 2) : rest.substr(0, 1);
+			uint64_t t;
+			if ((op != ">=" && op != "<=" && op != ">" && op != "<") || !ParseTime(rest.substr(op.size()), nowMs, t))
+				return fail(term, "bad time comparison");
+
+			uint64_t& lo = first ? filter.firstMin : filter.lastMin;
+			uint64_t& hi = first ? filter.firstMax : filter.lastMax;
+			if (op == ">=")
+				lo = std::max(lo, t);
+			else if (op == ">")
+				lo = std::max(lo, t == UINT64_MAX ? t : t + 1);
+			else if (op == "<=")
+				hi = std::min(hi, t);
+			else
+				hi = std::min(hi, t == 0 ? t : t - 1);
+		}
+		else
+		{
+			return fail(term, "unknown term");
+		}
+	}
+
+	out = std::move(filter);
+	return true;
+}
+
+void EndpointIndex::Clear()
+{
+	byName.clear();
+	byIp.clear();
+	byFirstSeen.clear();
+	byLastSeen.clear();
+	latestByLabel.clear();
+	latestByGameUrl.clear();
+	nameOf.clear();
+	ipOf.clear();
+	hasIpOf.clear();
+	firstSeenOf.clear();
+	lastSeenOf.clear();
+}
+
+uint32_t EndpointIndex::Insert(const EndpointRecord& record)
+{
+	const uint32_t id = (uint32_t)firstSeenOf.size();
+
+	auto nameIt = byName.try_emplace(Fold(record.serverName)).first;
+	nameIt->second.push_back(id);
+	nameOf.push_back(&nameIt->first);
+
+	IpKey ip;
+	bool hasIp = ParseGameUrlAddress(record.gameUrl, ip);
+	if (hasIp)
+		byIp[ip].push_back(id);
+	ipOf.push_back(hasIp ? ip : IpKey());
+	hasIpOf.push_back(hasIp ? 1 : 0);
+
+	firstSeenOf.push_back(record.firstSeenMs);
+	lastSeenOf.push_back(record.lastSeenMs);
+	byFirstSeen.emplace(record.firstSeenMs, id);
+	byLastSeen.emplace(record.lastSeenMs, id);
+
+	latestByLabel[record.label] = id;
+	latestByGameUrl[record.gameUrl] = id;
+	return id;
+}
+
+bool EndpointIndex::FindLabel(const std::string& label, uint32_t& id) const
+{
+	auto it = latestByLabel.find(label);
+	if (it == latestByLabel.end())
+		return false;
+	id = it->second;
+	return true;
+}
+
+bool EndpointIndex::FindGameUrl(const std::string& gameUrl, uint32_t& id) const
+{
+	auto it = latestByGameUrl.find(gameUrl);
+	if (it == latestByGameUrl.end())
+		return false;
+	id = it->second;
+	return true;
+}
+
+void EndpointIndex::Touch(uint32_t id, uint64_t lastSeenMs)
+{
+	if (id >= lastSeenOf.size() || lastSeenOf[id] == lastSeenMs)
+		return;
+	byLastSeen.erase({ lastSeenOf[id], id });
+	lastSeenOf[id] = lastSeenMs;
+	byLastSeen.emplace(lastSeenMs, id);
+}
+
+bool EndpointIndex::Walk(Term term, const EndpointFilter& filter, const std::function<bool(uint32_t)>& fn) const
+{
+	switch (term)
+	{
+	case Term::Name:
+		for (auto it = byName.lower_bound(filter.namePrefix); it != byName.end() && StartsWith(it->first, filter.namePrefix); ++it)
+			for (uint32_t id : it->second)
+				if (!fn(id))
+					return false;
+		return true;
+
+	case Term::Ip:
+		for (auto it = byIp.lower_bound(filter.ipLow); it != byIp.end() && it->first <= filter.ipHigh; ++it)
+			for (uint32_t id : it->second)
+				if (!fn(id))
+					return false;
+		return true;
+
+	case Term::FirstSeen:
+	case Term::LastSeen:
+	{
+		// Newest first.
+		const TimeIndex& index = term == Term::FirstSeen ? byFirstSeen : byLastSeen;
+		uint64_t lo = term == Term::FirstSeen ? filter.firstMin : filter.lastMin;
+		uint64_t hi = term == Term::FirstSeen ? filter.firstMax : filter.lastMax;
+		auto begin = index.lower_bound({ lo, 0 });
+		auto it = index.upper_bound({ hi, UINT32_MAX });
+		while (it != begin)
+		{
+			--it;
+			if (!fn(it->second))
+				return false;
+		}
+		return true;
+	}
+	}
+	return true;
+}
+
+bool EndpointIndex::Matches(uint32_t id, const EndpointFilter& filter, Term driver) const
+{
+	if (filter.hasName && driver != Term::Name && !StartsWith(*nameOf[id], filter.namePrefix))
+		return false;
+	if (filter.hasIp && driver != Term::Ip && (!hasIpOf[id] || ipOf[id] < filter.ipLow || filter.ipHigh < ipOf[id]))
+		return false;
+	if (driver != Term::FirstSeen && (firstSeenOf[id] < filter.firstMin || firstSeenOf[id] > filter.firstMax))
+		return false;
+	if (driver != Term::LastSeen && (lastSeenOf[id] < filter.lastMin || lastSeenOf[id] > filter.lastMax))
+		return false;
+	return true;
+}
+
+EndpointIndex::Result EndpointIndex::Query(const EndpointFilter& filter) const
+{
+	Result result;
+
+	std::vector<Term> terms;
+	if (filter.hasName)
+		terms.push_back(Term::Name);
+	if (filter.hasIp)
+		terms.push_back(Term::Ip);
+	if (filter.HasLast())
+		terms.push_back(Term::LastSeen);
+	if (filter.HasFirst())
+		terms.push_back(Term::FirstSeen);
+
+	// Without any term, list everything most recently seen first.
+	Term driver = Term::LastSeen;
+	uint64_t best = UINT64_MAX;
+	for (Term term : terms)
+	{
+		uint64_t count = 0;
+		Walk(term, filter, [&](uint32_t) { return ++count < kProbeLimit; });
+		if (count < best)
+		{
+			best = count;
+			driver = term;
+		}
+	}
+
+	static const char* const kDriverNames[] = { "name", "ip", "first-seen", "last-seen" };
+	result.driver = kDriverNames[(int)driver];
+
+	Walk(driver, filter, [&](uint32_t id)
+		{
+			result.candidates++;
+			if (!Matches(id, filter, driver))
+				return true;
+			if (result.ids.size() == filter.limit)
+			{
+				result.truncated = true;
+				return false;
+			}
+			result.ids.push_back(id);
+			return true;
+		});
+	return result;
+}
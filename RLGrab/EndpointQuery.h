@@ -0,0 +1,153 @@
+#pragma once
+
+// Secondary indexes over the endpoint store and a small filter language.
+//
+// Records are identified by their insertion sequence number (id 0 is the
+// first endpoint ever stored), which stays stable while the list grows at
+// the front. The index keeps, per id, only what the filters need:
+//   - folded server name       -> ids   (prefix search)
+//   - IP address (v4 as ::ffff:a.b.c.d) -> ids   (CIDR range search)
+//   - first seen / last seen   -> ids   (time range search)
+//
+// The index never looks at the store again after Insert, so queries need no
+// access to the records. A query picks the most selective of its terms by
+// probing each index range with a bounded walk, drives the result from that
+// index and checks the other terms per candidate, stopping at the row limit.
+// Only a conjunction of broad terms that is itself rare can still walk a
+// long range.
+//
+// Filter syntax, whitespace-separated terms, all of which must match:
+//   name:<prefix>            server name prefix, case-insensitive ('*' optional)
+//   ip:<addr>[/<bits>]       single address or CIDR block, IPv4 or IPv6
+//   first>=<time>  first<=<time>  last>=<time>  last<=<time>  (also > and <)
+//   limit:<n>                rows to return (default 50)
+// <time> is a relative age (30s, 15m, 2h, 7d: that long ago), a UTC date
+// YYYY-MM-DD[THH:MM[:SS]], or unix milliseconds.
+//
+// Portable, no SDK dependencies.
+
+#include "EndpointRecord.h"
+
+#include <compare>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <set>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// 128-bit address key; IPv4 is stored IPv4-mapped so both share one order.
+struct IpKey
+{
+	uint64_t hi = 0;
+	uint64_t lo = 0;
+
+	auto operator<=>(const IpKey&) const = default;
+};
+
+// Parses "1.2.3.4" or "2001:db8::1" (a "%zone" suffix is ignored). `isV4`
+// tells whether the text was IPv4, i.e. CIDR bits count from bit 96.
+bool ParseIpAddress(std::string_view text, IpKey& out, bool* isV4 = nullptr);
+
+// The one GameURL splitter, shared by the table, the history and the index:
+// "1.2.3.4:7777" -> "1.2.3.4", "7777"; "[::1]:7777" -> "::1", "7777".
+// A bare address (IPv6 included) has an empty port. `port` always ends
+// `gameUrl`, right after a ':'.
+void SplitGameUrl(std::string_view gameUrl, std::string_view& host, std::string_view& port);
+
+// Address part of a GameURL: "1.2.3.4:7777", "[2001:db8::1]:7777" or a bare address.
+bool ParseGameUrlAddress(std::string_view gameUrl, IpKey& out);
+
+struct EndpointFilter
+{
+	bool hasName = false;
+	std::string namePrefix;          // folded to lower case
+
+	bool hasIp = false;
+	IpKey ipLow;                     // inclusive CIDR range
+	IpKey ipHigh;
+
+	uint64_t firstMin = 0;
+	uint64_t firstMax = UINT64_MAX;
+	uint64_t lastMin = 0;
+	uint64_t lastMax = UINT64_MAX;
+
+	size_t limit = 50;
+
+	bool HasFirst() const { return firstMin != 0 || firstMax != UINT64_MAX; }
+	bool HasLast() const { return lastMin != 0 || lastMax != UINT64_MAX; }
+};
+
+// "2026-10-19 14:30:05" (UTC), for query output.
+std::string FormatUnixMs(uint64_t unixMs);
+
+// One time value as accepted by the first/last terms: "30m", "2h", "7d"
+// ago, "YYYY-MM-DD[THH:MM[:SS]]" UTC, or unix ms.
+bool ParseQueryTime(std::string_view s, uint64_t nowMs, uint64_t& out);
+
+// Parses a filter expression (see the header comment). Relative times are
+// resolved against `nowMs`.
+bool ParseEndpointFilter(std::string_view expression, uint64_t nowMs, EndpointFilter& out, std::string* error = nullptr);
+
+class EndpointIndex
+{
+public:
+	struct Result
+	{
+		std::vector<uint32_t> ids;   // at most filter.limit, in the driving index's order
+		bool truncated = false;      // more matches exist beyond the limit
+		const char* driver = "";     // index the query was driven from
+		uint64_t candidates = 0;     // ids examined
+	};
+
+	void Clear();
+	size_t Size() const { return firstSeenOf.size(); }
+
+	// Indexes the next record; ids must arrive as 0, 1, 2, ...
+	uint32_t Insert(const EndpointRecord& record);
+
+	// Most recent id stored under `label`, for last-seen updates.
+	bool FindLabel(const std::string& label, uint32_t& id) const;
+
+	// Most recent id stored under `gameUrl`, whatever its label; captures
+	// see only the address and fold into the record that has the name.
+	bool FindGameUrl(const std::string& gameUrl, uint32_t& id) const;
+
+	// Moves `id` in the last-seen index after its record was seen again.
+	void Touch(uint32_t id, uint64_t lastSeenMs);
+
+	Result Query(const EndpointFilter& filter) const;
+
+private:
+	enum class Term
+	{
+		Name,
+		Ip,
+		FirstSeen,
+		LastSeen,
+	};
+
+	using TimeIndex = std::set<std::pair<uint64_t, uint32_t>>;
+
+	// Calls fn(id) for every id in the term's range until fn returns false.
+	// Returns false if stopped early.
+	bool Walk(Term term, const EndpointFilter& filter, const std::function<bool(uint32_t)>& fn) const;
+	bool Matches(uint32_t id, const EndpointFilter& filter, Term driver) const;
+
+	std::map<std::string, std::vector<uint32_t>, std::less<>> byName;
+	std::map<IpKey, std::vector<uint32_t>> byIp;
+	TimeIndex byFirstSeen;
+	TimeIndex byLastSeen;
+	std::unordered_map<std::string, uint32_t> latestByLabel;
+	std::unordered_map<std::string, uint32_t> latestByGameUrl;
+
+	// Per id, so candidates are checked without touching the records.
+	std::vector<const std::string*> nameOf; // key in byName
+	std::vector<IpKey> ipOf;
+	std::vector<uint8_t> hasIpOf;
+	std::vector<uint64_t> firstSeenOf;
+	std::vector<uint64_t> lastSeenOf;
+};
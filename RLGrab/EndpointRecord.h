@@ -0,0 +1,40 @@
+#pragma once
+
+// One stored endpoint as shown in the list.
+//
+// Portable, no SDK dependencies.
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+struct EndpointRecord
+{
+	std::string label;       // "ServerName (ip:port)" or "ip:port"; dedup key
+	std::string serverName;  // may be empty
+	std::string gameUrl;     // "ip:port"
+	std::string source;      // log source name, or "pcap"
+	std::string display;     // label, suffixed with the source when several are watched
+
+	// Extra fields from user extraction rules (region, playlist, ...).
+	std::vector<std::pair<std::string, std::string>> fields;
+
+	// Wall-clock sightings, unix milliseconds: the Launch.log line's time, else
+	// the log file's modification time, else the time the record was stored.
+	// Pcap flows carry their capture times.
+	uint64_t firstSeenMs = 0;
+	uint64_t lastSeenMs = 0;
+
+	// Sightings folded into this record while duplicates are dropped.
+	uint32_t seenCount = 1;
+
+	const std::string* Field(std::string_view name) const
+	{
+		for (const auto& f : fields)
+			if (f.first == name)
+				return &f.second;
+		return nullptr;
+	}
+};
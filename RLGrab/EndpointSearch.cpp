@@ -0,0 +1,212 @@
+#include "EndpointSearch.h"
+
+#include <algorithm>
+
+namespace
+{
+	// ASCII only: server names and addresses are ASCII, and folding must
+	// never change the length of UTF-8 text.
+	char FoldChar(char c)
+	{
+		if (c >= 'A' && c <= 'Z')
+			return (char)(c - 'A' + 'a');
+		return c == '\t' ? ' ' : c;
+	}
+
+	void SplitWords(std::string_view text, std::vector<std::string>& out)
+	{
+		out.clear();
+		size_t pos = 0;
+		while (pos < text.size())
+		{
+			size_t start = text.find_first_not_of(' ', pos);
+			if (start == std::string_view::npos)
+				break;
+			size_t end = text.find(' ', start);
+			if (end == std::string_view::npos)
+				end = text.size();
+			out.emplace_back(text.substr(start, end - start));
+			pos = end;
+		}
+	}
+}
+
+// ----------------- EndpointSearchIndex -----------------
+
+void EndpointSearchIndex::Fold(std::string_view text, std::string& out)
+{
+	out.resize(text.size());
+	for (size_t i = 0; i < text.size(); ++i)
+		out[i] = FoldChar(text[i]);
+}
+
+uint32_t EndpointSearchIndex::TrigramKey(const char* p)
+{
+	return ((uint32_t)(uint8_t)p[0] << 16) | ((uint32_t)(uint8_t)p[1] << 8) | (uint32_t)(uint8_t)p[2];
+}
+
+void EndpointSearchIndex::Clear()
+{
+	arena.clear();
+	offsets.assign(1, 0);
+	postings.clear();
+	generation++;
+}
+
+void EndpointSearchIndex::Insert(uint32_t id, std::string_view text)
+{
+	(void)id; // implied by the insertion order
+
+	size_t start = arena.size();
+	arena.resize(start + text.size());
+	for (size_t i = 0; i < text.size(); ++i)
+		arena[start + i] = FoldChar(text[i]);
+	offsets.push_back((uint32_t)arena.size());
+
+	uint32_t row = (uint32_t)(offsets.size() - 2);
+	for (size_t i = start; i + 3 <= arena.size(); ++i)
+	{
+		std::vector<uint32_t>& list = postings[TrigramKey(arena.data() + i)];
+		if (list.empty() || list.back() != row)
+			list.push_back(row);
+	}
+}
+
+const std::vector<uint32_t>* EndpointSearchIndex::Postings(std::string_view trigram) const
+{
+	if (trigram.size() != 3)
+		return nullptr;
+	auto it = postings.find(TrigramKey(trigram.data()));
+	return it == postings.end() ? nullptr : &it->second;
+}
+
+// ----------------- EndpointSearch -----------------
+
+bool EndpointSearch::Covers(const std::vector<std::string>& broader, const std::vector<std::string>& narrower)
+{
+	for (const auto& b : broader)
+	{
+		bool covered = false;
+		for (const auto& n : narrower)
+			if (n.find(b) != std::string::npos)
+			{
+				covered = true;
+				break;
+			}
+		if (!covered)
+			return false;
+	}
+	return true;
+}
+
+bool EndpointSearch::MatchesAll(std::string_view haystack, const std::vector<std::string>& words)
+{
+	for (const auto& w : words)
+		if (haystack.find(w) == std::string_view::npos)
+			return false;
+	return true;
+}
+
+void EndpointSearch::CatchUp(const EndpointSearchIndex& index, Step& step)
+{
+	for (size_t id = step.indexedRows; id < index.Size(); ++id)
+	{
+		stats.candidates++;
+		if (MatchesAll(index.Haystack((uint32_t)id), step.words))
+			step.ids.push_back((uint32_t)id);
+	}
+	step.indexedRows = index.Size();
+}
+
+void EndpointSearch::Search(const EndpointSearchIndex& index, Step& step)
+{
+	// Drive from the shortest posting list of any trigram of any word.
+	const std::vector<uint32_t>* driver = nullptr;
+	bool anyTrigram = false;
+	for (const auto& w : step.words)
+	{
+		for (size_t i = 0; i + 3 <= w.size(); ++i)
+		{
+			anyTrigram = true;
+			const std::vector<uint32_t>* list = index.Postings(std::string_view(w).substr(i, 3));
+			if (!list)
+			{
+				step.indexedRows = index.Size();
+				return; // no row has this trigram
+			}
+			if (!driver || list->size() < driver->size())
+				driver = list;
+		}
+	}
+
+	if (anyTrigram)
+	{
+		for (uint32_t id : *driver)
+		{
+			stats.candidates++;
+			if (MatchesAll(index.Haystack(id), step.words))
+				step.ids.push_back(id);
+		}
+		step.indexedRows = index.Size();
+	}
+	else
+	{
+		CatchUp(index, step);
+	}
+}
+
+bool EndpointSearch::Update(const EndpointSearchIndex& index, std::string_view query)
+{
+	stats = Stats();
+	if (index.Generation() != generation)
+	{
+		steps.assign(1, Step());
+		generation = index.Generation();
+	}
+
+	std::vector<std::string> words;
+	EndpointSearchIndex::Fold(query, folded);
+	SplitWords(folded, words);
+	std::string key;
+	for (const auto& w : words)
+		key += (key.empty() ? "" : " ") + w;
+
+	if (key == steps.back().query && steps.back().indexedRows == index.Size())
+		return false;
+
+	// Back off to the newest result that still contains every match.
+	while (steps.size() > 1 && !Covers(steps.back().words, words))
+		steps.pop_back();
+
+	Step& base = steps.back();
+	if (key == base.query)
+	{
+		CatchUp(index, base);
+		return true;
+	}
+
+	Step next;
+	next.query = key;
+	next.words = std::move(words);
+	if (steps.size() == 1)
+	{
+		Search(index, next);
+	}
+	else
+	{
+		CatchUp(index, base);
+		stats.narrowed = true;
+		for (uint32_t id : base.ids)
+		{
+			stats.candidates++;
+			if (MatchesAll(index.Haystack(id), next.words))
+				next.ids.push_back(id);
+		}
+		next.indexedRows = base.indexedRows;
+	}
+
+	steps.push_back(std::move(next));
+	if (steps.size() > kMaxSteps)
+		steps.erase(steps.begin() + 1);
+	return true;
+}
@@ -0,0 +1,95 @@
+#pragma once
+
+// Type-to-filter search over the endpoint list.
+//
+// Every stored endpoint contributes one case-folded haystack (its display
+// text) to a contiguous arena, and each distinct trigram of it to a posting
+// list. Ids are the EndpointIndex ids, so the two indexes stay in step.
+//
+// A query is whitespace-separated words that must all occur. Searching from
+// scratch intersects the rarest trigram posting list of the words with the
+// haystacks; one- and two-letter queries scan the arena. EndpointSearch
+// remembers the result of each query it answered, so a keystroke that only
+// extends the query narrows the previous result instead of searching
+// again, and a backspace returns to the earlier result. Rows stored since a
+// result was computed are checked on the next update.
+//
+// Portable, no SDK dependencies.
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+class EndpointSearchIndex
+{
+public:
+	void Clear();
+	size_t Size() const { return offsets.size() - 1; }
+
+	// Indexes the next record; ids must arrive as 0, 1, 2, ...
+	void Insert(uint32_t id, std::string_view text);
+
+	// Folded text of `id`.
+	std::string_view Haystack(uint32_t id) const
+	{
+		return std::string_view(arena.data() + offsets[id], offsets[id + 1] - offsets[id]);
+	}
+
+	// Ids containing `trigram` (folded), ascending; null when none do.
+	const std::vector<uint32_t>* Postings(std::string_view trigram) const;
+
+	// Bumped by Clear, so searches know their results are void.
+	uint64_t Generation() const { return generation; }
+
+	static void Fold(std::string_view text, std::string& out);
+
+private:
+	static uint32_t TrigramKey(const char* p);
+
+	std::string arena;
+	std::vector<uint32_t> offsets{ 0 };
+	std::unordered_map<uint32_t, std::vector<uint32_t>> postings;
+	uint64_t generation = 0;
+};
+
+class EndpointSearch
+{
+public:
+	// Brings the result in line with `query` and the index. Cheap when
+	// neither changed. Returns true if the result changed.
+	bool Update(const EndpointSearchIndex& index, std::string_view query);
+
+	// Matching ids, ascending (oldest first). Empty query: every id.
+	const std::vector<uint32_t>& Results() const { return steps.back().ids; }
+	bool Active() const { return !steps.back().words.empty(); }
+
+	struct Stats
+	{
+		uint64_t candidates = 0; // haystacks checked by the last update
+		bool narrowed = false;   // last update started from an earlier result
+	};
+	const Stats& LastStats() const { return stats; }
+
+private:
+	struct Step
+	{
+		std::string query;              // folded words, single-spaced
+		std::vector<std::string> words;
+		std::vector<uint32_t> ids;
+		size_t indexedRows = 0;         // index size the ids account for
+	};
+
+	static constexpr size_t kMaxSteps = 16;
+
+	static bool Covers(const std::vector<std::string>& broader, const std::vector<std::string>& narrower);
+	static bool MatchesAll(std::string_view haystack, const std::vector<std::string>& words);
+	void CatchUp(const EndpointSearchIndex& index, Step& step);
+	void Search(const EndpointSearchIndex& index, Step& step);
+
+	std::vector<Step> steps{ Step() }; // [0] is the empty query; each step's words cover the next one's
+	uint64_t generation = UINT64_MAX;
+	std::string folded;
+	Stats stats;
+};
@@ -0,0 +1,233 @@
+#include "EndpointTable.h"
+
+#include <algorithm>
+#include <cctype>
+
+namespace
+{
+	std::string Folded(std::string_view text)
+	{
+		std::string out(text);
+		for (char& c : out)
+			c = (char)std::tolower((unsigned char)c);
+		return out;
+	}
+
+	// Columns whose keys Touch() can change.
+	constexpr EndpointColumn kTouchedColumns[] = { EndpointColumn::LastSeen, EndpointColumn::Count };
+}
+
+const char* EndpointColumnName(EndpointColumn column)
+{
+	switch (column)
+	{
+	case EndpointColumn::Name: return "Name";
+	case EndpointColumn::Address: return "IP";
+	case EndpointColumn::Port: return "Port";
+	case EndpointColumn::FirstSeen: return "First seen";
+	case EndpointColumn::LastSeen: return "Last seen";
+	case EndpointColumn::Count: return "Count";
+	case EndpointColumn::Region: return "Region";
+	}
+	return "";
+}
+
+bool EndpointColumnDescendingByDefault(EndpointColumn column)
+{
+	return column == EndpointColumn::FirstSeen || column == EndpointColumn::LastSeen || column == EndpointColumn::Count;
+}
+
+// ----------------- EndpointTable -----------------
+
+void EndpointTable::Clear()
+{
+	keys.clear();
+	for (auto& order : orders)
+		order = Order();
+	rows.clear();
+	view = nullptr;
+	filtered = false;
+	version++;
+}
+
+void EndpointTable::Insert(uint32_t id, const EndpointRecord& record)
+{
+	Keys k;
+	k.name = Folded(record.serverName);
+	k.hasAddress = ParseGameUrlAddress(record.gameUrl, k.address);
+	std::string_view host, port;
+	SplitGameUrl(record.gameUrl, host, port);
+	for (char c : port)
+	{
+		if (c < '0' || c > '9' || k.port > 65535)
+		{
+			k.port = 0;
+			break;
+		}
+		k.port = k.port * 10 + (uint32_t)(c - '0');
+	}
+	k.firstSeenMs = record.firstSeenMs;
+	k.lastSeenMs = record.lastSeenMs;
+	k.count = record.seenCount;
+	if (const std::string* region = record.Field("Region"))
+		k.region = Folded(*region);
+
+	keys.resize(id + 1);
+	keys[id] = std::move(k);
+
+	for (size_t c = 0; c < kEndpointColumnCount; ++c)
+		if (orders[c].built)
+			Place((EndpointColumn)c, id);
+	version++;
+}
+
+void EndpointTable::Touch(uint32_t id, const EndpointRecord& record)
+{
+	if (id >= keys.size())
+		return;
+
+	// Out of the affected orders under the old keys, back in under the new.
+	for (EndpointColumn c : kTouchedColumns)
+		if (orders[(size_t)c].built)
+			Unplace(c, id);
+	keys[id].lastSeenMs = record.lastSeenMs;
+	keys[id].count = record.seenCount;
+	for (EndpointColumn c : kTouchedColumns)
+		if (orders[(size_t)c].built)
+			Place(c, id);
+	version++;
+}
+
+void EndpointTable::SetSort(bool sorted, EndpointColumn column, bool descending)
+{
+	if (sorted == this->sorted && column == this->column && descending == this->descending)
+		return;
+	// Direction alone does not change the ascending row list.
+	if (sorted != this->sorted || (sorted && column != this->column))
+		version++;
+	this->sorted = sorted;
+	this->column = column;
+	this->descending = descending;
+}
+
+bool EndpointTable::Less(EndpointColumn c, uint32_t a, uint32_t b) const
+{
+	const Keys& x = keys[a];
+	const Keys& y = keys[b];
+	switch (c)
+	{
+	case EndpointColumn::Name:
+		if (int cmp = x.name.compare(y.name))
+			return cmp < 0;
+		break;
+	case EndpointColumn::Address:
+		// Unparsable addresses go last.
+		if (x.hasAddress != y.hasAddress)
+			return x.hasAddress;
+		if (x.address != y.address)
+			return x.address < y.address;
+		break;
+	case EndpointColumn::Port:
+		if (x.port != y.port)
+			return x.port < y.port;
+		break;
+	case EndpointColumn::FirstSeen:
+		if (x.firstSeenMs != y.firstSeenMs)
+			return x.firstSeenMs < y.firstSeenMs;
+		break;
+	case EndpointColumn::LastSeen:
+		if (x.lastSeenMs != y.lastSeenMs)
+			return x.lastSeenMs < y.lastSeenMs;
+		break;
+	case EndpointColumn::Count:
+		if (x.count != y.count)
+			return x.count < y.count;
+		break;
+	case EndpointColumn::Region:
+		if (int cmp = x.region.compare(y.region))
+			return cmp < 0;
+		break;
+	}
+	return a < b;
+}
+
+const std::vector<uint32_t>& EndpointTable::Build(EndpointColumn c)
+{
+	Order& order = orders[(size_t)c];
+	if (!order.built)
+	{
+		order.ids.resize(keys.size());
+		for (uint32_t id = 0; id < (uint32_t)keys.size(); ++id)
+			order.ids[id] = id;
+		std::sort(order.ids.begin(), order.ids.end(), [&](uint32_t a, uint32_t b) { return Less(c, a, b); });
+		order.built = true;
+		stats.sorts++;
+	}
+	return order.ids;
+}
+
+void EndpointTable::Place(EndpointColumn c, uint32_t id)
+{
+	auto& ids = orders[(size_t)c].ids;
+	auto at = std::upper_bound(ids.begin(), ids.end(), id, [&](uint32_t a, uint32_t b) { return Less(c, a, b); });
+	ids.insert(at, id);
+	stats.placements++;
+}
+
+void EndpointTable::Unplace(EndpointColumn c, uint32_t id)
+{
+	auto& ids = orders[(size_t)c].ids;
+	auto at = std::lower_bound(ids.begin(), ids.end(), id, [&](uint32_t a, uint32_t b) { return Less(c, a, b); });
+	if (at != ids.end() && *at == id)
+		ids.erase(at);
+}
+
+void EndpointTable::Update(const std::vector<uint32_t>* filter, bool filterChanged)
+{
+	const std::vector<uint32_t>* order = sorted ? &Build(column) : nullptr;
+	if (!filter)
+	{
+		filtered = false;
+		view = order;
+		return;
+	}
+	if (filtered && !filterChanged && rowsVersion == version)
+	{
+		view = &rows;
+		return;
+	}
+
+	filtered = true;
+	rowsVersion = version;
+	stats.rebuilds++;
+	if (!order)
+	{
+		rows = *filter;
+	}
+	else
+	{
+		// One pass over the order keeps it; the filter only marks ids.
+		inFilter.assign(keys.size(), 0);
+		for (uint32_t id : *filter)
+			if (id < inFilter.size())
+				inFilter[id] = 1;
+		rows.clear();
+		rows.reserve(filter->size());
+		for (uint32_t id : *order)
+			if (inFilter[id])
+				rows.push_back(id);
+	}
+	view = &rows;
+}
+
+size_t EndpointTable::RowCount() const
+{
+	return view ? view->size() : keys.size();
+}
+
+uint32_t EndpointTable::IdAt(size_t row) const
+{
+	size_t n = RowCount();
+	size_t at = descending ? n - 1 - row : row;
+	return view ? (*view)[at] : (uint32_t)at;
+}
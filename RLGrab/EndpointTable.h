@@ -0,0 +1,119 @@
+#pragma once
+
+// Row order for the endpoint table in the settings panel.
+//
+// Each sortable column keeps a permutation of the endpoint ids (the
+// EndpointIndex ids) in that column's order, ties broken by id. A column's
+// permutation is built with one sort the first time the column is sorted
+// on; after that a new record is placed by binary search and a record seen
+// again is moved within the orders whose keys changed, so the list is never
+// sorted again as it grows. Columns nobody sorted on cost nothing but their
+// keys.
+//
+// The visible rows are the sort order restricted to the search result; the
+// restriction is recomputed only when the result, the sort or the store
+// changed, not per frame.
+//
+// Portable, no SDK dependencies.
+
+#include "EndpointQuery.h"
+#include "EndpointRecord.h"
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+enum class EndpointColumn
+{
+	Name,
+	Address,
+	Port,
+	FirstSeen,
+	LastSeen,
+	Count,
+	Region,
+};
+
+constexpr size_t kEndpointColumnCount = 7;
+
+const char* EndpointColumnName(EndpointColumn column);
+
+// Sorting on a column starts with this direction (newest, busiest first).
+bool EndpointColumnDescendingByDefault(EndpointColumn column);
+
+class EndpointTable
+{
+public:
+	void Clear();
+	size_t Size() const { return keys.size(); }
+
+	// Sort keys of the next record; ids must arrive as 0, 1, 2, ...
+	void Insert(uint32_t id, const EndpointRecord& record);
+
+	// `id` was seen again; its last-seen time and count are taken from `record`.
+	void Touch(uint32_t id, const EndpointRecord& record);
+
+	// No sort (sorted == false) lists ids in insertion order.
+	void SetSort(bool sorted, EndpointColumn column, bool descending);
+	bool Sorted() const { return sorted; }
+	EndpointColumn SortColumn() const { return column; }
+	bool Descending() const { return descending; }
+
+	// Restricts the rows to `filter` (ascending ids), or shows every id when
+	// null. `filterChanged` says the filter's contents differ from the last
+	// call. Cheap when nothing changed.
+	void Update(const std::vector<uint32_t>* filter, bool filterChanged);
+
+	size_t RowCount() const;
+	uint32_t IdAt(size_t row) const;
+
+	struct Stats
+	{
+		uint64_t sorts = 0;      // permutations built from scratch
+		uint64_t placements = 0; // ids placed or moved by binary search
+		uint64_t rebuilds = 0;   // filtered row lists recomputed
+	};
+	const Stats& GetStats() const { return stats; }
+
+private:
+	struct Keys
+	{
+		std::string name;     // folded
+		IpKey address;
+		bool hasAddress = false;
+		uint32_t port = 0;
+		uint64_t firstSeenMs = 0;
+		uint64_t lastSeenMs = 0;
+		uint32_t count = 1;
+		std::string region;   // folded
+	};
+
+	struct Order
+	{
+		bool built = false;
+		std::vector<uint32_t> ids;
+	};
+
+	bool Less(EndpointColumn c, uint32_t a, uint32_t b) const;
+	const std::vector<uint32_t>& Build(EndpointColumn c);
+	void Place(EndpointColumn c, uint32_t id);
+	void Unplace(EndpointColumn c, uint32_t id);
+
+	std::vector<Keys> keys;
+	Order orders[kEndpointColumnCount];
+
+	bool sorted = false;
+	EndpointColumn column = EndpointColumn::LastSeen;
+	bool descending = true;
+
+	// Visible rows, ascending in the active order; `view` is either `rows`
+	// or the active order itself when there is no filter.
+	const std::vector<uint32_t>* view = nullptr;
+	std::vector<uint32_t> rows;
+	std::vector<uint8_t> inFilter;
+	bool filtered = false;
+	uint64_t version = 0;       // bumped by every change to an order
+	uint64_t rowsVersion = UINT64_MAX;
+	Stats stats;
+};
@@ -0,0 +1,112 @@
+#include "pch.h"
+#include "EndpointTree.h"
+
+namespace
+{
+	constexpr int kHidden = ImGui::FlatTreeView::STATE_HIDDEN;
+	constexpr int kSelected = ImGui::FlatTreeView::STATE_SELECTED;
+}
+
+EndpointTree::EndpointTree()
+	: tree(false, false)
+{
+}
+
+void EndpointTree::Clear()
+{
+	tree.clear();
+	regions.clear();
+	servers.clear();
+	leaves.clear();
+	filtered = false;
+	selected = -1;
+}
+
+void EndpointTree::Insert(uint32_t id, const EndpointRecord& record)
+{
+	const std::string* region = record.Field("Region");
+	const std::string& regionName = region && !region->empty() ? *region : std::string("Unknown region");
+
+	// While a search is active, new rows stay hidden until the search's
+	// result takes them in; so do groups created for them.
+	auto regionIt = regions.find(regionName);
+	if (regionIt == regions.end())
+	{
+		regionIt = regions.emplace(regionName, tree.addNode(regionName.c_str())).first;
+		if (filtered)
+			tree.addState(regionIt->second, kHidden);
+	}
+
+	std::string key = std::to_string(regionIt->second) + '\n' + record.serverName;
+	auto serverIt = servers.find(key);
+	if (serverIt == servers.end())
+	{
+		const char* name = record.serverName.empty() ? "-" : record.serverName.c_str();
+		serverIt = servers.emplace(std::move(key), tree.addNode(name, regionIt->second)).first;
+		if (filtered)
+			tree.addState(serverIt->second, kHidden);
+	}
+
+	int leaf = tree.addNode(record.gameUrl.c_str(), serverIt->second, (int)id);
+	if (filtered)
+		tree.addState(leaf, kHidden);
+	leaves.resize(id + 1, -1);
+	leaves[id] = leaf;
+}
+
+void EndpointTree::SetFilter(const std::vector<uint32_t>* filter)
+{
+	if (!filter)
+	{
+		if (filtered)
+			tree.removeStateFromAllNodes(kHidden);
+		filtered = false;
+		return;
+	}
+
+	// Hide everything, then reveal each match and its groups; the walk up
+	// stops at the first group an earlier match revealed.
+	tree.addStateToAllNodes(kHidden);
+	for (uint32_t id : *filter)
+	{
+		if (id >= leaves.size())
+			continue;
+		for (int n = leaves[id]; n >= 0 && tree.isStatePresent(n, kHidden); n = tree.getParentNode(n))
+			tree.removeState(n, kHidden);
+	}
+	filtered = true;
+}
+
+void EndpointTree::Select(int id)
+{
+	tree.removeStateFromAllNodes(kSelected);
+	if (id >= 0 && id < (int)leaves.size())
+		tree.addState(leaves[id], kSelected);
+	selected = id;
+}
+
+bool EndpointTree::Render(int& selectedId)
+{
+	if (selectedId != selected)
+		Select(selectedId);
+
+	if (!tree.render())
+		return false;
+
+	const ImGui::FlatTreeViewEvent& event = tree.getLastEvent();
+	if (event.type != ImGui::FlatTreeView::EVENT_STATE_CHANGED || event.state != ImGui::FlatTreeView::STATE_SELECTED)
+		return false;
+
+	// Only endpoints are selectable; a click on a group toggles it and
+	// leaves the selection where it was.
+	if (!tree.isLeafNode(event.node))
+	{
+		tree.toggleState(event.node, ImGui::FlatTreeView::STATE_OPEN);
+		Select(selected);
+		return false;
+	}
+
+	Select(tree.getUserId(event.node));
+	selectedId = selected;
+	return true;
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+// Endpoints grouped by region, then server name, then address, for the
+// grouped view of the settings panel's endpoint list.
+//
+// The tree is an ImGui::FlatTreeView: nodes are indices into flat arrays
+// and every node state is a bitset, so 100k+ leaves cost a handful of
+// arrays and a frame draws only the rows in view. Groups are found by name
+// through two hash maps, so adding an endpoint does not search the tree.
+// Endpoints arrive in id order and are never removed; Clear() starts over
+// when the store is replaced.
+//
+// A search hides the endpoints outside its result, and the groups left
+// empty, by rewriting the hidden bitset; the tree itself is kept.
+
+#include "EndpointRecord.h"
+#include "imgui/imguivariouscontrols.h"
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+class EndpointTree
+{
+public:
+	EndpointTree();
+
+	void Clear();
+	size_t Size() const { return leaves.size(); }
+
+	// Adds the next record; ids must arrive as 0, 1, 2, ...
+	void Insert(uint32_t id, const EndpointRecord& record);
+
+	// Shows only the ids in `filter` (ascending), or every id when null.
+	void SetFilter(const std::vector<uint32_t>* filter);
+
+	// Draws the rows in view, highlighting the leaf of `selectedId` (-1:
+	// none). A click on a group opens or closes it; a click on an endpoint
+	// sets `selectedId` and returns true.
+	bool Render(int& selectedId);
+
+private:
+	void Select(int id);
+
+	ImGui::FlatTreeView tree;
+	std::unordered_map<std::string, int> regions; // region -> node
+	std::unordered_map<std::string, int> servers; // region node + '\n' + server name -> node
+	std::vector<int> leaves;                      // id -> node
+	bool filtered = false;
+	int selected = -1;
+};
@@ -0,0 +1,248 @@
+#include "ExtractionRules.h"
+
+#include <cstring>
+#include <queue>
+#include <sstream>
+
+namespace
+{
+	std::string TrimCopy(const std::string& s)
+	{
+		size_t start = s.find_first_not_of(" \t\r\n");
+		if (start == std::string::npos)
+			return "";
+		size_t end = s.find_last_not_of(" \t\r\n");
+		return s.substr(start, end - start + 1);
+	}
+}
+
+std::vector<ExtractionRule> ExtractionEngine::DefaultRules()
+{
+	return {
+		{ "ServerName", "ServerName=\"", '"' },
+		{ "GameURL", "GameURL=\"", '"' },
+	};
+}
+
+bool ExtractionEngine::ParseRules(const std::string& text, std::vector<ExtractionRule>& outRules, std::string* error)
+{
+	std::istringstream in(text);
+	std::string line;
+	int lineNo = 0;
+	while (std::getline(in, line))
+	{
+		++lineNo;
+		std::string trimmed = TrimCopy(line);
+		if (trimmed.empty() || trimmed[0] == '#')
+			continue;
+
+		// The prefix may itself contain '|', so split on the first and last one.
+		auto first = trimmed.find('|');
+		auto last = trimmed.rfind('|');
+		if (first == std::string::npos || first == last)
+		{
+			if (error)
+				*error = "line " + std::to_string(lineNo) + ": expected field|prefix|terminator";
+			return false;
+		}
+
+		ExtractionRule rule;
+		rule.field = TrimCopy(trimmed.substr(0, first));
+		rule.prefix = trimmed.substr(first + 1, last - first - 1);
+		std::string term = TrimCopy(trimmed.substr(last + 1));
+
+		if (term == "EOL" || term.empty())
+			rule.terminator = kEndOfLine;
+		else if (term.size() == 1)
+			rule.terminator = (unsigned char)term[0];
+		else
+		{
+			if (error)
+				*error = "line " + std::to_string(lineNo) + ": terminator must be one character or EOL";
+			return false;
+		}
+
+		if (rule.field.empty() || rule.prefix.empty())
+		{
+			if (error)
+				*error = "line " + std::to_string(lineNo) + ": empty field or prefix";
+			return false;
+		}
+		outRules.push_back(std::move(rule));
+	}
+	return true;
+}
+
+int ExtractionEngine::FindField(std::string_view name) const
+{
+	for (size_t i = 0; i < fields.size(); ++i)
+		if (fields[i] == name)
+			return (int)i;
+	return -1;
+}
+
+bool ExtractionEngine::Compile(const std::vector<ExtractionRule>& input, std::string* error)
+{
+	fields.clear();
+	rules.clear();
+	delta.clear();
+	outputBegin.clear();
+	outputRules.clear();
+	std::memset(byteClass, 0, sizeof(byteClass));
+	classCount = 1;
+
+	// Byte classes: every byte used by some prefix gets its own class, all
+	// other bytes share class 0. Keeps the dense table small.
+	for (const auto& r : input)
+	{
+		if (r.prefix.empty())
+		{
+			if (error)
+				*error = "rule for " + r.field + " has an empty prefix";
+			return false;
+		}
+		for (unsigned char c : r.prefix)
+			if (byteClass[c] == 0)
+				byteClass[c] = (uint8_t)classCount++;
+	}
+	if (classCount > 256)
+	{
+		if (error)
+			*error = "too many distinct prefix bytes";
+		return false;
+	}
+
+	// Trie over byte classes; 0 doubles as "no edge" since the root never is a child.
+	std::vector<std::vector<uint32_t>> ownOutputs(1);
+	delta.assign(classCount, 0);
+	for (const auto& r : input)
+	{
+		uint32_t fieldIndex = (uint32_t)FindField(r.field);
+		if (fieldIndex == (uint32_t)-1)
+		{
+			fieldIndex = (uint32_t)fields.size();
+			fields.push_back(r.field);
+		}
+
+		uint32_t state = 0;
+		for (unsigned char c : r.prefix)
+		{
+			uint32_t& next = delta[state * classCount + byteClass[c]];
+			if (next == 0)
+			{
+				next = (uint32_t)ownOutputs.size();
+				ownOutputs.emplace_back();
+				delta.resize(delta.size() + classCount, 0);
+			}
+			state = delta[state * classCount + byteClass[c]];
+		}
+		ownOutputs[state].push_back((uint32_t)rules.size());
+		rules.push_back({ fieldIndex, r.terminator });
+	}
+
+	// BFS: failure links, then turn the trie into a full DFA and merge
+	// outputs along the failure chain.
+	size_t stateCount = ownOutputs.size();
+	std::vector<uint32_t> fail(stateCount, 0);
+	std::vector<std::vector<uint32_t>> outputs = ownOutputs;
+	std::queue<uint32_t> queue;
+
+	for (uint32_t c = 0; c < classCount; ++c)
+	{
+		uint32_t child = delta[c];
+		if (child != 0)
+			queue.push(child);
+	}
+
+	while (!queue.empty())
+	{
+		uint32_t state = queue.front();
+		queue.pop();
+
+		const auto& inherited = outputs[fail[state]];
+		outputs[state].insert(outputs[state].end(), inherited.begin(), inherited.end());
+
+		for (uint32_t c = 0; c < classCount; ++c)
+		{
+			uint32_t& next = delta[state * classCount + c];
+			uint32_t viaFail = delta[fail[state] * classCount + c];
+			if (next != 0)
+			{
+				fail[next] = viaFail;
+				queue.push(next);
+			}
+			else
+			{
+				next = viaFail;
+			}
+		}
+	}
+
+	outputBegin.reserve(stateCount + 1);
+	for (size_t s = 0; s < stateCount; ++s)
+	{
+		outputBegin.push_back((uint32_t)outputRules.size());
+		outputRules.insert(outputRules.end(), outputs[s].begin(), outputs[s].end());
+	}
+	outputBegin.push_back((uint32_t)outputRules.size());
+	return true;
+}
+
+void ExtractionEngine::ExtractLine(std::string_view line, ExtractedFields& out) const
+{
+	std::vector<std::string_view>& outValues = out.values;
+	if (outValues.size() != fields.size())
+		outValues.assign(fields.size(), std::string_view());
+	else
+		for (uint32_t f : out.found)
+			outValues[f] = std::string_view();
+	out.found.clear();
+	if (rules.empty())
+		return;
+
+	const unsigned char* p = reinterpret_cast<const unsigned char*>(line.data());
+	const size_t n = line.size();
+	const uint32_t* table = delta.data();
+	const uint32_t* outBegin = outputBegin.data();
+	size_t remaining = fields.size();
+
+	uint32_t state = 0;
+	for (size_t i = 0; i < n; ++i)
+	{
+		state = table[state * classCount + byteClass[p[i]]];
+
+		uint32_t ob = outBegin[state];
+		uint32_t oe = outBegin[state + 1];
+		if (ob == oe)
+			continue;
+
+		for (uint32_t k = ob; k < oe; ++k)
+		{
+			const CompiledRule& rule = rules[outputRules[k]];
+			std::string_view& slot = outValues[rule.field];
+			if (slot.data() != nullptr)
+				continue;
+
+			size_t valueStart = i + 1;
+			size_t valueEnd;
+			if (rule.terminator == kEndOfLine)
+			{
+				valueEnd = n;
+				if (valueEnd > valueStart && p[valueEnd - 1] == '\r')
+					--valueEnd;
+			}
+			else
+			{
+				const void* hit = std::memchr(p + valueStart, rule.terminator, n - valueStart);
+				if (!hit)
+					continue; // no later occurrence of this prefix can be terminated either
+				valueEnd = (size_t)(static_cast<const unsigned char*>(hit) - p);
+			}
+
+			slot = line.substr(valueStart, valueEnd - valueStart);
+			out.found.push_back(rule.field);
+			if (--remaining == 0)
+				return;
+		}
+	}
+}
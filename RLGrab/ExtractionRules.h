@@ -0,0 +1,74 @@
+#pragma once
+
+// Declarative field extraction for Launch.log lines.
+//
+// A rule says "after <prefix>, capture up to <terminator> into <field>", e.g.
+// ServerName|ServerName="|" . All rules are compiled into one Aho-Corasick
+// automaton over byte classes, so a single pass over a line finds every
+// field no matter how many rules are configured.
+//
+// Per field, the first occurrence in the line that has a terminator wins,
+// which is what regex_search with R"(ServerName="([^"]*)")" returns.
+//
+// Portable, no SDK dependencies.
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+struct ExtractionRule
+{
+	std::string field;       // target field name, e.g. "ServerName"
+	std::string prefix;      // literal key prefix, e.g. ServerName="
+	int         terminator;  // byte that ends the value, or kEndOfLine
+};
+
+constexpr int kEndOfLine = -1;
+
+// Output of ExtractionEngine::ExtractLine, meant to be reused line after
+// line: only the slots the previous line filled are reset, so the per-line
+// cost does not grow with the number of fields.
+struct ExtractedFields
+{
+	std::vector<std::string_view> values; // FieldCount() slots; unmatched ones have a null data()
+	std::vector<uint32_t> found;          // fields filled by the last line, in match order
+};
+
+class ExtractionEngine
+{
+public:
+	// Built-in rules for the fields the plugin always needs.
+	static std::vector<ExtractionRule> DefaultRules();
+
+	// Parses "field|prefix|terminator" lines ('#' comments, blank lines
+	// ignored). The terminator is a single character or EOL.
+	static bool ParseRules(const std::string& text, std::vector<ExtractionRule>& outRules, std::string* error = nullptr);
+
+	bool Compile(const std::vector<ExtractionRule>& rules, std::string* error = nullptr);
+
+	size_t FieldCount() const { return fields.size(); }
+	size_t RuleCount() const { return rules.size(); }
+	const std::string& FieldName(size_t index) const { return fields[index]; }
+	int FindField(std::string_view name) const;
+
+	// Extracts every field from one line into `out`. Values point into
+	// `line`.
+	void ExtractLine(std::string_view line, ExtractedFields& out) const;
+
+private:
+	struct CompiledRule
+	{
+		uint32_t field;
+		int      terminator;
+	};
+
+	std::vector<std::string>  fields;
+	std::vector<CompiledRule> rules;
+
+	uint8_t               byteClass[256] = {};
+	uint32_t              classCount = 1;
+	std::vector<uint32_t> delta;       // [state * classCount + class] -> state
+	std::vector<uint32_t> outputBegin; // per state, into outputRules; size states + 1
+	std::vector<uint32_t> outputRules; // rule indices whose prefix ends in that state
+};
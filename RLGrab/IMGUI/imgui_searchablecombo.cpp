@@ -2,6 +2,8 @@
 #include "imgui_searchablecombo.h"
 #include "imgui_internal.h"
 
+#include <chrono>       // steady_clock, for the filtering budget
+
 static float CalcMaxPopupHeightFromItemCount(int items_count)
 {
     ImGuiContext& g = *GImGui;
@@ -155,9 +157,289 @@ void ImGui::EndSearchableCombo()
 }
 
 
+static bool SearchableComboVectorGetter(void* data, int idx, const char** out_text)
+{
+    const std::vector<std::string>& items = *(const std::vector<std::string>*)data;
+    *out_text = items[idx].c_str();
+    return true;
+}
+
+static bool SearchableComboArrayGetter(void* data, int idx, const char** out_text)
+{
+    const char* const* items = (const char* const*)data;
+    *out_text = items[idx];
+    return true;
+}
+
+// Submits the rows of `matches` (item indices) that are in view. Rows are evenly sized, so the clipper needs no
+// measuring pass. On the appearing frame the selected row is submitted too, wherever it is, so that
+// SetItemDefaultFocus() sees it and scrolls to it.
+static bool SearchableComboList(const int* matches, int matches_count, int* current_item, bool (*items_getter)(void*, int, const char**), void* data, const char* empty_text)
+{
+    using namespace ImGui;
+    if (matches_count == 0)
+    {
+        Selectable(empty_text, false, ImGuiSelectableFlags_Disabled);
+        return false;
+    }
+
+    int selected_row = -1;
+    if (IsWindowAppearing())
+        for (int row = 0; row < matches_count; row++)
+            if (matches[row] == *current_item)
+            {
+                selected_row = row;
+                break;
+            }
+
+    bool value_changed = false;
+    const float line_height = GetTextLineHeightWithSpacing();
+    ImGuiListClipper clipper(matches_count, line_height);
+    while (clipper.Step())
+    {
+        for (int row = clipper.DisplayStart; row < clipper.DisplayEnd; row++)
+        {
+            if (row == selected_row)
+                selected_row = -1;
+            const int i = matches[row];
+            const char* item_text;
+            if (!items_getter(data, i, &item_text))
+                item_text = "*Unknown item*";
+            PushID((void*)(intptr_t)i);
+            const bool item_selected = (i == *current_item);
+            if (Selectable(item_text, item_selected))
+            {
+                value_changed = true;
+                *current_item = i;
+            }
+            if (item_selected)
+                SetItemDefaultFocus();
+            PopID();
+        }
+        if (selected_row >= 0)
+        {
+            // The clipper puts the cursor back at the end of the list when it finishes.
+            SetCursorPosY(clipper.StartPosY + selected_row * line_height);
+            const int i = matches[selected_row];
+            const char* item_text;
+            if (!items_getter(data, i, &item_text))
+                item_text = "*Unknown item*";
+            PushID((void*)(intptr_t)i);
+            if (Selectable(item_text, true))
+                value_changed = true;
+            SetItemDefaultFocus();
+            PopID();
+            selected_row = -1;
+        }
+    }
+    return value_changed;
+}
+
+static inline bool IsWordStart(const char* text, int pos)
+{
+    return pos == 0 || !isalnum((unsigned char)text[pos - 1]);
+}
+
+// One bit per letter and digit, the remaining bytes share the rest. An item can only match if its mask covers the
+// query's, which rejects most non-matches without looking at their text.
+static inline ImU64 SearchableComboCharMask(const char* text, int len)
+{
+    ImU64 mask = 0;
+    for (int i = 0; i < len; i++)
+    {
+        const unsigned char c = (unsigned char)text[i];
+        const int bit = (c >= 'a' && c <= 'z') ? c - 'a' : (c >= '0' && c <= '9') ? 26 + c - '0' : 36 + c % 28;
+        mask |= (ImU64)1 << bit;
+    }
+    return mask;
+}
+
+// Ranks a folded item against a folded, non-empty query; -1 when the query is not even a subsequence of it, and
+// a score >= 0 otherwise. Substring matches always outrank scattered ones: they score from 1 << 23 up, scattered
+// ones below it. Within each kind, matches at the start of the item or of a word, contiguous runs and early,
+// tight matches score higher.
+static int ScoreSearchableComboItem(const char* item, int item_len, const char* query, int query_len)
+{
+    // Being a subsequence is necessary for either kind of match, and memchr() finds the letters quickly.
+    int score = 0, run = 0, first = -1, last = -1;
+    const char* p = item;
+    const char* item_end = item + item_len;
+    for (int q = 0; q < query_len; q++)
+    {
+        const char* hit = (const char*)memchr(p, query[q], (size_t)(item_end - p));
+        if (hit == NULL)
+            return -1;
+        const int i = (int)(hit - item);
+        run = (q > 0 && i == last + 1) ? run + 1 : 0;
+        if (first < 0)
+            first = i;
+        score += 16 + run * 24 + (IsWordStart(item, i) ? 48 : 0);
+        last = i;
+        p = hit + 1;
+    }
+
+    // No substring can start before the first letter of the leftmost subsequence.
+    const char* found = (last - first + 1 == query_len) ? item + first : strstr(item + first, query);
+    if (found != NULL)
+    {
+        const int pos = (int)(found - item);
+        int substring_score = (1 << 24) - pos * 16 - (item_len - query_len);
+        if (pos == 0)
+            substring_score += 1 << 22;
+        else if (IsWordStart(item, pos))
+            substring_score += 1 << 21;
+        return ImMax(substring_score, 1 << 23);
+    }
+    // Gaps and a late first letter lower the score but never below 0, e.g. "cgo" in "... dedicated server chicago".
+    return ImClamp((1 << 20) + score - (last - first + 1 - query_len) * 2 - first, 0, (1 << 23) - 1);
+}
+
+// Sorts keys[0] by their upper 32 bits (the score), using keys[1] as scratch. The keys arrive in item order and
+// the LSD radix sort is stable, so ties stay in item order without passes over the index bytes; score bytes that
+// every key shares are skipped as well.
+static void RadixSortSearchableComboKeys(ImVector<ImU64>* keys)
+{
+    const int count = keys[0].Size;
+    keys[1].resize(count);
+    static int histograms[4][256];
+    memset(histograms, 0, sizeof(histograms));
+    for (int n = 0; n < count; n++)
+    {
+        const ImU32 score = (ImU32)(keys[0][n] >> 32);
+        for (int b = 0; b < 4; b++)
+            histograms[b][(score >> (b * 8)) & 0xFF]++;
+    }
+
+    ImU64* src = keys[0].Data;
+    ImU64* dst = keys[1].Data;
+    for (int b = 0; b < 4; b++)
+    {
+        const int shift = 32 + b * 8;
+        int* histogram = histograms[b];
+        if (histogram[(src[0] >> shift) & 0xFF] == count)
+            continue;
+        int sum = 0;
+        for (int v = 0; v < 256; v++)
+        {
+            const int c = histogram[v];
+            histogram[v] = sum;
+            sum += c;
+        }
+        for (int n = 0; n < count; n++)
+            dst[histogram[(src[n] >> shift) & 0xFF]++] = src[n];
+        ImSwap(src, dst);
+    }
+    if (src != keys[0].Data)
+        memcpy(keys[0].Data, src, (size_t)count * sizeof(ImU64));
+}
+
+// Case-folds every item once into state->Folded.
+static void FoldSearchableComboItems(ImGuiSearchableComboState* state, bool (*items_getter)(void*, int, const char**), void* data, int items_count)
+{
+    state->Folded.resize(0);
+    state->FoldedOffsets.resize(0);
+    state->FoldedOffsets.reserve(items_count + 1);
+    state->FoldedMasks.resize(items_count);
+    for (int i = 0; i < items_count; i++)
+    {
+        const char* text;
+        if (!items_getter(data, i, &text) || text == NULL)
+            text = "";
+        const int start = state->Folded.Size;
+        const int len = (int)strlen(text);
+        state->FoldedOffsets.push_back(start);
+        state->Folded.resize(start + len + 1);
+        char* dst = state->Folded.Data + start;
+        for (int c = 0; c < len; c++)
+            dst[c] = (char)tolower((unsigned char)text[c]);
+        dst[len] = 0;
+        state->FoldedMasks[i] = SearchableComboCharMask(dst, len);
+    }
+    state->FoldedOffsets.push_back(state->Folded.Size);
+}
+
+// Brings state->Matches in line with state->Input, at most FilterBudgetMs at a time unless the items were just
+// refolded (the old matches may not exist any more). A query that extends the one Matches was computed for can only
+// match a subset of those items, so only they are scored again, and the character masks reject most of the others
+// without scoring.
+static void FilterSearchableComboItems(ImGuiSearchableComboState* state, bool refolded)
+{
+    char query[IM_ARRAYSIZE(state->Input)];
+    int query_len = 0;
+    for (const char* p = state->Input; *p; p++)
+        query[query_len++] = (char)tolower((unsigned char)*p);
+    query[query_len] = 0;
+
+    const int items_count = state->FoldedOffsets.Size - 1;
+    ImVector<ImU64>& ranked = state->Ranked[0];
+    if (refolded || strcmp(query, state->Filtering ? state->PendingInput : state->FilteredInput) != 0)
+    {
+        // The input changed (again): drop any pass in progress and start one for this query.
+        state->Filtering = false;
+        if (query_len == 0)
+        {
+            state->FilteredInput[0] = 0;
+            state->Matches.resize(items_count);
+            for (int i = 0; i < items_count; i++)
+                state->Matches[i] = i;
+            return;
+        }
+        if (!refolded && strcmp(query, state->FilteredInput) == 0)
+            return;
+
+        const int previous_len = (int)strlen(state->FilteredInput);
+        const bool narrowing = !refolded && previous_len > 0 && strncmp(query, state->FilteredInput, previous_len) == 0;
+        state->Candidates.resize(items_count);
+        memset(state->Candidates.Data, narrowing ? 0 : 1, (size_t)items_count);
+        if (narrowing)
+            for (int n = 0; n < state->Matches.Size; n++)
+                state->Candidates[state->Matches[n]] = 1;
+        ImStrncpy(state->PendingInput, query, IM_ARRAYSIZE(state->PendingInput));
+        state->PendingNext = 0;
+        state->Filtering = true;
+        ranked.resize(0);
+    }
+    if (!state->Filtering)
+        return;
+
+    // Candidates are visited in item order, which the stable sort below relies on for ties.
+    const bool sliced = !refolded && state->FilterBudgetMs > 0.0f;
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::microseconds((long long)(state->FilterBudgetMs * 1000.0f));
+    const ImU64 query_mask = SearchableComboCharMask(query, query_len);
+    for (int i = state->PendingNext; i < items_count; i++)
+    {
+        if (sliced && (i & 1023) == 0 && i > state->PendingNext && std::chrono::steady_clock::now() >= deadline)
+        {
+            state->PendingNext = i;
+            return;
+        }
+        if (!state->Candidates[i] || (query_mask & ~state->FoldedMasks[i]) != 0)
+            continue;
+        const int offset = state->FoldedOffsets[i];
+        const int score = ScoreSearchableComboItem(state->Folded.Data + offset, state->FoldedOffsets[i + 1] - offset - 1, query, query_len);
+        if (score >= 0)
+            ranked.push_back(((ImU64)(unsigned int)(INT_MAX - score) << 32) | (unsigned int)i);
+    }
+    // A big sort gets a frame of its own if scoring used this one up.
+    if (sliced && ranked.Size > 1024 && state->PendingNext < items_count && std::chrono::steady_clock::now() >= deadline)
+    {
+        state->PendingNext = items_count;
+        return;
+    }
+    if (ranked.Size > 1)
+        RadixSortSearchableComboKeys(state->Ranked);
+
+    state->Matches.resize(ranked.Size);
+    for (int n = 0; n < ranked.Size; n++)
+        state->Matches[n] = (int)(ranked[n] & 0xFFFFFFFF);
+    ImStrncpy(state->FilteredInput, query, IM_ARRAYSIZE(state->FilteredInput));
+    state->Filtering = false;
+}
+
+
 /* Modified version of Combo from imgui.cpp at line 9343,
  * to include a input field to be able to filter the combo values. */
-bool ImGui::SearchableCombo(const char* label, int* current_item, std::vector<std::string> items, const char* default_preview_text, const char* input_preview_value, int popup_max_height_in_items)
+bool ImGui::SearchableCombo(const char* label, int* current_item, const std::vector<std::string>& items, const char* default_preview_text, const char* input_preview_value, int popup_max_height_in_items)
 {
     ImGuiContext& g = *GImGui;
 
@@ -179,41 +461,64 @@ bool ImGui::SearchableCombo(const char* label, int* current_item, std::vector<st
         return false;
 
     // Display items
-    // FIXME-OPT: Use clipper (but we need to disable it on the appearing frame to make sure our call to SetItemDefaultFocus() is processed)
-    int matched_items = 0;
-    bool value_changed = false;
+    // Nothing is cached between frames here; use the ImGuiSearchableComboState overloads for long lists.
+    ImVector<int> matches;
+    const char* input_end = input_buffer + strlen(input_buffer);
     for (int i = 0; i < (int)items.size(); i++)
-    {
-        char buffer[input_size] = "";
-        ImStrncpy(buffer, input_buffer, input_size);
-        std::string input(buffer);
-        std::string item = items[i];
+        if (input_buffer[0] == 0 || ImStristr(items[i].c_str(), items[i].c_str() + items[i].size(), input_buffer, input_end) != NULL)
+            matches.push_back(i);
 
-        std::transform(item.begin(), item.end(), item.begin(),
-            [](unsigned char c) { return (unsigned char)std::tolower(c); });
-        std::transform(input.begin(), input.end(), input.begin(),
-            [](unsigned char c) { return (unsigned char)std::tolower(c); });
+    bool value_changed = SearchableComboList(matches.Data, matches.Size, current_item, SearchableComboVectorGetter, (void*)&items, "No maps found");
 
-        if (item.find(input, 0) == std::string::npos)
-            continue;
+    EndSearchableCombo();
 
-        matched_items++;
-        PushID((void*)(intptr_t)i);
-        const bool item_selected = (i == *current_item);
-        const char* item_text = items[i].c_str();
-        if (Selectable(item_text, item_selected))
-        {
-            value_changed = true;
-            *current_item = i;
-        }
-        if (item_selected)
-            SetItemDefaultFocus();
-        PopID();
+    return value_changed;
+}
+
+bool ImGui::SearchableCombo(const char* label, int* current_item, bool (*items_getter)(void* data, int idx, const char** out_text), void* data, int items_count, ImGuiSearchableComboState* state, const char* default_preview_text, const char* input_preview_value, int popup_max_height_in_items, int items_version)
+{
+    ImGuiContext& g = *GImGui;
+    IM_ASSERT(state != NULL);
+
+    const char* preview_text = NULL;
+    if (*current_item >= items_count)
+        *current_item = 0;
+    if (*current_item >= 0 && *current_item < items_count)
+        items_getter(data, *current_item, &preview_text);
+    if (preview_text == NULL)
+        preview_text = default_preview_text;
+
+    if (popup_max_height_in_items != -1 && !(g.NextWindowData.Flags & ImGuiNextWindowDataFlags_HasSizeConstraint))
+        SetNextWindowSizeConstraints(ImVec2(0, 0), ImVec2(FLT_MAX, CalcMaxPopupHeightFromItemCount(popup_max_height_in_items)));
+
+    if (!BeginSearchableCombo(label, preview_text, state->Input, IM_ARRAYSIZE(state->Input), input_preview_value, ImGuiComboFlags_None))
+        return false;
+
+    // The items are only folded and filtered while the popup is open, and only again when something changed.
+    const bool refold = !state->Valid || state->ItemsData != data || state->ItemsCount != items_count || state->ItemsVersion != items_version;
+    if (refold)
+    {
+        FoldSearchableComboItems(state, items_getter, data, items_count);
+        state->ItemsData = data;
+        state->ItemsCount = items_count;
+        state->ItemsVersion = items_version;
+        state->Valid = true;
     }
-    if (matched_items == 0)
-        ImGui::Selectable("No maps found", false, ImGuiSelectableFlags_Disabled);
+    FilterSearchableComboItems(state, refold);
+
+    bool value_changed = SearchableComboList(state->Matches.Data, state->Matches.Size, current_item, items_getter, data, "No matches found");
 
     EndSearchableCombo();
 
     return value_changed;
-}
\ No newline at end of file
+}
+
+bool ImGui::SearchableCombo(const char* label, int* current_item, const char* const items[], int items_count, ImGuiSearchableComboState* state, const char* default_preview_text, const char* input_preview_value, int popup_max_height_in_items, int items_version)
+{
+    return SearchableCombo(label, current_item, SearchableComboArrayGetter, (void*)items, items_count, state, default_preview_text, input_preview_value, popup_max_height_in_items, items_version);
+}
+
+bool ImGui::SearchableCombo(const char* label, int* current_item, const std::vector<std::string>& items, ImGuiSearchableComboState* state, const char* default_preview_text, const char* input_preview_value, int popup_max_height_in_items, int items_version)
+{
+    return SearchableCombo(label, current_item, SearchableComboVectorGetter, (void*)&items, (int)items.size(), state, default_preview_text, input_preview_value, popup_max_height_in_items, items_version);
+}
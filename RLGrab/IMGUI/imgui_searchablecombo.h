@@ -4,11 +4,46 @@
 #include <ctype.h>      // isprint
 #include <vector>       // vector<>
 #include <string>       // string
-#include <algorithm>    // transform
+#include <algorithm>    // sort
+
+// Filter state for the cached SearchableCombo() overloads. Keep one alive per combo (a static or a member):
+// it holds the typed input, a case-folded copy of the items and the ranked matches, so nothing is copied or
+// lowercased again until the input or the items change. The items are assumed unchanged while the
+// (data, items_count, items_version) triple is; bump items_version or call Invalidate() when their text changes.
+// A keystroke rescores the items in slices of FilterBudgetMs per frame, so a long list never stalls a frame; until
+// the pass finishes the popup keeps showing the previous matches.
+struct ImGuiSearchableComboState
+{
+    char            Input[128];             // Text typed into the combo
+    char            FilteredInput[128];     // Folded input that Matches was computed for
+    char            PendingInput[128];      // Folded input of the pass in progress, while Filtering
+    int             PendingNext;            // Next item that pass scores
+    bool            Filtering;
+    float           FilterBudgetMs;         // Filtering time per frame; <= 0 filters in one go
+    ImVector<char>  Folded;                 // Folded items, zero-terminated, back to back
+    ImVector<int>   FoldedOffsets;          // Start of item n in Folded
+    ImVector<ImU64> FoldedMasks;            // Characters item n contains (see SearchableComboCharMask), for a quick reject
+    ImVector<int>   Matches;                // Item indices, best match first
+    ImVector<char>  Candidates;             // Scratch: items the pass in progress may still match
+    ImVector<ImU64> Ranked[2];              // Scratch: (score, index) sort keys, radix sorted between the two
+    const void*     ItemsData;              // What Folded was built from
+    int             ItemsCount;
+    int             ItemsVersion;
+    bool            Valid;
+
+    ImGuiSearchableComboState()             { Input[0] = FilteredInput[0] = PendingInput[0] = 0; PendingNext = 0; Filtering = false; FilterBudgetMs = 2.0f; ItemsData = NULL; ItemsCount = 0; ItemsVersion = 0; Valid = false; }
+    void            Invalidate()            { Valid = false; }
+};
 
 namespace ImGui
 {
     IMGUI_API bool          BeginSearchableCombo(const char* label, const char* preview_value, char* input, int input_size, const char* input_preview_value, ImGuiComboFlags flags = 0);
     IMGUI_API void          EndSearchableCombo();
-    IMGUI_API bool          SearchableCombo(const char* label, int* current_item, std::vector<std::string> items, const char* default_preview_text, const char* input_preview_value, int popup_max_height_in_items = -1);
+    IMGUI_API bool          SearchableCombo(const char* label, int* current_item, const std::vector<std::string>& items, const char* default_preview_text, const char* input_preview_value, int popup_max_height_in_items = -1);
+
+    // Cached variants: matches are ranked (substring before fuzzy subsequence, prefix and word starts first) and only
+    // the visible rows are submitted, so they stay cheap with tens of thousands of items.
+    IMGUI_API bool          SearchableCombo(const char* label, int* current_item, bool (*items_getter)(void* data, int idx, const char** out_text), void* data, int items_count, ImGuiSearchableComboState* state, const char* default_preview_text, const char* input_preview_value, int popup_max_height_in_items = -1, int items_version = 0);
+    IMGUI_API bool          SearchableCombo(const char* label, int* current_item, const char* const items[], int items_count, ImGuiSearchableComboState* state, const char* default_preview_text, const char* input_preview_value, int popup_max_height_in_items = -1, int items_version = 0);
+    IMGUI_API bool          SearchableCombo(const char* label, int* current_item, const std::vector<std::string>& items, ImGuiSearchableComboState* state, const char* default_preview_text, const char* input_preview_value, int popup_max_height_in_items = -1, int items_version = 0);
 } // namespace ImGui
\ No newline at end of file
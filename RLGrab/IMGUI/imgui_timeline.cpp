@@ -20,6 +20,32 @@ namespace ImGui {
 	static const float TIMELINE_RADIUS = 6;
 
 
+	// Distance between two rows: TimelineEvent() moves its cursor down a third of a line before it adds a line
+	static float TimelineRowHeight()
+	{
+		const float line_height = GetTextLineHeightWithSpacing();
+		return line_height + line_height / 3;
+	}
+
+
+	// True while one of the 3 items of the event is being dragged
+	static bool IsTimelineEventActive(const char* str_id)
+	{
+		const ImGuiID active_id = GImGui->ActiveId;
+		if (active_id == 0)
+			return false;
+		for (int i = -1; i < 2; ++i)
+		{
+			PushID(i);
+			const bool active = GetID(str_id) == active_id;
+			PopID();
+			if (active)
+				return true;
+		}
+		return false;
+	}
+
+
 	bool TimelineEvent(const char* str_id, float values[2])
 	{
 		ImGuiWindow* win = GetCurrentWindow();
@@ -29,6 +55,13 @@ namespace ImGui {
 		bool changed = false;
 		ImVec2 cursor_pos = win->DC.CursorPos;
 
+		// A row scrolled out of view only moves the cursor
+		if (!IsRectVisible(cursor_pos, cursor_pos + ImVec2(win->Size.x, TimelineRowHeight())) && !IsTimelineEventActive(str_id))
+		{
+			SetCursorScreenPos(cursor_pos + ImVec2(0, TimelineRowHeight()));
+			return false;
+		}
+
 		// @r-lyeh {
 		Button(str_id, ImVec2(120, 0)); // @todo: enable/disable track channel here
 		SameLine();
@@ -94,6 +127,25 @@ namespace ImGui {
 	}
 
 
+	bool TimelineEvents(int count, float* (*values_getter)(void* data, int idx, const char** out_name), void* data)
+	{
+		bool changed = false;
+		ImGuiListClipper clipper(count, TimelineRowHeight());
+		while (clipper.Step())
+		{
+			for (int i = clipper.DisplayStart; i < clipper.DisplayEnd; ++i)
+			{
+				const char* name = "";
+				float* values = values_getter(data, i, &name);
+				PushID(i);
+				changed |= TimelineEvent(name, values);
+				PopID();
+			}
+		}
+		return changed;
+	}
+
+
 	void EndTimeline(float t)
 	{
 		ImGuiWindow* win = GetCurrentWindow();
@@ -3,6 +3,9 @@ namespace ImGui {
 
 	bool BeginTimeline(const char* str_id, float max_time);
 	bool TimelineEvent(const char* str_id, float times[2]);
+	// One TimelineEvent() row per event, for long lists: only the rows in view are submitted.
+	// values_getter returns the times of event idx (edited in place) and sets its name.
+	bool TimelineEvents(int count, float* (*values_getter)(void* data, int idx, const char** out_name), void* data);
 	void EndTimeline(float current_time = -1);
 
 }
@@ -114,7 +114,27 @@ void TestProgressBar()  {
 }
 
 
-int PopupMenuSimple(bool &open, const char **pEntries, int numEntries, const char *optionalTitle, int *pOptionalHoveredEntryOut, int startIndex, int endIndex, bool reverseItems, const char *scrollUpEntryText, const char *scrollDownEntryText)   {
+void PopupMenuSeparatorRow()   {
+    ImGuiWindow* window = GetCurrentWindow();
+    if (window->SkipItems) return;
+    const float y = (float)(int)(window->DC.CursorPos.y + GetTextLineHeight()*0.5f);
+    window->DrawList->AddLine(ImVec2(window->Pos.x,y),ImVec2(window->Pos.x+window->Size.x,y),GetColorU32(ImGuiCol_Separator));
+    Dummy(ImVec2(0.f,GetTextLineHeight()));
+}
+static void PopupMenuSimpleEntry(const char** pEntries,int i,bool asRow,bool& open,int& selectedEntry,int* pOptionalHoveredEntryOut) {
+    const char* entry = pEntries[i];
+    if (!entry || entry[0]=='\0')  {
+        if (asRow) PopupMenuSeparatorRow();
+        else ImGui::Separator();
+    }
+    else {
+        if (ImGui::Selectable(entry, false))  {
+            selectedEntry = i;open = false;    // Hide menu
+        }
+        else if (pOptionalHoveredEntryOut && ImGui::IsItemHovered()) *pOptionalHoveredEntryOut = i;
+    }
+}
+int PopupMenuSimple(bool &open, const char **pEntries, int numEntries, const char *optionalTitle, int *pOptionalHoveredEntryOut, int startIndex, int endIndex, bool reverseItems, const char *scrollUpEntryText, const char *scrollDownEntryText, int scrollToEntry)   {
     int selectedEntry = -1;
     if (pOptionalHoveredEntryOut) *pOptionalHoveredEntryOut=-1;
     if (!open) return selectedEntry;
@@ -150,30 +170,27 @@ int PopupMenuSimple(bool &open, const char **pEntries, int numEntries, const cha
             else ImGui::Text(" ");
             ImGui::SetWindowFontScale(fs);
         }
-        if (!reverseItems)  {
-            for (int i = startIndex; i <= endIndex; i++)    {
-                const char* entry = pEntries[i];
-                if (!entry || strlen(entry)==0) ImGui::Separator();
-                else {
-                    if (ImGui::Selectable(entry, false))  {
-                        selectedEntry = i;open = false;    // Hide menu
-                    }
-                    else if (pOptionalHoveredEntryOut && ImGui::IsItemHovered()) *pOptionalHoveredEntryOut = i;
+        const int numRows = endIndex-startIndex+1;
+        const float rowHeight = ImGui::GetTextLineHeightWithSpacing();
+        if (numRows*rowHeight > ImGui::GetIO().DisplaySize.y)   {
+            // Too many entries for the screen: the popup scrolls, and only the rows in view are submitted.
+            // Separators are as tall as entries here, so that row r is at r*rowHeight.
+            if (scrollToEntry>=startIndex && scrollToEntry<=endIndex)   {
+                const int row = reverseItems ? (endIndex-scrollToEntry) : (scrollToEntry-startIndex);
+                ImGui::SetScrollFromPosY(ImGui::GetCursorScreenPos().y - ImGui::GetWindowPos().y + (row+0.5f)*rowHeight, 0.5f);
+            }
+            ImGuiListClipper clipper(numRows,rowHeight);
+            while (clipper.Step())  {
+                for (int row = clipper.DisplayStart; row < clipper.DisplayEnd; row++)   {
+                    PopupMenuSimpleEntry(pEntries,reverseItems ? (endIndex-row) : (startIndex+row),true,open,selectedEntry,pOptionalHoveredEntryOut);
                 }
             }
         }
+        else if (!reverseItems)  {
+            for (int i = startIndex; i <= endIndex; i++) PopupMenuSimpleEntry(pEntries,i,false,open,selectedEntry,pOptionalHoveredEntryOut);
+        }
         else {
-            for (int i = endIndex; i >= startIndex; i--)    {
-                const char* entry = pEntries[i];
-                if (!entry || strlen(entry)==0) ImGui::Separator();
-                else {
-                    if (ImGui::Selectable(entry, false))  {
-                        selectedEntry = i;open = false;    // Hide menu
-                    }
-                    else if (pOptionalHoveredEntryOut && ImGui::IsItemHovered()) *pOptionalHoveredEntryOut = i;
-                }
-
-            }
+            for (int i = endIndex; i >= startIndex; i--) PopupMenuSimpleEntry(pEntries,i,false,open,selectedEntry,pOptionalHoveredEntryOut);
         }
         if (scrollDownEntryText && needsScrolling) {
             const float fs = ImGui::GetWindowFontScale();      // Internal to <imgui.cpp>
@@ -220,6 +237,13 @@ int PopupMenuSimple(PopupMenuSimpleParams &params, const char **pTotalEntries, i
     if (numAllowedEntries<1 || numTotalEntries==0) {params.open=false;return -1;}
     if (params.endIndex==-1) params.endIndex=reverseItems ? numTotalEntries-1 : numAllowedEntries-1;
     if (params.startIndex==-1) params.startIndex=params.endIndex-numAllowedEntries+1;
+    if (params.scrollToEntryIndex>=0)   {
+        // Slides the allowed entries just enough to show the entry
+        const int entry = ImMin(params.scrollToEntryIndex,numTotalEntries-1);
+        if (entry<params.startIndex) {params.startIndex=entry;params.endIndex=entry+numAllowedEntries-1;}
+        else if (entry>params.endIndex) {params.endIndex=entry;params.startIndex=entry-numAllowedEntries+1;}
+        params.scrollToEntryIndex=-1;
+    }
 
     const int oldHoveredEntry = params.hoveredEntry;
     params.selectedEntry = PopupMenuSimple(params.open,pTotalEntries,numTotalEntries,optionalTitle,&params.hoveredEntry,params.startIndex,params.endIndex,reverseItems,scrollUpEntryText,scrollDownEntryText);
@@ -1526,6 +1550,79 @@ int AppendTreeNodeHeaderButtons(const void* ptr_id, float startWindowCursorXForC
     return rv;
 }
 
+// Start PlotLodCache implementation --------------------------------------
+PlotLodCache::PlotLodCache(int _numSeries) : numSamples(0) {setNumSeries(_numSeries);}
+PlotLodCache::~PlotLodCache() {setNumSeries(0);}
+void PlotLodCache::clear()  {
+    for (int s=0;s<series.size();s++)   {
+        Series& sr = *series[s];
+        sr.values.clear();
+        for (int l=0;l<MAX_LEVELS;l++) {sr.mins[l].clear();sr.maxs[l].clear();}
+    }
+    numSamples = 0;
+}
+void PlotLodCache::setNumSeries(int _numSeries) {
+    IM_ASSERT(_numSeries>=0);
+    for (int s=_numSeries;s<series.size();s++) IM_DELETE(series[s]);
+    const int oldSize = series.size();
+    series.resize(_numSeries);
+    for (int s=oldSize;s<_numSeries;s++) series[s] = IM_NEW(Series);
+    clear();
+}
+void PlotLodCache::append(const float* values)  {
+    IM_ASSERT(values || series.size()==0);
+    const int n = ++numSamples;
+    for (int s=0;s<series.size();s++)   {
+        Series& sr = *series[s];
+        sr.values.push_back(values[s]);
+        // The new sample completes a block of level l when n is a multiple of 2<<l
+        for (int l=0;l<MAX_LEVELS && (n&((2<<l)-1))==0;l++)   {
+            const int i = (n>>(l+1))-1;
+            float vmin,vmax;
+            if (l==0)   {
+                vmin = ImMin(sr.values[2*i],sr.values[2*i+1]);
+                vmax = ImMax(sr.values[2*i],sr.values[2*i+1]);
+            }
+            else {
+                vmin = ImMin(sr.mins[l-1][2*i],sr.mins[l-1][2*i+1]);
+                vmax = ImMax(sr.maxs[l-1][2*i],sr.maxs[l-1][2*i+1]);
+            }
+            sr.mins[l].push_back(vmin);
+            sr.maxs[l].push_back(vmax);
+        }
+    }
+}
+int PlotLodCache::update(float (*getter)(const void* data,int idx,int seriesIdx),const void* data,int values_count)    {
+    IM_ASSERT(getter);
+    if (values_count<numSamples) clear();
+    const int numSeries = series.size();
+    ImVector<float> values;values.resize(numSeries);
+    const int oldNumSamples = numSamples;
+    for (int i=numSamples;i<values_count;i++)   {
+        for (int s=0;s<numSeries;s++) values[s] = getter(data,i,s);
+        append(values.Data);
+    }
+    return numSamples-oldNumSamples;
+}
+void PlotLodCache::getMinMax(int seriesIdx,int first,int last,float& vmin,float& vmax) const   {
+    vmin = FLT_MAX;vmax = -FLT_MAX;
+    if (first<0) first=0;
+    if (last>numSamples) last=numSamples;
+    if (first>=last) return;
+    const Series& sr = *series[seriesIdx];
+    // Bottom-up, like a segment tree: the odd ends of [a,b) are read at each level, then the range moves up one level
+    int a=first,b=last;
+    if (a&1) {const float v=sr.values[a++];vmin=ImMin(vmin,v);vmax=ImMax(vmax,v);}
+    if (b&1) {const float v=sr.values[--b];vmin=ImMin(vmin,v);vmax=ImMax(vmax,v);}
+    a>>=1;b>>=1;
+    for (int l=0;a<b;l++)   {
+        if (a&1) {vmin=ImMin(vmin,sr.mins[l][a]);vmax=ImMax(vmax,sr.maxs[l][a]);++a;}
+        if (b&1) {--b;vmin=ImMin(vmin,sr.mins[l][b]);vmax=ImMax(vmax,sr.maxs[l][b]);}
+        a>>=1;b>>=1;
+    }
+}
+// End PlotLodCache implementation ----------------------------------------
+
 // Start PlotHistogram(...) implementation -------------------------------
 struct ImGuiPlotMultiArrayGetterData    {
     const float** Values;int Stride;
@@ -1595,14 +1692,13 @@ int PlotHistogram(const char* label, const float** values,int num_histograms,int
     ImGuiPlotMultiArrayGetterData data(values, stride);
     return PlotHistogram(label, &Plot_MultiArrayGetter, (void*)&data, num_histograms, values_count, values_offset, overlay_text, scale_min, scale_max, graph_size,histogramGroupSpacingInPixels,pOptionalHoveredHistogramIndexOut,fillColorGradientDeltaIn0_05,pColorsOverride,numColorsOverride);
 }
+static const float PlotHistogramMinSingleHistogramWidth = 5.f;   // in pixels
+static const float PlotHistogramMaxSingleHistogramWidth = 100.f;   // in pixels
 int PlotHistogram(const char* label, float (*values_getter)(void* data, int idx,int histogramIdx), void* data,int num_histograms, int values_count, int values_offset, const char* overlay_text, float scale_min, float scale_max, ImVec2 graph_size,float histogramGroupSpacingInPixels,int* pOptionalHoveredHistogramIndexOut,float fillColorGradientDeltaIn0_05,const ImU32* pColorsOverride,int numColorsOverride)  {
     ImGuiWindow* window = GetCurrentWindow();
     if (pOptionalHoveredHistogramIndexOut) *pOptionalHoveredHistogramIndexOut=-1;
     if (window->SkipItems) return -1;
 
-    static const float minSingleHistogramWidth = 5.f;   // in pixels
-    static const float maxSingleHistogramWidth = 100.f;   // in pixels
-
     ImGuiContext& g = *GImGui;
     const ImGuiStyle& style = g.Style;
 
@@ -1663,8 +1759,8 @@ int PlotHistogram(const char* label, float (*values_getter)(void* data, int idx,
         const bool isAlwaysNegative = scale_max<0 && scale_min<0;
 
         float t_step = (inner_bb.Max.x-inner_bb.Min.x-(float)(values_count-1)*histogramGroupSpacingInPixels)/(float)total_histograms;
-        if (t_step<minSingleHistogramWidth) t_step = minSingleHistogramWidth;
-        else if (t_step>maxSingleHistogramWidth) t_step = maxSingleHistogramWidth;
+        if (t_step<PlotHistogramMinSingleHistogramWidth) t_step = PlotHistogramMinSingleHistogramWidth;
+        else if (t_step>PlotHistogramMaxSingleHistogramWidth) t_step = PlotHistogramMaxSingleHistogramWidth;
 
         float t1 = 0.f;
         float posY=0.f;ImVec2 pos0(0.f,0.f),pos1(0.f,0.f);
@@ -1781,6 +1877,50 @@ int PlotHistogram2(const char* label, const float* values,int values_count, int
     const float* pValues[1] = {values};
     return PlotHistogram(label,pValues,1,values_count,values_offset,overlay_text,scale_min,scale_max,graph_size,stride,0.f,NULL,fillColorGradientDeltaIn0_05,pColorsOverride,numColorsOverride);
 }
+// Splits [firstSample,firstSample+numSamples) of a PlotLodCache into 'numColumns' (<=numSamples) contiguous ranges
+struct PlotLodColumns {
+    const PlotLodCache* cache;
+    int firstSample,numSamples,numColumns;
+    PlotLodColumns(const PlotLodCache& _cache,int _firstSample,int _numSamples) : cache(&_cache),firstSample(_firstSample),numSamples(_numSamples),numColumns(0) {
+        if (firstSample<0) firstSample=0;
+        if (numSamples<0 || firstSample+numSamples>cache->getNumSamples()) numSamples = cache->getNumSamples()-firstSample;
+        if (numSamples<0) numSamples=0;
+    }
+    inline void getRange(int column,int& first,int& last) const {
+        first = firstSample + (int)(((long long)numSamples*column)/numColumns);
+        last  = firstSample + (int)(((long long)numSamples*(column+1))/numColumns);
+    }
+    static float HistogramGetter(void* data,int idx,int histogramIdx) {
+        const PlotLodColumns& d = *((const PlotLodColumns*) data);
+        int first,last;d.getRange(idx,first,last);
+        float vmin,vmax;d.cache->getMinMax(histogramIdx,first,last,vmin,vmax);
+        return (vmax>=-vmin) ? vmax : vmin;    // The value farthest from zero
+    }
+};
+int PlotHistogram(const char* label, const PlotLodCache& cache, int first_sample, int num_samples, const char* overlay_text, float scale_min, float scale_max, ImVec2 graph_size,float histogramGroupSpacingInPixels,int* pOptionalHoveredHistogramIndexOut,float fillColorGradientDeltaIn0_05,const ImU32* pColorsOverride,int numColorsOverride)    {
+    const int num_histograms = cache.getNumSeries();
+    PlotLodColumns data(cache,first_sample,num_samples);
+
+    // As many bars as fit at their min width (see the implementation above)
+    const ImGuiStyle& style = GetStyle();
+    const float innerWidth = (graph_size.x == 0.0f ? CalcItemWidth() : graph_size.x) - style.FramePadding.x * 2.f;
+    const float groupWidth = PlotHistogramMinSingleHistogramWidth*(float)ImMax(num_histograms,1) + histogramGroupSpacingInPixels;
+    data.numColumns = (int)((innerWidth+histogramGroupSpacingInPixels)/groupWidth);
+    if (data.numColumns<1) data.numColumns = 1;
+    if (data.numColumns>data.numSamples) data.numColumns = data.numSamples;
+
+    const int bar = PlotHistogram(label, &PlotLodColumns::HistogramGetter, (void*)&data, num_histograms, data.numColumns, 0, overlay_text, scale_min, scale_max, graph_size, histogramGroupSpacingInPixels, pOptionalHoveredHistogramIndexOut, fillColorGradientDeltaIn0_05, pColorsOverride, numColorsOverride);
+    if (bar<0) return -1;
+
+    int first,last;data.getRange(bar,first,last);
+    if (last-first>1)   {
+        // Replaces the tooltip of the bar with the range of samples it covers
+        const int h = pOptionalHoveredHistogramIndexOut ? *pOptionalHoveredHistogramIndexOut : 0;
+        float vmin,vmax;cache.getMinMax(h,first,last,vmin,vmax);
+        SetTooltip("%d-%d: %8.4g .. %8.4g", first, last-1, vmin, vmax);
+    }
+    return first;
+}
 // End PlotHistogram(...) implementation ----------------------------------
 // Start PlotCurve(...) implementation ------------------------------------
 int PlotCurve(const char* label, float (*values_getter)(void* data, float x,int numCurve), void* data,int num_curves,const char* overlay_text,const ImVec2 rangeY,const ImVec2 rangeX, ImVec2 graph_size,ImVec2* pOptionalHoveredValueOut,float precisionInPixels,float numGridLinesHint,const ImU32* pColorsOverride,int numColorsOverride)  {
@@ -1977,6 +2117,90 @@ static inline ImU32 InvertColorU32(ImU32 in)
     return GetColorU32(in4);
 }
 
+// PlotMultiEx(...) body for a PlotLodCache: one (min,max) query per pixel column and series, so the cost
+// doesn't depend on the number of samples. Lines join the first and last sample of each column and draw
+// a vertical stroke over the column's envelope; histogram bars go up to the value farthest from zero.
+static void PlotMultiLodEx(
+    ImGuiPlotType plot_type,
+    int num_datas,
+    const char** names,
+    const ImColor* colors,
+    PlotLodColumns columns,
+    float scale_min,
+    float scale_max,
+    const ImRect& inner_bb)
+{
+    if (columns.numSamples <= 0)
+        return;
+    ImGuiContext& g = *GImGui;
+    ImGuiWindow* window = g.CurrentWindow;
+    const PlotLodCache& lod = *columns.cache;
+
+    columns.numColumns = ImMax(1, ImMin((int) inner_bb.GetWidth(), columns.numSamples));
+    const float scale_extension = (scale_max != scale_min) ? (scale_max - scale_min) : 1.0f;
+
+    // Tooltip on hover
+    int c_hovered = -1;
+    if (ItemHoverable(inner_bb, 0))
+    {
+        const float t = ImClamp((g.IO.MousePos.x - inner_bb.Min.x) / (inner_bb.Max.x - inner_bb.Min.x), 0.0f, 0.9999f);
+        c_hovered = (int) (t * columns.numColumns);
+        int first, last;
+        columns.getRange(c_hovered, first, last);
+        BeginTooltip();
+        for (int dataIdx = 0; dataIdx < num_datas; ++dataIdx)
+        {
+            float v_min, v_max;
+            lod.getMinMax(dataIdx, first, last, v_min, v_max);
+            if (last - first == 1)
+                TextColored(colors[dataIdx], "%d: %8.4g | %s", first, v_min, names[dataIdx]);
+            else
+                TextColored(colors[dataIdx], "%d-%d: %8.4g .. %8.4g | %s", first, last - 1, v_min, v_max, names[dataIdx]);
+        }
+        EndTooltip();
+    }
+
+    // Lines: the first and last column touch the frame borders (like PlotMultiEx(...) does)
+    const float t_step = (plot_type == ImGuiPlotType_Lines) ? (columns.numColumns > 1 ? 1.0f / (float) (columns.numColumns - 1) : 0.0f) : 1.0f / (float) columns.numColumns;
+    for (int data_idx = 0; data_idx < num_datas; ++data_idx)
+    {
+        const ImU32 col_base = colors[data_idx];
+        const ImU32 col_hovered = InvertColorU32(colors[data_idx]);
+        ImVec2 pos_last(0.0f, 0.0f);
+        for (int c = 0; c < columns.numColumns; c++)
+        {
+            int first, last;
+            columns.getRange(c, first, last);
+            float v_min, v_max;
+            lod.getMinMax(data_idx, first, last, v_min, v_max);
+            const ImU32 col = (c == c_hovered) ? col_hovered : col_base;
+            if (plot_type == ImGuiPlotType_Lines)
+            {
+                const float x = ImLerp(inner_bb.Min.x, inner_bb.Max.x, t_step * (float) c);
+                const ImVec2 pos_first(x, ImLerp(inner_bb.Min.y, inner_bb.Max.y, 1.0f - ImSaturate((lod.getValue(data_idx, first) - scale_min) / scale_extension)));
+                if (c > 0)
+                    window->DrawList->AddLine(pos_last, pos_first, col);
+                if (last - first > 1)
+                {
+                    const float y_max = ImLerp(inner_bb.Min.y, inner_bb.Max.y, 1.0f - ImSaturate((v_max - scale_min) / scale_extension));
+                    const float y_min = ImLerp(inner_bb.Min.y, inner_bb.Max.y, 1.0f - ImSaturate((v_min - scale_min) / scale_extension));
+                    window->DrawList->AddLine(ImVec2(x, y_max), ImVec2(x, ImMax(y_min, y_max + 1.0f)), col);
+                }
+                pos_last = ImVec2(x, ImLerp(inner_bb.Min.y, inner_bb.Max.y, 1.0f - ImSaturate((lod.getValue(data_idx, last - 1) - scale_min) / scale_extension)));
+            }
+            else if (plot_type == ImGuiPlotType_Histogram)
+            {
+                const float v = (v_max >= -v_min) ? v_max : v_min;
+                const ImVec2 pos0 = ImLerp(inner_bb.Min, inner_bb.Max, ImVec2(t_step * (float) c, 1.0f - ImSaturate((v - scale_min) / scale_extension)));
+                ImVec2 pos1 = ImLerp(inner_bb.Min, inner_bb.Max, ImVec2(t_step * (float) (c + 1), 1.0f));
+                if (pos1.x >= pos0.x + 2.0f)
+                    pos1.x -= 1.0f;
+                window->DrawList->AddRectFilled(pos0, pos1, col);
+            }
+        }
+    }
+}
+
 static void PlotMultiEx(
     ImGuiPlotType plot_type,
     const char* label,
@@ -1988,8 +2212,10 @@ static void PlotMultiEx(
     int values_count,
     float scale_min,
     float scale_max,
-    ImVec2 graph_size)
+    ImVec2 graph_size,
+    const PlotLodColumns* lod = NULL)
 {
+    // When 'lod' is set, 'getter' and 'datas' are unused (and 'values_count' is lod->numSamples)
     const int values_offset = 0;
 
     ImGuiWindow* window = GetCurrentWindow();
@@ -2019,6 +2245,14 @@ static void PlotMultiEx(
         float v_max = -FLT_MAX;
         for (int data_idx = 0; data_idx < num_datas; ++data_idx)
         {
+            if (lod)
+            {
+                float lod_min, lod_max;
+                lod->cache->getMinMax(data_idx, lod->firstSample, lod->firstSample + lod->numSamples, lod_min, lod_max);
+                v_min = ImMin(v_min, lod_min);
+                v_max = ImMax(v_max, lod_max);
+                continue;
+            }
             for (int i = 0; i < values_count; i++)
             {
                 const float v = getter(datas[data_idx], i);
@@ -2034,6 +2268,13 @@ static void PlotMultiEx(
 
     RenderFrame(frame_bb.Min, frame_bb.Max, GetColorU32(ImGuiCol_FrameBg), true, style.FrameRounding);
 
+    if (lod)
+    {
+        PlotMultiLodEx(plot_type, num_datas, names, colors, *lod, scale_min, scale_max, inner_bb);
+        RenderText(ImVec2(frame_bb.Max.x + style.ItemInnerSpacing.x, inner_bb.Min.y), label);
+        return;
+    }
+
     int res_w = ImMin((int) graph_size.x, values_count) + ((plot_type == ImGuiPlotType_Lines) ? -1 : 0);
     int item_count = values_count + ((plot_type == ImGuiPlotType_Lines) ? -1 : 0);
 
@@ -2144,6 +2385,35 @@ void PlotMultiHistograms(
 {
     PlotMultiEx(ImGuiPlotType_Histogram, label, num_hists, names, colors, getter, datas, values_count, scale_min, scale_max, graph_size);
 }
+void PlotMultiLines(
+    const char* label,
+    const char** names,
+    const ImColor* colors,
+    const PlotLodCache& cache,
+    int first_sample,
+    int num_samples,
+    float scale_min,
+    float scale_max,
+    ImVec2 graph_size)
+{
+    const PlotLodColumns columns(cache, first_sample, num_samples);
+    PlotMultiEx(ImGuiPlotType_Lines, label, cache.getNumSeries(), names, colors, NULL, NULL, columns.numSamples, scale_min, scale_max, graph_size, &columns);
+}
+
+void PlotMultiHistograms(
+    const char* label,
+    const char** names,
+    const ImColor* colors,
+    const PlotLodCache& cache,
+    int first_sample,
+    int num_samples,
+    float scale_min,
+    float scale_max,
+    ImVec2 graph_size)
+{
+    const PlotLodColumns columns(cache, first_sample, num_samples);
+    PlotMultiEx(ImGuiPlotType_Histogram, label, cache.getNumSeries(), names, colors, NULL, NULL, columns.numSamples, scale_min, scale_max, graph_size, &columns);
+}
 // End PlotMultiLines(...) and PlotMultiHistograms(...)--------------------------
 
 int DefaultInputTextAutoCompletionCallback(ImGuiTextEditCallbackData *data) {
@@ -2159,19 +2429,38 @@ int DefaultInputTextAutoCompletionCallback(ImGuiTextEditCallbackData *data) {
     return 0;
 }
 float InputTextWithAutoCompletionData::Opacity = 0.6f;
+// Binary search for the first item position whose text compares >= txt (or > txt when upper is true), comparing only the first prefixLen chars when prefixLen>0.
+// Items the getter fails on are stepped over (as the old linear scans did), so the result is always a position of a valid item or items_count.
+static int InputTextWithAutoCompletionBound(const char* txt,size_t prefixLen,bool upper,bool (*items_getter)(void*, int, const char**), int items_count, void* user_data) {
+    int lo = 0, hi = items_count;
+    const char* itxt = NULL;
+    while (lo<hi) {
+        const int mid = lo + (hi-lo)/2;
+        int probe = mid;
+        while (probe<hi && !items_getter(user_data,probe,&itxt)) ++probe;
+        if (probe==hi) {hi=mid;continue;}
+        const int cmp = prefixLen>0 ? strncmp(itxt,txt,prefixLen) : strcmp(itxt,txt);
+        if (upper ? cmp<=0 : cmp<0) lo = probe+1;
+        else hi = probe;
+    }
+    while (lo<items_count && !items_getter(user_data,lo,&itxt)) ++lo;  // [lo,hi) may end up all failed items
+    return lo;
+}
 int InputTextWithAutoCompletionData::HelperGetItemInsertionPosition(const char* txt,bool (*items_getter)(void*, int, const char**), int items_count, void* user_data,bool* item_is_already_present_out) {
     if (item_is_already_present_out) *item_is_already_present_out=false;
     if (!txt || txt[0]=='\0' || !items_getter || items_count<0) return -1;
-    const char* itxt = NULL;int cmp = 0;
-    for (int i=0;i<items_count;i++) {
-        if (items_getter(user_data,i,&itxt))   {
-            if ((cmp=strcmp(itxt,txt))>=0)  {
-                if (item_is_already_present_out && cmp==0) *item_is_already_present_out=true;
-                return i;
-            }
-        }
-    }
-    return items_count;
+    const int pos = InputTextWithAutoCompletionBound(txt,0,false,items_getter,items_count,user_data);
+    const char* itxt = NULL;
+    if (item_is_already_present_out && pos<items_count && items_getter(user_data,pos,&itxt) && strcmp(itxt,txt)==0) *item_is_already_present_out=true;
+    return pos;
+}
+int InputTextWithAutoCompletionData::HelperGetItemPrefixRange(const char* prefix,bool (*items_getter)(void*, int, const char**), int items_count, void* user_data,int* range_end_out) {
+    if (range_end_out) *range_end_out=-1;
+    if (!prefix || prefix[0]=='\0' || !items_getter || items_count<0) return -1;
+    const size_t prefixLen = strlen(prefix);
+    const int first = InputTextWithAutoCompletionBound(prefix,prefixLen,false,items_getter,items_count,user_data);
+    if (range_end_out) *range_end_out = InputTextWithAutoCompletionBound(prefix,prefixLen,true,items_getter,items_count,user_data);
+    return first;
 }
 int InputTextWithAutoCompletionData::HelperInsertItem(const char* txt,bool (*items_getter)(void*, int, const char**),bool (*items_inserter)(void*, int,const char*), int items_count, void* user_data,bool* item_is_already_present_out) {
     if (!txt || txt[0]=='\0' || !items_getter || !items_inserter || items_count<0) return -1;
@@ -2198,19 +2487,9 @@ bool InputTextWithAutoCompletion(const char* label, char* buf, size_t buf_size,
         // return pressed
         ad.itemPositionOfReturnedText=ad.itemIndexOfReturnedText=-1;
         if (strlen(buf)>0)  {
-            const char* txt=NULL;
-            int itemPlacement = 0,comp = 0, alreadyPresentIndex = -1;
-            for (int i=0;i<autocompletion_items_size;i++) {
-                if (autocompletion_items_getter(autocompletion_user_data,i,&txt))   {
-                    comp = strcmp(buf,txt);
-                    if (comp>0) ++itemPlacement;
-                    else if (comp==0) {
-                        alreadyPresentIndex=i;
-                        break;    // already present
-                    }
-                }
-            }
-            if (alreadyPresentIndex>=0)	{ad.itemIndexOfReturnedText=alreadyPresentIndex;}
+            bool alreadyPresent = false;
+            const int itemPlacement = InputTextWithAutoCompletionData::HelperGetItemInsertionPosition(buf,autocompletion_items_getter,autocompletion_items_size,autocompletion_user_data,&alreadyPresent);
+            if (alreadyPresent)	{ad.itemIndexOfReturnedText=itemPlacement;}
             else {ad.itemPositionOfReturnedText=itemPlacement;}
         }
         return rv;
@@ -2226,42 +2505,10 @@ bool InputTextWithAutoCompletion(const char* label, char* buf, size_t buf_size,
                 ad.deltaTTItems = 0;    // We reset the UP/DOWN offset whe text changes
             }
 
-            int selectedTTItemIndex = numItems-1;
+            // First item >= buf (the last item if none is)
+            int selectedTTItemIndex = InputTextWithAutoCompletionBound(buf,0,false,autocompletion_items_getter,numItems,autocompletion_user_data);
+            if (selectedTTItemIndex>=numItems) selectedTTItemIndex=numItems-1;
             const char* txt=NULL;
-            // We need to fetch the selectedTTItemIndex here
-            if (ad.lastSelectedTTItemIndex>=0 && ad.lastSelectedTTItemIndex<numItems && autocompletion_items_getter(autocompletion_user_data,ad.lastSelectedTTItemIndex,&txt))   {
-                // Speed up branch (we start our search from previous frame: ad.lastSelectedTTItemIndex
-                int i = ad.lastSelectedTTItemIndex;
-                //int cnt = 0;
-                if (strcmp(txt,buf)<0)  {
-                    while (i<numItems) {
-                        if (autocompletion_items_getter(autocompletion_user_data,++i,&txt))   {
-                            if (strcmp(txt,buf)>=0)  {selectedTTItemIndex=i;break;}
-                        }
-                        //++cnt;
-                    }
-                    if (i>=numItems) selectedTTItemIndex=numItems-1;
-                }
-                else {
-                    while (i>=0) {
-                        if (autocompletion_items_getter(autocompletion_user_data,i-1,&txt))   {
-                            if (strcmp(txt,buf)<0)  {selectedTTItemIndex=i;break;}
-                        }
-                        --i;
-                        //++cnt;
-                    }
-                    if (i<0) selectedTTItemIndex=0;
-                }
-                //static int oldCnt=10000000;if (cnt!=oldCnt) {fprintf(stderr,"cnt=%d\n",cnt);oldCnt=cnt;}
-            }
-            else {
-                // Normal (slow) branch
-                for (int i=0;i<numItems;i++) {
-                    if (autocompletion_items_getter(autocompletion_user_data,i,&txt))   {
-                        if (strcmp(txt,buf)>=0)  {selectedTTItemIndex=i;break;}
-                    }
-                }
-            }
             if (selectedTTItemIndex + ad.deltaTTItems>=numItems) ad.deltaTTItems=numItems-selectedTTItemIndex-1;
             else if (selectedTTItemIndex + ad.deltaTTItems<0) ad.deltaTTItems=-selectedTTItemIndex;
             ad.lastSelectedTTItemIndex=selectedTTItemIndex+=ad.deltaTTItems;
@@ -2524,6 +2771,125 @@ bool InputComboWithAutoCompletion(const char* label, int *current_item, size_t a
 
 namespace ImGui {
 
+// Appends "s" and its terminator to a text arena
+static void TreeViewAppendText(ImVector<char>& text,const char* s) {
+    if (!s) s="";
+    const int len = strlen(s);
+    const int start = text.Size;
+    text.resize(start+len+1);
+    memcpy(&text[start],s,len+1);
+}
+
+#ifndef NO_IMGUIVARIOUSCONTROLS_BINARY_SERIALIZATION
+// Binary tree view format (TreeView::saveBinary(...) and FlatTreeView::saveBinary(...)):
+// the header is 4 ImU32s (magic "IMTV", format version, kind of tree, number of blocks), then every block is
+// an ImU32 tag, an ImU32 payload size in bytes, the payload and zero padding up to a multiple of 4 bytes.
+// Values are stored in host byte order (a file from a machine with the other byte order fails the magic check).
+// A reader first walks the block list, checking every size against the buffer, and then decodes just the blocks
+// it needs, reading them in place: blocks with unknown tags are skipped, so adding an optional block doesn't need
+// a new version (the version changes only when the layout of an existing block does).
+enum {
+    TREEVIEW_BINARY_MAGIC = 'I' | ('M'<<8) | ('T'<<16) | ('V'<<24),
+    TREEVIEW_BINARY_VERSION = 1,
+    TREEVIEW_BINARY_KIND_TREEVIEW = 1,
+    TREEVIEW_BINARY_KIND_FLATTREEVIEW = 2
+};
+static inline ImU32 TreeViewBinaryTag(const char* tag) {return (ImU32)tag[0] | ((ImU32)tag[1]<<8) | ((ImU32)tag[2]<<16) | ((ImU32)tag[3]<<24);}
+
+struct TreeViewBinaryWriter {
+    ImVector<char>& out;
+    ImU32 numBlocks;
+    int blockStart;
+    TreeViewBinaryWriter(ImVector<char>& _out,ImU32 kind) : out(_out),numBlocks(0),blockStart(-1) {
+        const ImU32 header[4] = {TREEVIEW_BINARY_MAGIC,TREEVIEW_BINARY_VERSION,kind,0};
+        out.resize(0);
+        append(header,sizeof(header));
+    }
+    void append(const void* p,size_t size) {
+        if (size==0) return;
+        const int start = out.Size;
+        out.resize(start+(int)size);
+        memcpy(&out[start],p,size);
+    }
+    void beginBlock(const char* tag) {
+        const ImU32 blockHeader[2] = {TreeViewBinaryTag(tag),0};
+        append(blockHeader,sizeof(blockHeader));
+        blockStart = out.Size;
+    }
+    void endBlock() {
+        const ImU32 size = (ImU32)(out.Size-blockStart);
+        memcpy(&out[blockStart-4],&size,4);
+        while (out.Size&3) out.push_back(0);
+        ++numBlocks;
+        memcpy(&out[12],&numBlocks,4);
+    }
+    void block(const char* tag,const void* p,size_t size) {beginBlock(tag);append(p,size);endBlock();}
+};
+
+struct TreeViewBinaryReader {
+    struct Block {
+        ImU32 tag,size;
+        const char* data;   // inside the buffer passed to open(...)
+    };
+    ImVector<Block> blocks;
+    bool open(const void* data,size_t size,ImU32 kind) {
+        blocks.clear();
+        ImU32 header[4];
+        if (!data || size<sizeof(header)) return false;
+        memcpy(header,data,sizeof(header));
+        if (header[0]!=TREEVIEW_BINARY_MAGIC || header[1]==0 || header[1]>TREEVIEW_BINARY_VERSION || header[2]!=kind) return false;
+        const char* p = (const char*)data+sizeof(header);
+        const char* end = (const char*)data+size;
+        for (ImU32 i=0;i<header[3];i++) {
+            Block b;
+            if ((size_t)(end-p)<8) return false;
+            memcpy(&b.tag,p,4);memcpy(&b.size,p+4,4);p+=8;
+            const size_t padding = (4-(b.size&3))&3;
+            if ((size_t)(end-p)<(size_t)b.size+padding) return false;
+            b.data = p;
+            blocks.push_back(b);
+            p+=b.size+padding;
+        }
+        return true;
+    }
+    const Block* find(const char* tag) const {
+        const ImU32 t = TreeViewBinaryTag(tag);
+        for (int i=0;i<blocks.Size;i++) {if (blocks[i].tag==t) return &blocks[i];}
+        return NULL;
+    }
+    // Copies a block made of elements of type T (count>=0: the block must have exactly count elements)
+    template<typename T> bool read(const char* tag,ImVector<T>& out,int count=-1) const {
+        const Block* b = find(tag);
+        if (!b || b->size%sizeof(T)!=0) return false;
+        const int n = (int)(b->size/sizeof(T));
+        if (count>=0 && n!=count) return false;
+        out.resize(n);
+        if (n>0) memcpy(out.Data,b->data,b->size);
+        return true;
+    }
+};
+
+static bool TreeViewBinarySaveToFile(const ImVector<char>& buf,const char* filename) {
+    ImFileHandle f = ImFileOpen(filename,"wb");
+    if (!f) return false;
+    const bool ok = ImFileWrite(buf.Data,1,(ImU64)buf.Size,f)==(ImU64)buf.Size;
+    return ImFileClose(f) && ok;
+}
+
+// TreeView blocks: "TVOP" (one TreeViewBinaryOptions), "NODE" (the nodes in pre-order) and "TEXT" (their strings)
+struct TreeViewBinaryNode {
+    ImS32 parent;           // index of the parent record (always a previous one), -1 for root nodes
+    ImS32 state;
+    ImS32 userId;
+    ImS32 numChildNodes;    // -1 when the node has no child node vector
+    ImU32 displayName,tooltip,userText; // offsets inside "TEXT", 0xFFFFFFFF = NULL
+};
+struct TreeViewBinaryOptions {
+    ImVec4 stateColors[6];
+    ImS32 selectionMode,allowMultipleSelection,checkboxMode,allowAutoCheckboxBehaviour,collapseToLeafNodesAtNodeDepth,inheritDisabledLook;
+};
+#endif //NO_IMGUIVARIOUSCONTROLS_BINARY_SERIALIZATION
+
 struct MyTreeViewHelperStruct {
     TreeView& parentTreeView;
     bool mustDrawAllNodesAsDisabled;
@@ -2704,6 +3070,68 @@ struct MyTreeViewHelperStruct {
     }
 #endif //NO_IMGUIHELPER_SERIALIZATION_LOAD
 #endif //NO_IMGUIHELPER_SERIALIZATION
+#ifndef NO_IMGUIVARIOUSCONTROLS_BINARY_SERIALIZATION
+    static ImU32 AppendBinaryText(ImVector<char>& text,const char* s) {
+        if (!s) return 0xFFFFFFFF;
+        const ImU32 offset = (ImU32) text.Size;
+        TreeViewAppendText(text,s);
+        return offset;
+    }
+    static void SerializeBinary(const TreeViewNode* n,int parentIndex,ImVector<TreeViewBinaryNode>& nodes,ImVector<char>& text) {
+        if (!n->childNodes) return;
+        for (int i=0,isz=n->childNodes->size();i<isz;i++) {
+            const TreeViewNode* c = (*(n->childNodes))[i];
+            if (!c) continue;
+            TreeViewBinaryNode r;
+            r.parent = parentIndex;
+            r.state = c->state;
+            r.userId = c->data.userId;
+            r.numChildNodes = c->childNodes ? c->childNodes->size() : -1;
+            r.displayName = AppendBinaryText(text,c->data.displayName);
+            r.tooltip = AppendBinaryText(text,c->data.tooltip);
+            r.userText = AppendBinaryText(text,c->data.userText);
+            const int index = nodes.Size;
+            nodes.push_back(r);
+            SerializeBinary(c,index,nodes,text);
+        }
+    }
+    static bool DeserializeBinary(TreeView& tv,const TreeViewBinaryReader& r) {
+        const TreeViewBinaryReader::Block* nodes = r.find("NODE");
+        const TreeViewBinaryReader::Block* text = r.find("TEXT");
+        if (!nodes || !text || nodes->size%sizeof(TreeViewBinaryNode)!=0 || (text->size>0 && text->data[text->size-1]!='\0')) return false;
+
+        ImVector<TreeViewBinaryOptions> options;
+        if (r.read("TVOP",options,1)) {
+            const TreeViewBinaryOptions& o = options[0];
+            for (int i=0;i<6;i++) tv.stateColors[i] = o.stateColors[i];
+            tv.selectionMode = (unsigned int) o.selectionMode;
+            tv.allowMultipleSelection = o.allowMultipleSelection!=0;
+            tv.checkboxMode = (unsigned int) o.checkboxMode;
+            tv.allowAutoCheckboxBehaviour = o.allowAutoCheckboxBehaviour!=0;
+            tv.collapseToLeafNodesAtNodeDepth = o.collapseToLeafNodesAtNodeDepth;
+            tv.inheritDisabledLook = o.inheritDisabledLook!=0;
+        }
+
+        // Records and strings are read in place, but this isn't a lazy load: every node is created here and its
+        // Data duplicates the strings, because TreeViewNode owns them (FlatTreeView is the one that loads as block copies)
+        const int numNodes = (int)(nodes->size/sizeof(TreeViewBinaryNode));
+        ImVector<TreeViewNode*> created;created.resize(numNodes);
+        for (int i=0;i<numNodes;i++) {
+            TreeViewBinaryNode rec;
+            memcpy(&rec,nodes->data+i*sizeof(TreeViewBinaryNode),sizeof(TreeViewBinaryNode));
+            if (rec.parent<-1 || rec.parent>=i) return false;
+            const ImU32 strings[3] = {rec.displayName,rec.tooltip,rec.userText};
+            for (int j=0;j<3;j++) {if (strings[j]!=0xFFFFFFFF && strings[j]>=text->size) return false;}
+            TreeViewNode* parent = rec.parent<0 ? static_cast<TreeViewNode*>(&tv) : created[rec.parent];
+            created[i] = TreeViewNode::CreateNode(TreeViewNode::Data(rec.displayName!=0xFFFFFFFF ? text->data+rec.displayName : NULL,
+                                                                     rec.tooltip!=0xFFFFFFFF ? text->data+rec.tooltip : NULL,
+                                                                     rec.userText!=0xFFFFFFFF ? text->data+rec.userText : NULL,rec.userId),
+                                                  parent,-1,rec.numChildNodes>=0);
+            created[i]->state = rec.state;
+        }
+        return true;
+    }
+#endif //NO_IMGUIVARIOUSCONTROLS_BINARY_SERIALIZATION
 
 
     // Default event callbacks
@@ -3419,6 +3847,44 @@ void TreeView::setTextColorForStateColor(int aStateColorFlag, const ImVec4 &text
         }
 #       endif //NO_IMGUIHELPER_SERIALIZATION_LOAD
 #       endif //NO_IMGUIHELPER_SERIALIZATION
+#       ifndef NO_IMGUIVARIOUSCONTROLS_BINARY_SERIALIZATION
+        void TreeView::saveBinary(ImVector<char>& out) const {
+            ImVector<TreeViewBinaryNode> nodes;ImVector<char> text;
+            MyTreeViewHelperStruct::SerializeBinary(this,-1,nodes,text);
+            TreeViewBinaryOptions o;
+            for (int i=0;i<6;i++) o.stateColors[i] = stateColors[i];
+            o.selectionMode = (ImS32) selectionMode;
+            o.allowMultipleSelection = allowMultipleSelection ? 1 : 0;
+            o.checkboxMode = (ImS32) checkboxMode;
+            o.allowAutoCheckboxBehaviour = allowAutoCheckboxBehaviour ? 1 : 0;
+            o.collapseToLeafNodesAtNodeDepth = collapseToLeafNodesAtNodeDepth;
+            o.inheritDisabledLook = inheritDisabledLook ? 1 : 0;
+            TreeViewBinaryWriter w(out,TREEVIEW_BINARY_KIND_TREEVIEW);
+            w.block("TVOP",&o,sizeof(o));
+            w.block("NODE",nodes.Data,nodes.Size*sizeof(TreeViewBinaryNode));
+            w.block("TEXT",text.Data,text.Size);
+        }
+        bool TreeView::saveBinary(const char* filename) const {
+            ImVector<char> buf;
+            saveBinary(buf);
+            return TreeViewBinarySaveToFile(buf,filename);
+        }
+        bool TreeView::loadBinary(const void* data,size_t size) {
+            TreeViewBinaryReader r;
+            if (!r.open(data,size,TREEVIEW_BINARY_KIND_TREEVIEW)) return false;
+            clear();
+            if (!MyTreeViewHelperStruct::DeserializeBinary(*this,r)) {clear();return false;}
+            return true;
+        }
+        bool TreeView::loadBinary(const char* filename) {
+            size_t size = 0;
+            void* data = ImFileLoadToMemory(filename,"rb",&size);
+            if (!data) return false;
+            const bool ok = loadBinary(data,size);
+            ImGui::MemFree(data);
+            return ok;
+        }
+#       endif //NO_IMGUIVARIOUSCONTROLS_BINARY_SERIALIZATION
 //--------------------------------------------------------------------------------
 
 char TreeView::FontCheckBoxGlyphs[2][5]={{'\0','\0','\0','\0','\0'},{'\0','\0','\0','\0','\0'}};
@@ -3439,6 +3905,323 @@ void TreeView::SetFontArrowGlyphs(const char *leftArrow, const char *downArrow)
     else FontArrowGlyphs[0][0]=FontArrowGlyphs[1][0]='\0';
 }
 
+// FlatTreeView
+FlatTreeView::FlatTreeView(bool _allowMultipleSelection,bool _showCheckboxes) : allowMultipleSelection(_allowMultipleSelection),showCheckboxes(_showCheckboxes),allowAutoCheckboxBehaviour(true),userPtr(NULL),
+    firstRoot(-1),lastRoot(-1),rowsDirty(false),nodeAfterDrawCb(NULL),nodeAfterDrawCbUserPtr(NULL) {}
+
+void FlatTreeView::clear() {
+    parents.clear();firstChildren.clear();lastChildren.clear();nextSiblings.clear();numChildren.clear();
+    depths.clear();nameOffsets.clear();userIds.clear();text.clear();
+    for (int i=0;i<STATE_COUNT;i++) states[i].clear();
+    firstRoot=lastRoot=-1;
+    rows.clear();rowsDirty=false;
+    lastEvent.reset();
+}
+
+void FlatTreeView::reserve(int numNodes,int numTextBytes) {
+    parents.reserve(numNodes);firstChildren.reserve(numNodes);lastChildren.reserve(numNodes);nextSiblings.reserve(numNodes);numChildren.reserve(numNodes);
+    depths.reserve(numNodes);nameOffsets.reserve(numNodes);userIds.reserve(numNodes);
+    if (numTextBytes>0) text.reserve(numTextBytes);
+    for (int i=0;i<STATE_COUNT;i++) states[i].reserve((numNodes+31)/32);
+}
+
+int FlatTreeView::addNode(const char* displayName,int parentNode,int userId) {
+    IM_ASSERT(parentNode<parents.Size);
+    const int n = parents.Size;
+    parents.push_back(parentNode);
+    firstChildren.push_back(-1);lastChildren.push_back(-1);nextSiblings.push_back(-1);numChildren.push_back(0);depths.push_back(0);
+    userIds.push_back(userId);
+    nameOffsets.push_back(text.Size);
+    TreeViewAppendText(text,displayName);
+    if ((n&31)==0) {for (int i=0;i<STATE_COUNT;i++) states[i].push_back(0);}
+    linkNode(n);
+
+    // A node added under a collapsed (or hidden) node doesn't get a row
+    if (!rowsDirty) rowsDirty = parentNode<0 || (testState(StateIndex(STATE_OPEN),parentNode) && hasRow(parentNode));
+    return n;
+}
+
+void FlatTreeView::linkNode(int n) {
+    const int parentNode = parents[n];
+    firstChildren[n]=lastChildren[n]=nextSiblings[n]=-1;numChildren[n]=0;
+    depths[n] = parentNode>=0 ? depths[parentNode]+1 : 0;
+    int& first = parentNode>=0 ? firstChildren[parentNode] : firstRoot;
+    int& last = parentNode>=0 ? lastChildren[parentNode] : lastRoot;
+    if (last>=0) nextSiblings[last]=n;
+    else first=n;
+    last=n;
+    if (parentNode>=0) ++numChildren[parentNode];
+}
+
+void FlatTreeView::setDisplayName(int n,const char* displayName) {
+    nameOffsets[n]=text.Size;
+    TreeViewAppendText(text,displayName);
+}
+
+void FlatTreeView::setState(int n,int stateFlags,bool add) {
+    for (int i=0;i<STATE_COUNT;i++) {
+        if (!(stateFlags&(1<<i)) || testState(i,n)==add) continue;
+        if (!rowsDirty) {
+            // Only opening/closing a node that has a row, or hiding/showing a child of an expanded node, changes the rows
+            if ((1<<i)==STATE_OPEN) rowsDirty = firstChildren[n]>=0 && hasRow(n);
+            else if ((1<<i)==STATE_HIDDEN) rowsDirty = parents[n]<0 || (testState(StateIndex(STATE_OPEN),parents[n]) && hasRow(parents[n]));
+        }
+        if (add) states[i][n>>5]|=(1u<<(n&31));
+        else states[i][n>>5]&=~(1u<<(n&31));
+    }
+}
+
+bool FlatTreeView::isStatePresent(int n,int stateFlags) const {
+    for (int i=0;i<STATE_COUNT;i++) {
+        if ((stateFlags&(1<<i)) && !testState(i,n)) return false;
+    }
+    return true;
+}
+
+void FlatTreeView::addStateToAllNodes(int stateFlags) {
+    for (int i=0;i<STATE_COUNT;i++) {
+        if (!(stateFlags&(1<<i)) || states[i].Size==0) continue;
+        memset(states[i].Data,0xFF,states[i].Size*sizeof(ImU32));
+        if (parents.Size&31) states[i].back() = (1u<<(parents.Size&31))-1;   // no bits past the last node
+    }
+    if (stateFlags&(STATE_OPEN|STATE_HIDDEN)) rowsDirty=true;
+}
+
+void FlatTreeView::removeStateFromAllNodes(int stateFlags) {
+    for (int i=0;i<STATE_COUNT;i++) {
+        if ((stateFlags&(1<<i)) && states[i].Size>0) memset(states[i].Data,0,states[i].Size*sizeof(ImU32));
+    }
+    if (stateFlags&(STATE_OPEN|STATE_HIDDEN)) rowsDirty=true;
+}
+
+void FlatTreeView::addStateToAllDescendants(int n,int stateFlags) {
+    for (int c=getNextNode(n,n);c>=0;c=getNextNode(c,n)) {
+        for (int i=0;i<STATE_COUNT;i++) {if (stateFlags&(1<<i)) states[i][c>>5]|=(1u<<(c&31));}
+    }
+    if (stateFlags&(STATE_OPEN|STATE_HIDDEN)) rowsDirty=true;
+}
+
+void FlatTreeView::removeStateFromAllDescendants(int n,int stateFlags) {
+    for (int c=getNextNode(n,n);c>=0;c=getNextNode(c,n)) {
+        for (int i=0;i<STATE_COUNT;i++) {if (stateFlags&(1<<i)) states[i][c>>5]&=~(1u<<(c&31));}
+    }
+    if (stateFlags&(STATE_OPEN|STATE_HIDDEN)) rowsDirty=true;
+}
+
+void FlatTreeView::getAllNodesWithState(ImVector<int>& result,int stateFlag,bool clearResultBeforeUsage) const {
+    if (clearResultBeforeUsage) result.clear();
+    const ImVector<ImU32>& bits = states[StateIndex(stateFlag)];
+    for (int w=0;w<bits.Size;w++) {
+        // whole words of unset bits are skipped
+        ImU32 word = bits[w];
+        for (int b=0;word;b++,word>>=1) {if (word&1) result.push_back((w<<5)+b);}
+    }
+}
+
+void FlatTreeView::openAllParentNodes(int n) {
+    for (int p=parents[n];p>=0;p=parents[p]) addState(p,STATE_OPEN);
+}
+
+int FlatTreeView::getNumVisibleRows() {
+    if (rowsDirty) updateRows();
+    return rows.Size;
+}
+
+int FlatTreeView::getVisibleRowNode(int row) {
+    if (rowsDirty) updateRows();
+    return (row>=0 && row<rows.Size) ? rows[row] : -1;
+}
+
+int FlatTreeView::getNextNode(int n,int root,bool skipChildNodes) const {
+    if (!skipChildNodes && firstChildren[n]>=0) return firstChildren[n];
+    while (n>=0 && n!=root) {
+        if (nextSiblings[n]>=0) return nextSiblings[n];
+        n = parents[n];
+    }
+    return -1;
+}
+
+bool FlatTreeView::hasRow(int n) const {
+    const int open = StateIndex(STATE_OPEN), hidden = StateIndex(STATE_HIDDEN);
+    if (testState(hidden,n)) return false;
+    for (int p=parents[n];p>=0;p=parents[p]) {
+        if (!testState(open,p) || testState(hidden,p)) return false;
+    }
+    return true;
+}
+
+void FlatTreeView::updateRows() {
+    // Children of collapsed and hidden nodes are never visited
+    const int open = StateIndex(STATE_OPEN), hidden = StateIndex(STATE_HIDDEN);
+    rows.resize(0);
+    for (int n=firstRoot;n>=0;) {
+        if (testState(hidden,n)) {n=getNextNode(n,-1,true);continue;}
+        rows.push_back(n);
+        n=getNextNode(n,-1,!testState(open,n));
+    }
+    rowsDirty=false;
+}
+
+bool FlatTreeView::render() {
+    lastEvent.reset();
+    if (rowsDirty) updateRows();
+    if (rows.Size==0) return false;
+    ImGuiWindow* window = GetCurrentWindow();
+    if (window->SkipItems) return false;
+
+    const ImGuiContext& g = *GImGui;
+    const ImGuiStyle& style = g.Style;
+    const int open = StateIndex(STATE_OPEN), selected = StateIndex(STATE_SELECTED), checked = StateIndex(STATE_CHECKED), disabled = StateIndex(STATE_DISABLED);
+    const float lineHeight = showCheckboxes ? GetFrameHeight() : g.FontSize;
+    const float indent = GetTreeNodeToLabelSpacing();
+    const float startX = GetCursorPosX();
+    int toggledNode = -1;   // opening/closing changes the rows: done after the loop
+
+    PushID(this);
+    ImGuiListClipper clipper(rows.Size,lineHeight+style.ItemSpacing.y);
+    while (clipper.Step()) {
+        for (int r=clipper.DisplayStart;r<clipper.DisplayEnd;r++) {
+            const int n = rows[r];
+            const bool isLeaf = firstChildren[n]<0;
+            const bool isDisabled = testState(disabled,n);
+            PushID(n);
+            SetCursorPosX(startX+indent*depths[n]);
+            if (!isLeaf) {
+                const ImVec2 arrowPos = window->DC.CursorPos;
+                if (InvisibleButton("##arrow",ImVec2(indent,lineHeight))) toggledNode = n;
+                RenderArrow(window->DrawList,ImVec2(arrowPos.x+style.FramePadding.x,arrowPos.y+(lineHeight-g.FontSize)*0.5f+g.FontSize*0.15f),
+                            GetColorU32(isDisabled ? ImGuiCol_TextDisabled : ImGuiCol_Text),testState(open,n) ? ImGuiDir_Down : ImGuiDir_Right,0.70f);
+                SameLine(0,0);
+            }
+            else SetCursorPosX(startX+indent*(depths[n]+1));
+
+            if (showCheckboxes) {
+                bool isChecked = testState(checked,n);
+                if (Checkbox("##chb",&isChecked)) {
+                    setState(n,STATE_CHECKED,isChecked);
+                    if (allowAutoCheckboxBehaviour) {
+                        if (isChecked) addStateToAllDescendants(n,STATE_CHECKED);
+                        else removeStateFromAllDescendants(n,STATE_CHECKED);
+                        for (int p=parents[n];p>=0;p=parents[p]) {
+                            if (!isChecked) {removeState(p,STATE_CHECKED);continue;}
+                            bool allChecked = true;
+                            for (int c=firstChildren[p];c>=0 && allChecked;c=nextSiblings[c]) allChecked = testState(checked,c);
+                            if (!allChecked) break;
+                            addState(p,STATE_CHECKED);
+                        }
+                    }
+                    lastEvent.set(n,EVENT_STATE_CHANGED,STATE_CHECKED,!isChecked);
+                }
+                SameLine();
+            }
+
+            if (isDisabled) PushStyleColor(ImGuiCol_Text,style.Colors[ImGuiCol_TextDisabled]);
+            const bool pressed = Selectable(getDisplayName(n),testState(selected,n),ImGuiSelectableFlags_AllowDoubleClick);
+            if (isDisabled) PopStyleColor();
+            if (pressed) {
+                if (IsMouseDoubleClicked(0)) {
+                    if (!isLeaf) toggledNode = n;
+                    lastEvent.set(n,EVENT_DOUBLE_CLICKED);
+                }
+                else {
+                    // clearing the selection is a memset of the bitset
+                    if (!(g.IO.KeyCtrl && allowMultipleSelection)) removeStateFromAllNodes(STATE_SELECTED);
+                    toggleState(n,STATE_SELECTED);
+                    lastEvent.set(n,EVENT_STATE_CHANGED,STATE_SELECTED,!testState(selected,n));
+                }
+            }
+            if (nodeAfterDrawCb) nodeAfterDrawCb(*this,n,nodeAfterDrawCbUserPtr);
+            PopID();
+        }
+    }
+    PopID();
+
+    if (toggledNode>=0) {
+        toggleState(toggledNode,STATE_OPEN);
+        if (lastEvent.node<0) lastEvent.set(toggledNode,EVENT_STATE_CHANGED,STATE_OPEN,!testState(open,toggledNode));
+    }
+    return (lastEvent.node>=0);
+}
+
+#ifndef NO_IMGUIVARIOUSCONTROLS_BINARY_SERIALIZATION
+// FlatTreeView blocks: "FTOP" (options), "PRNT", "NAMO" and "UIDS" (one ImS32 per node), "TEXT" (the arena)
+// and "STAT" (number of states, words per state, then the bitsets)
+void FlatTreeView::saveBinary(ImVector<char>& out) const {
+    const ImS32 options[3] = {allowMultipleSelection ? 1 : 0,showCheckboxes ? 1 : 0,allowAutoCheckboxBehaviour ? 1 : 0};
+    TreeViewBinaryWriter w(out,TREEVIEW_BINARY_KIND_FLATTREEVIEW);
+    w.block("FTOP",options,sizeof(options));
+    w.block("PRNT",parents.Data,parents.Size*sizeof(int));
+    w.block("NAMO",nameOffsets.Data,nameOffsets.Size*sizeof(int));
+    w.block("UIDS",userIds.Data,userIds.Size*sizeof(int));
+    w.block("TEXT",text.Data,text.Size);
+    const ImU32 counts[2] = {(ImU32)STATE_COUNT,(ImU32)states[0].Size};
+    w.beginBlock("STAT");
+    w.append(counts,sizeof(counts));
+    for (int i=0;i<STATE_COUNT;i++) w.append(states[i].Data,states[i].Size*sizeof(ImU32));
+    w.endBlock();
+}
+
+bool FlatTreeView::saveBinary(const char* filename) const {
+    ImVector<char> buf;
+    saveBinary(buf);
+    return TreeViewBinarySaveToFile(buf,filename);
+}
+
+bool FlatTreeView::loadBinary(const void* data,size_t size) {
+    clear();
+    TreeViewBinaryReader r;
+    if (!r.open(data,size,TREEVIEW_BINARY_KIND_FLATTREEVIEW) || !r.read("PRNT",parents)) return false;
+    const int n = parents.Size;
+    if (!r.read("NAMO",nameOffsets,n) || !r.read("UIDS",userIds,n) || !r.read("TEXT",text) || (text.Size>0 && text.back()!='\0')) {clear();return false;}
+
+    // Parents always precede their child nodes, so one pass in index order rebuilds the other links
+    firstChildren.resize(n);lastChildren.resize(n);nextSiblings.resize(n);numChildren.resize(n);depths.resize(n);
+    for (int i=0;i<n;i++) {
+        if (parents[i]<-1 || parents[i]>=i || nameOffsets[i]<0 || nameOffsets[i]>=text.Size) {clear();return false;}
+        linkNode(i);
+    }
+
+    const int numWords = (n+31)/32;
+    for (int i=0;i<STATE_COUNT;i++) {
+        states[i].resize(numWords);
+        if (numWords>0) memset(states[i].Data,0,numWords*sizeof(ImU32));
+    }
+    const TreeViewBinaryReader::Block* b = r.find("STAT");
+    ImU32 counts[2];
+    if (b && b->size>=sizeof(counts)) {
+        memcpy(counts,b->data,sizeof(counts));
+        if (counts[0]<=32 && counts[1]==(ImU32)numWords && b->size==sizeof(counts)+(size_t)counts[0]*numWords*sizeof(ImU32)) {
+            for (int i=0;i<STATE_COUNT && i<(int)counts[0];i++) {
+                if (numWords>0) memcpy(states[i].Data,b->data+sizeof(counts)+(size_t)i*numWords*sizeof(ImU32),numWords*sizeof(ImU32));
+            }
+        }
+    }
+    // Bits past the last node belong to no node, but addNode(...) would hand them to the next nodes it adds
+    if (n&31) {
+        const ImU32 used = (1u<<(n&31))-1u;
+        for (int i=0;i<STATE_COUNT;i++) states[i][numWords-1]&=used;
+    }
+
+    ImVector<ImS32> options;
+    if (r.read("FTOP",options) && options.Size>=3) {
+        allowMultipleSelection = options[0]!=0;
+        showCheckboxes = options[1]!=0;
+        allowAutoCheckboxBehaviour = options[2]!=0;
+    }
+    rowsDirty = true;
+    return true;
+}
+
+bool FlatTreeView::loadBinary(const char* filename) {
+    size_t size = 0;
+    void* data = ImFileLoadToMemory(filename,"rb",&size);
+    if (!data) return false;
+    const bool ok = loadBinary(data,size);
+    ImGui::MemFree(data);
+    return ok;
+}
+#endif //NO_IMGUIVARIOUSCONTROLS_BINARY_SERIALIZATION
+
 // Tree view stuff ends here ==============================================================
 } // namespace ImGui
 
@@ -3593,7 +4376,124 @@ bool TimelineEvent(const char* str_id, float* values,bool keep_range_constant)
     ImGui::NextColumn();
     return changed;
 }
-void EndTimeline(int num_vertical_grid_lines,float current_time,ImU32 timeline_running_color)    {
+// Binary searches over the (sorted, not overlapping) events of a TimelineEventSource row
+static int TimelineSourceFirstEventEndingAfter(const TimelineEventSource& source,int row,int first,int last,float t)   {
+    float values[2];
+    while (first<last)  {
+        const int mid = first+(last-first)/2;
+        source.eventGetter(source.userPtr,row,mid,values);
+        if (values[1]<t) first=mid+1;
+        else last=mid;
+    }
+    return first;
+}
+static int TimelineSourceFirstEventStartingAfter(const TimelineEventSource& source,int row,int first,int last,float t)   {
+    float values[2];
+    while (first<last)  {
+        const int mid = first+(last-first)/2;
+        source.eventGetter(source.userPtr,row,mid,values);
+        if (values[0]<=t) first=mid+1;
+        else last=mid;
+    }
+    return first;
+}
+bool TimelineEvents(const TimelineEventSource& source,int* pOptionalClickedRowOut,int* pOptionalClickedEventOut)
+{
+    IM_ASSERT(s_timeline_num_rows==0 && s_timeline_display_index==-1);    // Call it once, after BeginTimeline(...) with opt_exact_num_rows=0
+    IM_ASSERT(source.numEventsGetter && source.eventGetter);
+    if (pOptionalClickedRowOut) *pOptionalClickedRowOut=-1;
+    if (pOptionalClickedEventOut) *pOptionalClickedEventOut=-1;
+    if (source.numRows<=0) return false;
+    IM_ASSERT(s_max_timeline_value>0.f);
+
+    // Row culling (same as BeginTimeline(...) with opt_exact_num_rows>0)
+    const float row_height = ImGui::GetTextLineHeightWithSpacing();
+    s_timeline_num_rows = source.numRows;
+    ImGui::CalcListClipping(s_timeline_num_rows, row_height, &s_timeline_display_start, &s_timeline_display_end);
+    ImGui::SetCursorPosY(ImGui::GetCursorPosY() + (s_timeline_display_start * row_height));
+    if (s_timeline_display_start>0) {ImGui::NextColumn();ImGui::NextColumn();}    // Same fix as in TimelineEvent(...)
+    s_timeline_display_index = s_timeline_display_end-1;
+
+    ImGuiWindow* win = GetCurrentWindow();
+    const ImU32 inactive_color = ColorConvertFloat4ToU32(GImGui->Style.Colors[ImGuiCol_Button]);
+    const ImU32 active_color = ColorConvertFloat4ToU32(GImGui->Style.Colors[ImGuiCol_ButtonHovered]);
+
+    const float s_timeline_time_offset = s_ptimeline_offset_and_scale ? s_ptimeline_offset_and_scale->x : 0.f;
+    const float s_timeline_time_scale = s_ptimeline_offset_and_scale ? s_ptimeline_offset_and_scale->y : 1.f;
+    const float columnOffset = ImGui::GetColumnOffset(1);
+    const float columnWidth = ImGui::GetColumnWidth(1)-GImGui->Style.ScrollbarSize;
+    const float columnWidthScaled = columnWidth * s_timeline_time_scale;
+    const float columnWidthOffsetScaled = columnWidthScaled * s_timeline_time_offset;
+    // x = baseX + timeToX*time (see TimelineEvent(...)): the visible time window is [minTime,maxTime]
+    const float baseX = GetWindowContentRegionMin().x + win->Pos.x + columnOffset - columnWidthOffsetScaled;
+    const float timeToX = columnWidthScaled / s_max_timeline_value;
+    const float minX = baseX + columnWidthOffsetScaled, maxX = minX + columnWidth;
+    const float minTime = (minX-baseX)/timeToX, maxTime = (maxX-baseX)/timeToX;
+    const float onePixelTime = 1.f/timeToX;
+
+    bool clicked = false;
+    for (int row = s_timeline_display_start; row < s_timeline_display_end; row++)
+    {
+        ImGui::Text("%s",source.rowNameGetter ? source.rowNameGetter(source.userPtr,row) : "");
+        ImGui::NextColumn();
+
+        const ImVec2 cursor_pos(minX,win->DC.CursorPos.y);
+        const float barMinY = cursor_pos.y+row_height*0.3f, barMaxY = barMinY+row_height*0.4f;
+        const int numEvents = columnWidth>=1.f ? source.numEventsGetter(source.userPtr,row) : 0;
+        float values[2];
+
+        // Visible events: a run of events less than a pixel apart is drawn as a single bar, so at most one bar per pixel
+        int idx = TimelineSourceFirstEventEndingAfter(source,row,0,numEvents,minTime);
+        while (idx<numEvents)   {
+            source.eventGetter(source.userPtr,row,idx,values);
+            if (values[0]>maxTime) break;
+            const float runStart = values[0];
+            float runEnd = values[1];
+            for (;;)    {
+                if (runEnd>=maxTime) {idx=numEvents;break;}   // The bar already reaches the right edge: nothing else in this row is visible
+                const int next = TimelineSourceFirstEventStartingAfter(source,row,idx+1,numEvents,runEnd+onePixelTime);
+                if (next==idx+1) {idx=next;break;}
+                source.eventGetter(source.userPtr,row,next-1,values);
+                idx = next-1;
+                if (values[1]<=runEnd) {idx=next;break;}
+                runEnd = values[1];
+            }
+            const float x0 = ImMax(baseX+timeToX*runStart,minX), x1 = ImMin(ImMax(baseX+timeToX*runEnd,x0+1.f),maxX);
+            win->DrawList->AddRectFilled(ImVec2(x0,barMinY),ImVec2(x1,barMaxY),inactive_color);
+        }
+
+        // A single item per row for hovering and clicking
+        if (columnWidth>=1.f)    {
+            SetCursorScreenPos(cursor_pos);
+            PushID(row);
+            InvisibleButton("##TimelineEventsRow",ImVec2(columnWidth,row_height));
+            const bool rowClicked = IsItemClicked();
+            if (IsItemHovered())    {
+                const float mouseTime = (GetIO().MousePos.x-baseX)/timeToX, tolerance = 2.f*onePixelTime;
+                const int hoveredIdx = TimelineSourceFirstEventEndingAfter(source,row,0,numEvents,mouseTime-tolerance);
+                if (hoveredIdx<numEvents)   {
+                    source.eventGetter(source.userPtr,row,hoveredIdx,values);
+                    if (values[0]<=mouseTime+tolerance) {
+                        const float x0 = ImMax(baseX+timeToX*values[0],minX), x1 = ImMin(ImMax(baseX+timeToX*values[1],x0+1.f),maxX);
+                        win->DrawList->AddRectFilled(ImVec2(x0,barMinY),ImVec2(x1,barMaxY),active_color);
+                        ImGui::SetTooltip("%d: [%f, %f]",hoveredIdx,values[0],values[1]);
+                        if (rowClicked) {
+                            if (pOptionalClickedRowOut) *pOptionalClickedRowOut=row;
+                            if (pOptionalClickedEventOut) *pOptionalClickedEventOut=hoveredIdx;
+                            clicked = true;
+                        }
+                    }
+                }
+            }
+            PopID();
+        }
+
+        SetCursorScreenPos(ImVec2(win->DC.CursorPos.x,cursor_pos.y + row_height));
+        ImGui::NextColumn();
+    }
+    return clicked;
+}
+void EndTimeline(int num_vertical_grid_lines,float current_time,ImU32 timeline_running_color,float max_time_scale)    {
     const float row_height = ImGui::GetTextLineHeightWithSpacing();
     if (s_timeline_num_rows>0) ImGui::SetCursorPosY(ImGui::GetCursorPosY() + ((s_timeline_num_rows - s_timeline_display_end) * row_height));
     ImGui::NextColumn();
@@ -3693,7 +4593,7 @@ void EndTimeline(int num_vertical_grid_lines,float current_time,ImU32 timeline_r
                 // zoom
                 s_ptimeline_offset_and_scale->y*=(io.MouseWheel>0) ? 1.05f : 0.95f;
                 if (s_ptimeline_offset_and_scale->y<0.25f) s_ptimeline_offset_and_scale->y=0.25f;
-                else if (s_ptimeline_offset_and_scale->y>4.f) s_ptimeline_offset_and_scale->y=4.f;
+                else if (s_ptimeline_offset_and_scale->y>max_time_scale) s_ptimeline_offset_and_scale->y=max_time_scale;
             }
         }
     }
@@ -53,7 +53,11 @@ IMGUI_API void TestProgressBar();
 // Single column popup menu without icon support. It disappears when the mouse goes away.
 // Returns -1 when no entries has been selected.
 // Optional scrollUpEntryText returns index of -2,scrollDownEntryText -3 (but they must be manually handled by the user)
-IMGUI_API int PopupMenuSimple(bool& open, const char** pEntries, int numEntries, const char* optionalTitle=NULL, int* pOptionalHoveredEntryOut=NULL, int startIndex=0, int endIndex=-1, bool reverseItems=false, const char* scrollUpEntryText=NULL, const char* scrollDownEntryText=NULL);
+// When the entries don't fit the screen, the popup scrolls and only the entries in view are submitted (ImGuiListClipper): separators are then as tall as entries.
+// scrollToEntry (optional, >=0): scrolls the popup to center this entry (in O(1): all rows have the same height).
+IMGUI_API int PopupMenuSimple(bool& open, const char** pEntries, int numEntries, const char* optionalTitle=NULL, int* pOptionalHoveredEntryOut=NULL, int startIndex=0, int endIndex=-1, bool reverseItems=false, const char* scrollUpEntryText=NULL, const char* scrollDownEntryText=NULL, int scrollToEntry=-1);
+// Separator as tall as a menu entry, for menus that clip their rows
+IMGUI_API void PopupMenuSeparatorRow();
 
 // returns -1 if nothing has been chosen, 0 if copy has been clicked, 1 if cut has been clicked and 2 if paste has been clicked
 IMGUI_API int PopupMenuSimpleCopyCutPasteOnLastItem(bool readOnly=false);
@@ -62,6 +66,7 @@ class PopupMenuSimpleParams {
 public:
     bool open;
     int getSelectedEntry() const {return selectedEntry;}    // optional (use PopupMenuSimple(...) return value)
+    void scrollToEntry(int entryIndex) {scrollToEntryIndex=entryIndex;}    // the next PopupMenuSimple(...) call moves its allowed entries to show it
 protected:
     int selectedEntry;
     int hoveredEntry;
@@ -69,9 +74,10 @@ protected:
     int startIndex;
     float scrollTimer;
     bool resetScrollingWhenRestart;
+    int scrollToEntryIndex;
 public:
     PopupMenuSimpleParams(bool _resetScrollingWhenRestart=true)
-    : open(false),selectedEntry(-1),hoveredEntry(-1),endIndex(-1),startIndex(-1),scrollTimer(ImGui::GetTime()),resetScrollingWhenRestart(_resetScrollingWhenRestart)
+    : open(false),selectedEntry(-1),hoveredEntry(-1),endIndex(-1),startIndex(-1),scrollTimer(ImGui::GetTime()),resetScrollingWhenRestart(_resetScrollingWhenRestart),scrollToEntryIndex(-1)
     {}
 friend int PopupMenuSimple(PopupMenuSimpleParams& params,const char** pTotalEntries,int numTotalEntries,int numAllowedEntries,bool reverseItems,const char* optionalTitle,const char* scrollUpEntryText,const char* scrollDownEntryText);
 };
@@ -158,6 +164,9 @@ public:
 
 mutable int selectedEntry;  // of last frame. otherwise -1
 ImVector <PopupMenuEntry> entries;  // should be protected, but maybe the user wants to modify it at runtime: in case inherit from this class
+mutable int scrollToEntryIndex;     // see scrollToEntry(...)
+
+PopupMenu() : selectedEntry(-1),scrollToEntryIndex(-1) {}
 
 void addEntryTitle(const char* text,bool addSeparator=true) {
     entries.push_back(PopupMenuEntry(text,false));
@@ -173,6 +182,9 @@ void addEntry(const char* _text,ImTextureID _user_texture_id=NULL,const ImVec2&
 // of last frame. otherwise -1
 int getSelectedEntry() const {return selectedEntry;}
 
+// The next render() scrolls the menu to center entries[entryIndex] (when the menu is taller than the screen)
+void scrollToEntry(int entryIndex) const {scrollToEntryIndex = entryIndex;}
+
 // please set "open" to "true" when starting popup.
 // When the menu closes, you have open==false and as a return value "selectedEntry"
 // The returned "selectedEntry" (and "getSelectedEntry()") are !=-1 only at the exact frame the menu entry is selected.
@@ -194,22 +206,41 @@ int render(bool& open) const    {
     //ImGui::BeginPopup(&open);
     ImGui::OpenPopup("MyOwnMenu");
     if (ImGui::BeginPopup("MyOwnMenu")) {
+        // When the entries don't fit the screen, only the ones in view are submitted: then separators are as tall as entries,
+        // so that all rows have the same height (and any entry can be scrolled to in O(1))
+        const float rowHeight = ImGui::GetTextLineHeightWithSpacing();
+        const bool clipped = numEntries*rowHeight > ImGui::GetIO().DisplaySize.y;
+        int displayStart = 0, displayEnd = numEntries;
+        ImGuiListClipper clipper;
+        if (clipped)    {
+            if (scrollToEntryIndex>=0 && scrollToEntryIndex<numEntries)
+                ImGui::SetScrollFromPosY(ImGui::GetCursorScreenPos().y - ImGui::GetWindowPos().y + (scrollToEntryIndex+0.5f)*rowHeight, 0.5f);
+            clipper.Begin(numEntries,rowHeight);
+        }
+        scrollToEntryIndex = -1;
         bool imageClicked = false;
-        for (int i = 0; i < numEntries; i++)    {
-            const PopupMenuEntry& entry = entries[i];
-            imageClicked = false;
-            if (entry.user_texture_id) {
-                imageClicked = ImGui::ImageButton((void*)entry.user_texture_id,iconSize,entry.uv0,entry.uv1,0,entry.bg_col,entry.tint_col) && entry.selectable;
-                ImGui::SameLine();
-            }
-            if (strlen(entry.text)==0) ImGui::Separator();
-            else if (entry.selectable)  {
-                if (ImGui::Selectable(entry.text, false) || imageClicked)  {
-                    selectedEntry = i;
-                    open = false;    // Hide menu
+        while (!clipped || clipper.Step())  {
+            if (clipped) {displayStart = clipper.DisplayStart;displayEnd = clipper.DisplayEnd;}
+            for (int i = displayStart; i < displayEnd; i++)    {
+                const PopupMenuEntry& entry = entries[i];
+                imageClicked = false;
+                if (entry.user_texture_id) {
+                    imageClicked = ImGui::ImageButton((void*)entry.user_texture_id,iconSize,entry.uv0,entry.uv1,0,entry.bg_col,entry.tint_col) && entry.selectable;
+                    ImGui::SameLine();
+                }
+                if (entry.text[0]=='\0') {
+                    if (clipped) PopupMenuSeparatorRow();
+                    else ImGui::Separator();
+                }
+                else if (entry.selectable)  {
+                    if (ImGui::Selectable(entry.text, false) || imageClicked)  {
+                        selectedEntry = i;
+                        open = false;    // Hide menu
+                    }
                 }
+                else ImGui::Text("%s",entry.text);
             }
-            else ImGui::Text("%s",entry.text);
+            if (!clipped) break;
         }
         if (open)   // close menu when mouse goes away
         {
@@ -347,6 +378,46 @@ IMGUI_API bool ImageZoomAndPan(ImTextureID user_texture_id, const ImVec2& size,f
 // Return value rv can be: -1 => No button is hovered or clicked | [0,numButtons-1] => buttons[rv] has been clicked | [numButtons,2*numButtons-1] => buttons[rv-numButtons] is hovered
 IMGUI_API int AppendTreeNodeHeaderButtons(const void* ptr_id, float startWindowCursorXForClipping, int numButtons, ...);
 
+// Multi-resolution min/max cache for long sample histories (e.g. a day of per-second values), used by the
+// PlotHistogram(...), PlotMultiLines(...) and PlotMultiHistograms(...) overloads below.
+// Next to the raw samples it keeps a pyramid of (min,max) pairs over blocks of 2,4,8... samples. append() updates
+// only the blocks the new sample completes (O(1) amortized), and getMinMax(...) of any sample range reads at most
+// 2 blocks per level (O(log n)). So the plot overloads ask it one (min,max) pair per pixel column, and their cost
+// is bounded by the graph width instead of by the number of samples.
+class PlotLodCache {
+public:
+    PlotLodCache(int _numSeries=1);
+    ~PlotLodCache();
+
+    void clear();                       // removes all samples (and keeps the number of series)
+    void setNumSeries(int _numSeries);  // clears too
+    inline int getNumSeries() const {return series.size();}
+    inline int getNumSamples() const {return numSamples;}
+
+    // Appends one sample to every series ('values' must have getNumSeries() elements)
+    void append(const float* values);
+    inline void append(float value) {IM_ASSERT(series.size()==1);append(&value);}
+    // Appends the samples of 'getter' from getNumSamples() to values_count-1 (when values_count<getNumSamples() the cache is rebuilt).
+    // Returns the number of samples added.
+    int update(float (*getter)(const void* data,int idx,int seriesIdx),const void* data,int values_count);
+
+    inline float getValue(int seriesIdx,int idx) const {IM_ASSERT(idx>=0 && idx<numSamples);return series[seriesIdx]->values[idx];}
+    // Min and max of the samples in [first,last) (FLT_MAX and -FLT_MAX when the range is empty)
+    void getMinMax(int seriesIdx,int first,int last,float& vmin,float& vmax) const;
+
+protected:
+    enum {MAX_LEVELS = 30};
+    struct Series {
+        ImVector<float> values;
+        ImVector<float> mins[MAX_LEVELS],maxs[MAX_LEVELS];    // level l: blocks of 2<<l samples (complete blocks only)
+    };
+    ImVector<Series*> series;
+    int numSamples;
+
+    PlotLodCache(const PlotLodCache&) {}
+    void operator=(const PlotLodCache&) {}
+};
+
 // Returns the hovered value index WITH 'values_offset' ( (hovered_index+values_offset)%values_offset or -1). The index of the hovered histogram can be retrieved through 'pOptionalHoveredHistogramIndexOut'.
 IMGUI_API int PlotHistogram(const char* label, const float** values,int num_histograms,int values_count, int values_offset = 0, const char* overlay_text = NULL, float scale_min = FLT_MAX, float scale_max = FLT_MAX, ImVec2 graph_size = ImVec2(0,0), int stride = sizeof(float),float histogramGroupSpacingInPixels=0.f,int* pOptionalHoveredHistogramIndexOut=NULL,float fillColorGradientDeltaIn0_05=0.05f,const ImU32* pColorsOverride=NULL,int numColorsOverride=0);
 IMGUI_API int PlotHistogram(const char* label, float (*values_getter)(void* data, int idx,int histogramIdx), void* data,int num_histograms, int values_count, int values_offset = 0, const char* overlay_text = NULL, float scale_min = FLT_MAX, float scale_max = FLT_MAX, ImVec2 graph_size = ImVec2(0,0),float histogramGroupSpacingInPixels=0.f,int* pOptionalHoveredHistogramIndexOut=NULL,float fillColorGradientDeltaIn0_05=0.05f,const ImU32* pColorsOverride=NULL,int numColorsOverride=0);
@@ -387,6 +458,14 @@ IMGUI_API void PlotMultiHistograms(
     float scale_max,
     ImVec2 graph_size);
 
+// PlotLodCache overloads: they draw the samples in [first_sample,first_sample+num_samples) of all the series of 'cache'
+// ('num_samples'<0 => up to the last sample). Every pixel column shows the min/max envelope of the samples it covers
+// (histogram bars show the value farthest from zero), so that spikes don't disappear when there are more samples than pixels.
+// The returned hovered index is the first sample of the hovered bar.
+IMGUI_API int PlotHistogram(const char* label, const PlotLodCache& cache, int first_sample = 0, int num_samples = -1, const char* overlay_text = NULL, float scale_min = FLT_MAX, float scale_max = FLT_MAX, ImVec2 graph_size = ImVec2(0,0),float histogramGroupSpacingInPixels=0.f,int* pOptionalHoveredHistogramIndexOut=NULL,float fillColorGradientDeltaIn0_05=0.05f,const ImU32* pColorsOverride=NULL,int numColorsOverride=0);
+IMGUI_API void PlotMultiLines(const char* label, const char** names, const ImColor* colors, const PlotLodCache& cache, int first_sample = 0, int num_samples = -1, float scale_min = FLT_MAX, float scale_max = FLT_MAX, ImVec2 graph_size = ImVec2(0,0));
+IMGUI_API void PlotMultiHistograms(const char* label, const char** names, const ImColor* colors, const PlotLodCache& cache, int first_sample = 0, int num_samples = -1, float scale_min = FLT_MAX, float scale_max = FLT_MAX, ImVec2 graph_size = ImVec2(0,0));
+
 
 class InputTextWithAutoCompletionData  {
     protected:
@@ -415,7 +494,9 @@ class InputTextWithAutoCompletionData  {
     friend int DefaultInputTextAutoCompletionCallback(ImGuiTextEditCallbackData *data);
 
     // Some useful helper methods
+    // Items must be sorted by strcmp(...) (HelperInsertItem(...) keeps them so): these are binary searches through items_getter, O(log(items_count)).
     IMGUI_API static int HelperGetItemInsertionPosition(const char* txt,bool (*items_getter)(void*, int, const char**), int items_count, void* user_data=NULL,bool* item_is_already_present_out=NULL);
+    IMGUI_API static int HelperGetItemPrefixRange(const char* prefix,bool (*items_getter)(void*, int, const char**), int items_count, void* user_data=NULL,int* range_end_out=NULL);   // items starting with prefix are [return value,*range_end_out); -1 if prefix is empty
     IMGUI_API static int HelperInsertItem(const char* txt,bool (*items_getter)(void*, int, const char**),bool (*items_inserter)(void*, int,const char*), int items_count, void* user_data=NULL,bool* item_is_already_present_out=NULL);
 };
 IMGUI_API bool InputTextWithAutoCompletion(const char* label, char* buf, size_t buf_size, InputTextWithAutoCompletionData* pAutocompletion_data, bool (*autocompletion_items_getter)(void*, int, const char**), int autocompletion_items_size, void* autocompletion_user_data=NULL, int num_visible_autocompletion_items=-1);
@@ -792,6 +873,17 @@ public:
         IMGUI_API static bool Load(const char* filename,TreeView** pTreeViews,int numTreeviews);
 #       endif //NO_IMGUIHELPER_SERIALIZATION_LOAD
 #       endif //NO_IMGUIHELPER_SERIALIZATION
+#       ifndef NO_IMGUIVARIOUSCONTROLS_BINARY_SERIALIZATION
+public:
+        // Versioned binary format (no ImGuiHelper needed): length-prefixed blocks, with fixed-size node records
+        // pointing into a single text block. loadBinary(data,size) checks and decodes "data" in place (e.g. a memory-mapped
+        // file), but still builds every node and duplicates its strings up front: nodes own their strings, so the load
+        // is O(nodes) allocations. For big trees that must load fast, use FlatTreeView.
+        IMGUI_API void saveBinary(ImVector<char>& out) const;
+        IMGUI_API bool saveBinary(const char* filename) const;
+        IMGUI_API bool loadBinary(const void* data,size_t size);
+        IMGUI_API bool loadBinary(const char* filename);
+#       endif //NO_IMGUIVARIOUSCONTROLS_BINARY_SERIALIZATION
 //--------------------------------------------------------------------------------
 
     IMGUI_API static void SetFontCheckBoxGlyphs(const char* emptyState,const char* fillState);
@@ -846,6 +938,129 @@ typedef TreeViewNode::State TreeViewNodeState;
 typedef TreeViewNode::Mode TreeViewNodeMode;
 typedef TreeViewNode::Event TreeViewEvent;
 
+// Flat tree view for big hierarchies (e.g. 100k+ leaf nodes)
+// Nodes are not heap-allocated one by one like TreeViewNodes: a node is an index into a few parallel arrays
+// (parent, first/last child and next sibling links), all display names live in a single text arena, and every
+// state is a bitset with one bit per node (so e.g. clearing the selection of the whole tree is a memset).
+// The rows of the expanded tree are cached in a list that is rebuilt (walking only the open part of the tree)
+// after a node is added, opened, closed or hidden; render() submits only the rows inside the clipping rect.
+// Node indices stay valid until clear(): single nodes can't be deleted (use STATE_HIDDEN instead).
+class FlatTreeView {
+public:
+    enum State {
+        STATE_NONE      = 0,
+        STATE_OPEN      = 1,
+        STATE_SELECTED  = 1<<1,
+        STATE_CHECKED   = 1<<2,
+        STATE_DISABLED  = 1<<3,     // look only (the node can still be selected)
+        STATE_HIDDEN    = 1<<4,     // node (and its child nodes) not visible at all
+
+        // user states (without any specific look)
+        STATE_USER1     = 1<<5,
+        STATE_USER2     = 1<<6,
+        STATE_USER3     = 1<<7
+    };
+    enum {STATE_COUNT = 8};
+
+    enum EventType {
+        EVENT_NONE = 0,
+        EVENT_STATE_CHANGED,
+        EVENT_DOUBLE_CLICKED
+    };
+    struct Event {
+        int node;   // -1 when there's no event
+        EventType type;
+        State state;bool wasStateRemoved;
+        Event() {set();}
+        inline void reset() {set();}
+        inline void set(int _node=-1,EventType _type=EVENT_NONE,State _state=STATE_NONE,bool _wasStateRemoved=false)    {node=_node;type=_type;state=_state;wasStateRemoved=_wasStateRemoved;}
+    };
+
+    IMGUI_API FlatTreeView(bool _allowMultipleSelection=false,bool _showCheckboxes=false);
+    IMGUI_API bool render();  // Main method. Returns true when "lastEvent" contains a node that's changed in some way (e.g. double-clicked or basic state changed)
+    inline const Event& getLastEvent() const {return lastEvent;}
+
+    IMGUI_API void clear();
+    IMGUI_API void reserve(int numNodes,int numTextBytes=0);
+
+    // Returns the index of the new node, appended as the last child of parentNode (-1 = root node)
+    IMGUI_API int addNode(const char* displayName,int parentNode=-1,int userId=0);
+
+    inline int getNumNodes() const {return parents.Size;}
+    inline int getFirstRootNode() const {return firstRoot;}
+    inline int getParentNode(int n) const {return parents[n];}
+    inline int getFirstChildNode(int n) const {return firstChildren[n];}
+    inline int getNextSiblingNode(int n) const {return nextSiblings[n];}
+    inline int getNumChildNodes(int n) const {return numChildren[n];}
+    inline bool isLeafNode(int n) const {return firstChildren[n]<0;}
+    inline bool isRootNode(int n) const {return parents[n]<0;}
+    inline int getDepth(int n) const {return depths[n];}   // root nodes have depth = 0
+
+    inline const char* getDisplayName(int n) const {return &text[nameOffsets[n]];}
+    IMGUI_API void setDisplayName(int n,const char* displayName);    // the old name stays in the arena until clear()
+    inline int getUserId(int n) const {return userIds[n];}
+    inline void setUserId(int n,int uid) {userIds[n]=uid;}
+
+    // stateFlags can contain more than one flag: isStatePresent(...) returns true only if all of them are present
+    inline void addState(int n,int stateFlags) {setState(n,stateFlags,true);}
+    inline void removeState(int n,int stateFlags) {setState(n,stateFlags,false);}
+    inline void toggleState(int n,int stateFlag) {if (isStatePresent(n,stateFlag)) removeState(n,stateFlag);else addState(n,stateFlag);}
+    IMGUI_API bool isStatePresent(int n,int stateFlags) const;
+    inline bool isStateMissing(int n,int stateFlags) const {return !isStatePresent(n,stateFlags);}
+
+    IMGUI_API void addStateToAllNodes(int stateFlags);
+    IMGUI_API void removeStateFromAllNodes(int stateFlags);
+    IMGUI_API void addStateToAllDescendants(int n,int stateFlags);         // n excluded
+    IMGUI_API void removeStateFromAllDescendants(int n,int stateFlags);    // n excluded
+    IMGUI_API void getAllNodesWithState(ImVector<int>& result,int stateFlag,bool clearResultBeforeUsage=true) const;
+    IMGUI_API void openAllParentNodes(int n);  // so that n gets a row (unless hidden)
+
+    // Rows of the expanded tree (the list is rebuilt here if needed)
+    IMGUI_API int getNumVisibleRows();
+    IMGUI_API int getVisibleRowNode(int row);
+
+    // Called just after the row of a node is drawn (e.g. to display a tooltip)
+    typedef void (*NodeCallback)(FlatTreeView& tree,int node,void* userPtr);
+    void setNodeAfterDrawCb(NodeCallback cb,void* userPtr=NULL) {nodeAfterDrawCb = cb;nodeAfterDrawCbUserPtr = userPtr;}
+
+#   ifndef NO_IMGUIVARIOUSCONTROLS_BINARY_SERIALIZATION
+    // Same binary format as TreeView::saveBinary(...): every per-node array is one block, copied as is,
+    // and only the parent links are stored (the child/sibling links are rebuilt in a single pass on load).
+    // On failure loadBinary(...) leaves the tree empty.
+    IMGUI_API void saveBinary(ImVector<char>& out) const;
+    IMGUI_API bool saveBinary(const char* filename) const;
+    IMGUI_API bool loadBinary(const void* data,size_t size);
+    IMGUI_API bool loadBinary(const char* filename);
+#   endif //NO_IMGUIVARIOUSCONTROLS_BINARY_SERIALIZATION
+
+    bool allowMultipleSelection;
+    bool showCheckboxes;
+    bool allowAutoCheckboxBehaviour;
+    void *userPtr;                  // user stuff, not mine
+
+protected:
+    static inline int StateIndex(int stateFlag) {int i=0;while (stateFlag>1) {stateFlag>>=1;++i;}return i;}
+    inline bool testState(int stateIndex,int n) const {return (states[stateIndex][n>>5]&(1u<<(n&31)))!=0;}
+    IMGUI_API void setState(int n,int stateFlags,bool add);
+    IMGUI_API int getNextNode(int n,int root=-1,bool skipChildNodes=false) const;   // pre-order, stays inside root's subtree
+    IMGUI_API void linkNode(int n);   // links n (whose parent is parents[n]) as the last child of its parent
+    IMGUI_API bool hasRow(int n) const;
+    IMGUI_API void updateRows();
+
+    ImVector<int> parents,firstChildren,lastChildren,nextSiblings,numChildren,depths,nameOffsets,userIds;
+    ImVector<char> text;
+    ImVector<ImU32> states[STATE_COUNT];
+    int firstRoot,lastRoot;
+
+    ImVector<int> rows;
+    bool rowsDirty;
+
+    Event lastEvent;
+    NodeCallback nodeAfterDrawCb;
+    void* nodeAfterDrawCbUserPtr;
+};
+typedef FlatTreeView::Event FlatTreeViewEvent;
+
 // Timeline (from: https://github.com/nem0/LumixEngine/blob/timeline_gui/external/imgui/imgui_user.h)=
 /* Possible enhancements:
  * Add some kind of "snap to grid" epsilon
@@ -855,7 +1070,25 @@ typedef TreeViewNode::Event TreeViewEvent;
 // popt_offset_and_scale: optional reference to a static ImVec2 (CTRL+RMB drag: pan in [0.f,1.f]; CTRL+MW: zoom in [0.25f,4.f]). Thanks @meshula!
 IMGUI_API bool BeginTimeline(const char* str_id, float max_value=0.f, int num_visible_rows=0, int opt_exact_num_rows=0,ImVec2* popt_offset_and_scale=NULL);
 IMGUI_API bool TimelineEvent(const char* str_id, float* values, bool keep_range_constant=false);
-IMGUI_API void EndTimeline(int num_vertical_grid_lines=5.f,float current_time=0.f,ImU32 timeline_running_color=IM_COL32(0,128,0,200));
+// max_time_scale: upper bound of the CTRL+MW zoom (when popt_offset_and_scale is used). Raise it to zoom into long histories.
+IMGUI_API void EndTimeline(int num_vertical_grid_lines=5.f,float current_time=0.f,ImU32 timeline_running_color=IM_COL32(0,128,0,200),float max_time_scale=4.f);
+
+// Read-only event source for TimelineEvents(...): 'numRows' rows, each one with a name and a list of [start,end] ranges in [0,max_value].
+// The ranges of a row must be sorted by time and must not overlap (so both their starts and their ends are sorted), e.g. the sessions of a long history.
+struct TimelineEventSource {
+    int numRows;
+    const char* (*rowNameGetter)(void* userPtr,int row);
+    int (*numEventsGetter)(void* userPtr,int row);
+    void (*eventGetter)(void* userPtr,int row,int idx,float* values);    // values[0]: start, values[1]: end
+    void* userPtr;
+    TimelineEventSource(int _numRows=0,const char* (*_rowNameGetter)(void*,int)=NULL,int (*_numEventsGetter)(void*,int)=NULL,void (*_eventGetter)(void*,int,int,float*)=NULL,void* _userPtr=NULL)
+        : numRows(_numRows),rowNameGetter(_rowNameGetter),numEventsGetter(_numEventsGetter),eventGetter(_eventGetter),userPtr(_userPtr) {}
+};
+// Draws all the rows of 'source' between BeginTimeline(...) (with opt_exact_num_rows=0) and EndTimeline(...), instead of calling TimelineEvent(...) per event.
+// Only the rows in view are visited. In each of them, the events inside the visible time window are found by binary search, and events closer than a pixel
+// are merged into a single bar: so the cost per frame depends on the size of the child window, not on the number of events or on the zoom.
+// Returns true when an event is clicked (its row and index go to pOptionalClickedRowOut and pOptionalClickedEventOut).
+IMGUI_API bool TimelineEvents(const TimelineEventSource& source,int* pOptionalClickedRowOut=NULL,int* pOptionalClickedEventOut=NULL);
 // End Timeline ======================================================================================
 
 
@@ -0,0 +1,153 @@
+#include "LaunchLogParser.h"
+
+#include <ctime>
+
+namespace
+{
+	constexpr std::string_view kLogOpenPrefix = "Log: Log file open, ";
+
+	// Reads exactly `digits` decimal digits at `pos`.
+	bool ReadDigits(std::string_view s, size_t pos, size_t digits, int& out)
+	{
+		if (pos + digits > s.size())
+			return false;
+		out = 0;
+		for (size_t i = pos; i < pos + digits; ++i)
+		{
+			if (s[i] < '0' || s[i] > '9')
+				return false;
+			out = out * 10 + (s[i] - '0');
+		}
+		return true;
+	}
+
+	// "10/19/26 14:30:05" in local time -> unix ms, 0 if malformed.
+	uint64_t ParseLogOpenTime(std::string_view s)
+	{
+		int month, day, year, hour, minute, second;
+		if (!ReadDigits(s, 0, 2, month) || s.size() < 17 || s[2] != '/' || !ReadDigits(s, 3, 2, day) || s[5] != '/'
+			|| !ReadDigits(s, 6, 2, year) || s[8] != ' ' || !ReadDigits(s, 9, 2, hour) || s[11] != ':'
+			|| !ReadDigits(s, 12, 2, minute) || s[14] != ':' || !ReadDigits(s, 15, 2, second))
+			return 0;
+
+		std::tm tm{};
+		tm.tm_year = 100 + year;
+		tm.tm_mon = month - 1;
+		tm.tm_mday = day;
+		tm.tm_hour = hour;
+		tm.tm_min = minute;
+		tm.tm_sec = second;
+		tm.tm_isdst = -1;
+		std::time_t t = std::mktime(&tm);
+		return t == (std::time_t)-1 || t < 0 ? 0 : (uint64_t)t * 1000;
+	}
+
+	// "[0012.48] ..." -> 12480; false without the prefix.
+	bool ParseLineSeconds(std::string_view line, uint64_t& outMs)
+	{
+		if (line.empty() || line[0] != '[')
+			return false;
+		uint64_t ms = 0;
+		size_t i = 1;
+		for (; i < line.size() && i < 16 && line[i] >= '0' && line[i] <= '9'; ++i)
+			ms = ms * 10 + (uint64_t)(line[i] - '0');
+		if (i == 1)
+			return false;
+		ms *= 1000;
+		if (i < line.size() && line[i] == '.')
+		{
+			uint64_t scale = 100;
+			for (++i; i < line.size() && line[i] >= '0' && line[i] <= '9'; ++i, scale /= 10)
+				ms += (uint64_t)(line[i] - '0') * scale;
+		}
+		if (i >= line.size() || line[i] != ']')
+			return false;
+		outMs = ms;
+		return true;
+	}
+}
+
+void LaunchLogState::Clear()
+{
+	serverName.clear();
+	gameUrl.clear();
+	logOpenMs = 0;
+	for (auto& value : extras)
+		value.clear();
+}
+
+std::string MakeEndpointLabel(const std::string& serverName, const std::string& gameUrl)
+{
+	if (serverName.empty())
+		return gameUrl;
+
+	std::string label;
+	label.reserve(serverName.size() + gameUrl.size() + 3);
+	label += serverName;
+	label += " (";
+	label += gameUrl;
+	label += ')';
+	return label;
+}
+
+LaunchLogParser::LaunchLogParser(const ExtractionEngine& engine, uint64_t generation)
+	: engine(engine)
+	, generation(generation)
+	, serverField(engine.FindField("ServerName"))
+	, gameUrlField(engine.FindField("GameURL"))
+{
+}
+
+bool LaunchLogParser::Feed(std::string_view line, LaunchLogState& state, const std::string& source, std::vector<EndpointRecord>& out)
+{
+	// Sticky extra fields are indexed by the engine's field numbers.
+	if (state.generation != generation || state.extras.size() != engine.FieldCount())
+	{
+		state.extras.assign(engine.FieldCount(), std::string());
+		state.generation = generation;
+	}
+
+	// The open line heads the file and carries no "[seconds]" prefix.
+	if (line.size() > kLogOpenPrefix.size() && line[0] == 'L' && line.compare(0, kLogOpenPrefix.size(), kLogOpenPrefix) == 0)
+		state.logOpenMs = ParseLogOpenTime(line.substr(kLogOpenPrefix.size()));
+
+	// One automaton pass yields every configured field.
+	engine.ExtractLine(line, values);
+
+	for (uint32_t f : values.found)
+	{
+		std::string_view value = values.values[f];
+		if (value.empty())
+			continue;
+		if ((int)f == serverField)
+			state.serverName.assign(value);
+		else if ((int)f == gameUrlField)
+			state.gameUrl.assign(value);
+		else
+			state.extras[f].assign(value);
+	}
+
+	// When we have a GameURL, we can log an endpoint.
+	if (state.gameUrl.empty())
+		return false;
+
+	// GameURL expected like "ip:port" or maybe with additional query params; keep it raw.
+	EndpointRecord ep;
+	ep.label = MakeEndpointLabel(state.serverName, state.gameUrl);
+	ep.serverName = state.serverName;
+	ep.gameUrl = state.gameUrl;
+	ep.source = source;
+	ep.display = ep.label;
+	uint64_t lineMs;
+	ep.firstSeenMs = state.logOpenMs != 0 && ParseLineSeconds(line, lineMs) ? state.logOpenMs + lineMs : 0;
+	ep.lastSeenMs = ep.firstSeenMs;
+	ep.seenCount = 1;
+	for (size_t f = 0; f < state.extras.size(); ++f)
+		if (!state.extras[f].empty())
+			ep.fields.emplace_back(engine.FieldName(f), state.extras[f]);
+	out.push_back(std::move(ep));
+
+	// Reset gameUrl so a single line doesn't repeatedly add.
+	state.gameUrl.clear();
+	return true;
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+// Turns Launch.log lines into endpoint records.
+//
+// A ServerName line and the GameURL line that follows it form one endpoint,
+// so pairing state lives in LaunchLogState and is carried across lines,
+// polls and (via the handoff file) plugin reloads. So does the time the log
+// was opened ("Log: Log file open, 10/19/26 14:30:05", local time), which
+// turns the "[0012.48]" seconds prefix of later lines into the sighting
+// time. The parser itself only holds the compiled rules and scratch space,
+// so one parser per thread can feed any number of states.
+//
+// This, ExtractionRules, EndpointRecord, LogTail and MappedFile are the
+// plugin's portable core; the headless scanner builds from the same files.
+//
+// Portable, no SDK dependencies.
+
+#include "EndpointRecord.h"
+#include "ExtractionRules.h"
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_set>
+#include <vector>
+
+struct LaunchLogState
+{
+	std::string serverName;          // sticky until the next ServerName
+	std::string gameUrl;             // cleared once an endpoint is emitted
+	std::vector<std::string> extras; // other rule fields, by engine field index
+	uint64_t generation = 0;         // rules generation `extras` is indexed by
+	uint64_t logOpenMs = 0;          // unix ms of the "Log file open" line; 0 until seen
+
+	// Forget pairing state, e.g. when the log was recreated.
+	void Clear();
+};
+
+// "ServerName (ip:port)", or just "ip:port" without a name. Also the dedup key.
+std::string MakeEndpointLabel(const std::string& serverName, const std::string& gameUrl);
+
+class LaunchLogParser
+{
+public:
+	// `generation` identifies this rule set; states parsed under another one
+	// have their extras re-indexed (cleared) on first use.
+	LaunchLogParser(const ExtractionEngine& engine, uint64_t generation = 1);
+
+	// Feeds one line (without its line break). Appends a record to `out` when
+	// the line completes an endpoint; returns true if it did. The record is
+	// timed from the line when the log's open time is known, else its times
+	// are 0 and the caller picks a fallback.
+	bool Feed(std::string_view line, LaunchLogState& state, const std::string& source, std::vector<EndpointRecord>& out);
+
+	const ExtractionEngine& Engine() const { return engine; }
+
+private:
+	const ExtractionEngine& engine;
+	uint64_t generation;
+	int serverField;
+	int gameUrlField;
+	ExtractedFields values;
+};
+
+// Keeps the first record per label, as the plugin's list does.
+class EndpointDeduplicator
+{
+public:
+	// True the first time a label is seen.
+	bool Accept(const EndpointRecord& record) { return labels.insert(record.label).second; }
+	void Clear() { labels.clear(); }
+	size_t Size() const { return labels.size(); }
+
+private:
+	std::unordered_set<std::string> labels;
+};
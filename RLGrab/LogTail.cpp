@@ -0,0 +1,112 @@
+#include "LogTail.h"
+
+#include <algorithm>
+#include <fstream>
+#include <vector>
+
+namespace
+{
+	constexpr size_t kHeadSignatureBytes = 128;
+	// Small enough that the deadline is checked every few hundred microseconds.
+	constexpr size_t kReadChunkBytes = 64 << 10;
+}
+
+void LogTail::Reset()
+{
+	offset = 0;
+	head.clear();
+}
+
+LogTail::PollResult LogTail::Poll(
+	const std::function<void(const std::string&)>& onLine,
+	const std::function<void()>& onRestart,
+	const LogTailLimits& limits)
+{
+	PollResult result;
+
+	std::ifstream file(path, std::ios::in | std::ios::binary);
+	if (!file.is_open())
+		return result;
+	result.opened = true;
+
+	file.seekg(0, std::ios::end);
+	uint64_t size = (uint64_t)file.tellg();
+
+	// Detect truncation or a recreated file before trusting the old offset.
+	std::string currentHead;
+	currentHead.resize((size_t)std::min<uint64_t>(size, kHeadSignatureBytes));
+	file.seekg(0, std::ios::beg);
+	file.read(currentHead.data(), (std::streamsize)currentHead.size());
+
+	bool headChanged = !head.empty() && currentHead.compare(0, head.size(), head) != 0;
+	if (size < offset || headChanged)
+	{
+		Reset();
+		result.restarted = true;
+		if (onRestart)
+			onRestart();
+	}
+	if (head.size() < currentHead.size() && offset == 0)
+		head = currentHead;
+
+	if (size == offset)
+		return result;
+
+	file.clear();
+	file.seekg((std::streamoff)offset, std::ios::beg);
+
+	std::vector<char> chunk(kReadChunkBytes);
+	std::string line;
+	uint64_t consumed = offset;
+	uint64_t lineStart = offset;
+	bool budgetSpent = false;
+
+	while (file && !budgetSpent)
+	{
+		file.read(chunk.data(), (std::streamsize)chunk.size());
+		size_t got = (size_t)file.gcount();
+		if (got == 0)
+			break;
+
+		size_t start = 0;
+		for (size_t i = 0; i < got; ++i)
+		{
+			if (chunk[i] != '\n')
+				continue;
+
+			line.append(chunk.data() + start, i - start);
+			if (!line.empty() && line.back() == '\r')
+				line.pop_back();
+			lineEnd = consumed + i + 1;
+			onLine(line);
+			line.clear();
+			result.lines++;
+
+			lineStart = consumed + i + 1;
+			start = i + 1;
+
+			if (lineStart - offset >= limits.maxBytes)
+			{
+				budgetSpent = true;
+				break;
+			}
+		}
+		if (budgetSpent)
+			break;
+
+		line.append(chunk.data() + start, got - start);
+		consumed += got;
+
+		if (result.lines > 0 && std::chrono::steady_clock::now() >= limits.deadline)
+		{
+			budgetSpent = true;
+			break;
+		}
+	}
+
+	result.bytes = lineStart - offset;
+	offset = lineStart;
+	result.remaining = size > offset ? size - offset : 0;
+	result.more = budgetSpent && result.remaining > 0;
+	return result;
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+// Incremental reader for a log file that is only ever appended to (or
+// recreated from scratch, which is what Rocket League does with Launch.log
+// on every launch).
+//
+// Keeps the byte offset of the last complete line and a small signature of
+// the file head. If the file shrinks or its head changes, the tail restarts
+// from offset 0 and reports it so callers can drop per-file parser state.
+//
+// Portable, no SDK dependencies.
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <string>
+
+// Per-call budget so a large backlog is consumed in slices. The tail stops
+// at the first line boundary past either limit; at least one line is always
+// delivered so progress is guaranteed.
+struct LogTailLimits
+{
+	uint64_t maxBytes = UINT64_MAX;
+	std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::time_point::max();
+};
+
+class LogTail
+{
+public:
+	struct PollResult
+	{
+		bool     opened = false;    // file exists and could be read
+		bool     restarted = false; // file was truncated or recreated since the last poll
+		uint64_t bytes = 0;         // bytes consumed by this poll
+		uint64_t lines = 0;         // complete lines delivered
+		uint64_t remaining = 0;     // bytes still unread after this poll (backlog)
+		bool     more = false;      // stopped on a limit; call again to continue
+	};
+
+	LogTail() = default;
+	explicit LogTail(std::string path) : path(std::move(path)) {}
+
+	const std::string& Path() const { return path; }
+	uint64_t Offset() const { return offset; }
+
+	// Inside onLine: file offset just past the line being delivered.
+	uint64_t LineEnd() const { return lineEnd; }
+
+	// Delivers every complete line appended since the previous call. A
+	// trailing partial line is held back until its newline arrives.
+	// onRestart runs before any line when the file was truncated/recreated.
+	PollResult Poll(
+		const std::function<void(const std::string&)>& onLine,
+		const std::function<void()>& onRestart = nullptr,
+		const LogTailLimits& limits = LogTailLimits());
+
+	// Forget everything; the next Poll() starts from the beginning.
+	void Reset();
+
+	// Cursor and head signature, so another instance can continue the tail.
+	const std::string& HeadSignature() const { return head; }
+	void Restore(uint64_t restoredOffset, std::string restoredHead)
+	{
+		offset = restoredOffset;
+		head = std::move(restoredHead);
+	}
+
+private:
+	std::string path;
+	uint64_t    offset = 0;  // end of the last complete line
+	uint64_t    lineEnd = 0; // end of the line onLine is looking at
+	std::string head;        // first bytes of the file when offset was 0
+};
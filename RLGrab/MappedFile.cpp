@@ -0,0 +1,143 @@
+#include "MappedFile.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <Windows.h>
+#include <filesystem>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+#endif
+
+MappedFile::~MappedFile()
+{
+	Close();
+}
+
+#ifdef _WIN32
+
+bool MappedFile::Open(const std::string& path, std::string* error)
+{
+	Close();
+
+	// Same narrow-to-wide conversion as the std::filesystem paths the
+	// callers got these strings from; a byte-per-wchar copy garbles non-ASCII.
+	std::wstring wpath = std::filesystem::path(path).wstring();
+	HANDLE f = CreateFileW(wpath.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+		nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+	if (f == INVALID_HANDLE_VALUE)
+	{
+		if (error)
+			*error = "cannot open " + path + " (error " + std::to_string(GetLastError()) + ")";
+		return false;
+	}
+
+	LARGE_INTEGER size;
+	if (!GetFileSizeEx(f, &size))
+	{
+		if (error)
+			*error = "cannot stat " + path;
+		CloseHandle(f);
+		return false;
+	}
+
+	if (size.QuadPart == 0)
+	{
+		file = f;
+		opened = true;
+		return true;
+	}
+
+	HANDLE m = CreateFileMappingW(f, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	void* v = m ? MapViewOfFile(m, FILE_MAP_READ, 0, 0, 0) : nullptr;
+	if (!v)
+	{
+		if (error)
+			*error = "cannot map " + path + " (error " + std::to_string(GetLastError()) + ")";
+		if (m)
+			CloseHandle(m);
+		CloseHandle(f);
+		return false;
+	}
+
+	file = f;
+	mapping = m;
+	view = static_cast<const uint8_t*>(v);
+	length = (size_t)size.QuadPart;
+	opened = true;
+	return true;
+}
+
+void MappedFile::Close()
+{
+	if (view)
+		UnmapViewOfFile(view);
+	if (mapping)
+		CloseHandle(static_cast<HANDLE>(mapping));
+	if (file)
+		CloseHandle(static_cast<HANDLE>(file));
+	view = nullptr;
+	mapping = nullptr;
+	file = nullptr;
+	length = 0;
+	opened = false;
+}
+
+#else
+
+bool MappedFile::Open(const std::string& path, std::string* error)
+{
+	Close();
+
+	int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+	if (fd < 0)
+	{
+		if (error)
+			*error = "cannot open " + path + ": " + std::strerror(errno);
+		return false;
+	}
+
+	struct stat st;
+	if (fstat(fd, &st) != 0)
+	{
+		if (error)
+			*error = "cannot stat " + path + ": " + std::strerror(errno);
+		close(fd);
+		return false;
+	}
+
+	if (st.st_size > 0)
+	{
+		void* v = mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+		if (v == MAP_FAILED)
+		{
+			if (error)
+				*error = "cannot map " + path + ": " + std::strerror(errno);
+			close(fd);
+			return false;
+		}
+		madvise(v, (size_t)st.st_size, MADV_SEQUENTIAL);
+		view = static_cast<const uint8_t*>(v);
+		length = (size_t)st.st_size;
+	}
+
+	// The mapping keeps the file alive on its own.
+	close(fd);
+	opened = true;
+	return true;
+}
+
+void MappedFile::Close()
+{
+	if (view)
+		munmap(const_cast<uint8_t*>(view), length);
+	view = nullptr;
+	length = 0;
+	opened = false;
+}
+
+#endif
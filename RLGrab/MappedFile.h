@@ -0,0 +1,35 @@
+#pragma once
+
+// Read-only memory mapping of a whole file (MapViewOfFile / mmap).
+// Portable, no SDK dependencies.
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+class MappedFile
+{
+public:
+	MappedFile() = default;
+	~MappedFile();
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+
+	// Maps `path` read-only. An empty file opens successfully with size() == 0.
+	bool Open(const std::string& path, std::string* error = nullptr);
+	void Close();
+
+	const uint8_t* data() const { return view; }
+	size_t size() const { return length; }
+	bool IsOpen() const { return opened; }
+
+private:
+	const uint8_t* view = nullptr;
+	size_t length = 0;
+	bool opened = false;
+
+#ifdef _WIN32
+	void* file = nullptr;
+	void* mapping = nullptr;
+#endif
+};
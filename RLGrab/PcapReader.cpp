@@ -0,0 +1,810 @@
+#include "PcapReader.h"
+#include "MappedFile.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <unordered_map>
+
+namespace
+{
+	// ----------------- Byte helpers -----------------
+
+	inline uint16_t Be16(const uint8_t* p) { return (uint16_t)((p[0] << 8) | p[1]); }
+
+	inline uint32_t Load32(const uint8_t* p, bool swap)
+	{
+		uint32_t v;
+		std::memcpy(&v, p, 4);
+		if (swap)
+			v = (v >> 24) | ((v >> 8) & 0xFF00u) | ((v << 8) & 0xFF0000u) | (v << 24);
+		return v;
+	}
+
+	inline uint16_t Load16(const uint8_t* p, bool swap)
+	{
+		uint16_t v;
+		std::memcpy(&v, p, 2);
+		if (swap)
+			v = (uint16_t)((v >> 8) | (v << 8));
+		return v;
+	}
+
+	// ----------------- Link types -----------------
+
+	enum LinkType : uint32_t
+	{
+		LinkNull     = 0,   // BSD loopback, 4-byte host-order family
+		LinkEthernet = 1,
+		LinkRaw      = 101, // raw IPv4/IPv6
+		LinkLoop     = 108, // OpenBSD loopback, network-order family
+		LinkSll      = 113, // Linux cooked capture v1
+		LinkIpv4     = 228,
+		LinkIpv6     = 229,
+		LinkSll2     = 276,
+	};
+
+	// ----------------- Flow table -----------------
+
+	struct FlowKey
+	{
+		uint8_t  addr[16];
+		uint16_t port;
+		uint8_t  family; // 4 or 6
+
+		bool operator==(const FlowKey& o) const
+		{
+			return port == o.port && family == o.family && std::memcmp(addr, o.addr, 16) == 0;
+		}
+	};
+
+	struct FlowKeyHash
+	{
+		size_t operator()(const FlowKey& k) const
+		{
+			uint64_t a, b;
+			std::memcpy(&a, k.addr, 8);
+			std::memcpy(&b, k.addr + 8, 8);
+			uint64_t h = (a * 0x9E3779B97F4A7C15ull) ^ (b * 0xC2B2AE3D27D4EB4Full);
+			h ^= ((uint64_t)k.port << 8) | k.family;
+			h *= 0xFF51AFD7ED558CCDull;
+			return (size_t)(h ^ (h >> 33));
+		}
+	};
+
+	struct FlowAccum
+	{
+		FlowKey  key;
+		uint64_t firstSeenUs;
+		uint64_t lastSeenUs;
+		uint64_t fromServer;
+		uint64_t toServer;
+		uint64_t bytes;
+	};
+
+	class FlowTable
+	{
+	public:
+		void Add(const FlowKey& key, bool fromServer, uint64_t tsUs, uint32_t len)
+		{
+			// Captures are dominated by one flow at a time; skip the hash
+			// lookup while consecutive packets hit the same server.
+			size_t idx;
+			if (lastIndex < flows.size() && flows[lastIndex].key == key)
+			{
+				idx = lastIndex;
+			}
+			else
+			{
+				auto it = index.find(key);
+				if (it == index.end())
+				{
+					idx = flows.size();
+					index.emplace(key, idx);
+					flows.push_back(FlowAccum{ key, tsUs, tsUs, 0, 0, 0 });
+				}
+				else
+				{
+					idx = it->second;
+				}
+				lastIndex = idx;
+			}
+
+			FlowAccum& f = flows[idx];
+			if (tsUs < f.firstSeenUs)
+				f.firstSeenUs = tsUs;
+			if (tsUs > f.lastSeenUs)
+				f.lastSeenUs = tsUs;
+			if (fromServer)
+				f.fromServer++;
+			else
+				f.toServer++;
+			f.bytes += len;
+		}
+
+		std::vector<FlowAccum> flows;
+
+	private:
+		std::unordered_map<FlowKey, size_t, FlowKeyHash> index;
+		size_t lastIndex = (size_t)-1;
+	};
+
+	// ----------------- Packet decoding -----------------
+
+	class PacketDecoder
+	{
+	public:
+		PacketDecoder(const PcapScanOptions& options, FlowTable& flows, PcapScanStats& stats)
+			: options(options), flows(flows), stats(stats)
+		{
+		}
+
+		void Decode(uint32_t linkType, const uint8_t* p, size_t len, uint64_t tsUs)
+		{
+			stats.packets++;
+
+			switch (linkType)
+			{
+			case LinkEthernet:
+			{
+				if (len < 14)
+					break;
+				uint16_t etherType = Be16(p + 12);
+				size_t off = 14;
+				// 802.1Q / 802.1ad tags
+				while ((etherType == 0x8100 || etherType == 0x88A8) && len >= off + 4)
+				{
+					etherType = Be16(p + off + 2);
+					off += 4;
+				}
+				DecodeEtherType(etherType, p + off, len - off, tsUs);
+				return;
+			}
+			case LinkSll:
+				if (len < 16)
+					break;
+				DecodeEtherType(Be16(p + 14), p + 16, len - 16, tsUs);
+				return;
+			case LinkSll2:
+				if (len < 20)
+					break;
+				DecodeEtherType(Be16(p), p + 20, len - 20, tsUs);
+				return;
+			case LinkNull:
+			case LinkLoop:
+				// Family is in host order for NULL and network order for LOOP;
+				// every value we care about fits in one byte either way.
+				if (len < 4)
+					break;
+				DecodeIp(p + 4, len - 4, tsUs);
+				return;
+			case LinkRaw:
+			case LinkIpv4:
+			case LinkIpv6:
+				DecodeIp(p, len, tsUs);
+				return;
+			default:
+				break;
+			}
+
+			stats.skipped++;
+		}
+
+	private:
+		void DecodeEtherType(uint16_t etherType, const uint8_t* p, size_t len, uint64_t tsUs)
+		{
+			if (etherType == 0x0800 || etherType == 0x86DD)
+				DecodeIp(p, len, tsUs);
+			else
+				stats.skipped++;
+		}
+
+		void DecodeIp(const uint8_t* p, size_t len, uint64_t tsUs)
+		{
+			if (len < 1)
+			{
+				stats.skipped++;
+				return;
+			}
+			uint8_t version = p[0] >> 4;
+			if (version == 4)
+				DecodeIpv4(p, len, tsUs);
+			else if (version == 6)
+				DecodeIpv6(p, len, tsUs);
+			else
+				stats.skipped++;
+		}
+
+		void DecodeIpv4(const uint8_t* p, size_t len, uint64_t tsUs)
+		{
+			if (len < 20)
+			{
+				stats.skipped++;
+				return;
+			}
+			size_t ihl = (size_t)(p[0] & 0x0F) * 4;
+			uint16_t fragOffset = Be16(p + 6) & 0x1FFF;
+			if (ihl < 20 || len < ihl || p[9] != 17 || fragOffset != 0)
+			{
+				stats.skipped++;
+				return;
+			}
+
+			FlowKey src{}, dst{};
+			src.family = dst.family = 4;
+			std::memcpy(src.addr, p + 12, 4);
+			std::memcpy(dst.addr, p + 16, 4);
+			DecodeUdp(src, dst, p + ihl, len - ihl, tsUs);
+		}
+
+		void DecodeIpv6(const uint8_t* p, size_t len, uint64_t tsUs)
+		{
+			if (len < 40)
+			{
+				stats.skipped++;
+				return;
+			}
+
+			FlowKey src{}, dst{};
+			src.family = dst.family = 6;
+			std::memcpy(src.addr, p + 8, 16);
+			std::memcpy(dst.addr, p + 24, 16);
+
+			uint8_t next = p[6];
+			size_t off = 40;
+			// Walk the common extension headers; give up on anything exotic.
+			for (int guard = 0; guard < 8 && next != 17; ++guard)
+			{
+				if (len < off + 8)
+					break;
+				if (next == 0 || next == 43 || next == 60)
+				{
+					next = p[off];
+					off += ((size_t)p[off + 1] + 1) * 8;
+				}
+				else if (next == 44)
+				{
+					if ((Be16(p + off + 2) & 0xFFF8) != 0)
+						break; // non-first fragment
+					next = p[off];
+					off += 8;
+				}
+				else
+				{
+					break;
+				}
+			}
+
+			if (next != 17 || len < off)
+			{
+				stats.skipped++;
+				return;
+			}
+			DecodeUdp(src, dst, p + off, len - off, tsUs);
+		}
+
+		void DecodeUdp(FlowKey& src, FlowKey& dst, const uint8_t* p, size_t len, uint64_t tsUs)
+		{
+			if (len < 8)
+			{
+				stats.skipped++;
+				return;
+			}
+			src.port = Be16(p);
+			dst.port = Be16(p + 2);
+			uint16_t udpLen = Be16(p + 4);
+
+			bool srcIsServer = InRange(src.port);
+			bool dstIsServer = InRange(dst.port);
+			if (!srcIsServer && !dstIsServer)
+				return;
+
+			stats.udpPackets++;
+			// If both ends look like servers, the lower port is the listener.
+			if (srcIsServer && dstIsServer)
+				srcIsServer = src.port <= dst.port;
+
+			if (srcIsServer)
+				flows.Add(src, true, tsUs, udpLen);
+			else
+				flows.Add(dst, false, tsUs, udpLen);
+		}
+
+		bool InRange(uint16_t port) const
+		{
+			return port >= options.minServerPort && port <= options.maxServerPort;
+		}
+
+		const PcapScanOptions& options;
+		FlowTable& flows;
+		PcapScanStats& stats;
+	};
+
+	// ----------------- File formats -----------------
+
+	constexpr uint32_t kPcapMagicUs = 0xA1B2C3D4;
+	constexpr uint32_t kPcapMagicNs = 0xA1B23C4D;
+	constexpr uint32_t kPcapngShb   = 0x0A0D0D0A;
+	constexpr uint32_t kPcapngBom   = 0x1A2B3C4D;
+
+	struct PcapngInterface
+	{
+		uint32_t linkType;
+		uint32_t snapLen;
+		uint64_t unitsPerSecond;
+	};
+
+	// Whole seconds, then the remainder scaled on its own, so rates that do
+	// not divide (or are not divided by) 10^6, like binary if_tsresol, stay
+	// exact. Past 2^44 units/s the remainder product would overflow and is
+	// scaled in floating point instead, still well within a microsecond.
+	uint64_t ToMicros(uint64_t ts, uint64_t unitsPerSecond)
+	{
+		if (unitsPerSecond == 1000000ull)
+			return ts;
+		uint64_t seconds = ts / unitsPerSecond;
+		uint64_t rem = ts % unitsPerSecond;
+		uint64_t micros = unitsPerSecond <= UINT64_MAX / 1000000ull
+			? rem * 1000000ull / unitsPerSecond
+			: (uint64_t)((double)rem / (double)unitsPerSecond * 1e6);
+		return seconds * 1000000ull + micros;
+	}
+
+	uint64_t ParseTsResol(const uint8_t* opts, size_t len, bool swap)
+	{
+		uint64_t units = 1000000ull;
+		size_t off = 0;
+		while (off + 4 <= len)
+		{
+			uint16_t code = Load16(opts + off, swap);
+			uint16_t optLen = Load16(opts + off + 2, swap);
+			if (code == 0)
+				break;
+			if (code == 9 && optLen >= 1 && off + 5 <= len)
+			{
+				uint8_t v = opts[off + 4];
+				uint8_t exp = v & 0x7F;
+				if (v & 0x80)
+					units = exp < 63 ? (1ull << exp) : units;
+				else
+				{
+					units = 1;
+					for (uint8_t i = 0; i < exp && i < 19; ++i)
+						units *= 10;
+				}
+				if (units == 0)
+					units = 1000000ull;
+			}
+			off += 4 + (((size_t)optLen + 3) & ~(size_t)3);
+		}
+		return units;
+	}
+
+	// ----------------- Output -----------------
+
+	std::string FormatAddress(const FlowKey& key)
+	{
+		char buf[48];
+		if (key.family == 4)
+		{
+			snprintf(buf, sizeof(buf), "%u.%u.%u.%u", key.addr[0], key.addr[1], key.addr[2], key.addr[3]);
+			return buf;
+		}
+
+		uint16_t groups[8];
+		for (int i = 0; i < 8; ++i)
+			groups[i] = Be16(key.addr + i * 2);
+
+		// RFC 5952: compress the longest run (>= 2) of zero groups.
+		int bestStart = -1, bestLen = 0;
+		for (int i = 0; i < 8;)
+		{
+			if (groups[i] != 0)
+			{
+				++i;
+				continue;
+			}
+			int j = i;
+			while (j < 8 && groups[j] == 0)
+				++j;
+			if (j - i > bestLen && j - i >= 2)
+			{
+				bestStart = i;
+				bestLen = j - i;
+			}
+			i = j;
+		}
+
+		std::string out;
+		for (int i = 0; i < 8; ++i)
+		{
+			if (i == bestStart)
+			{
+				out += "::";
+				i += bestLen - 1;
+				continue;
+			}
+			if (!out.empty() && out.back() != ':')
+				out += ':';
+			snprintf(buf, sizeof(buf), "%x", groups[i]);
+			out += buf;
+		}
+		return out;
+	}
+}
+
+std::string PcapFlow::Endpoint() const
+{
+	if (address.find(':') != std::string::npos)
+		return "[" + address + "]:" + std::to_string(port);
+	return address + ":" + std::to_string(port);
+}
+
+// ----------------- PcapScanner -----------------
+
+struct PcapScanner::Impl
+{
+	explicit Impl(const PcapScanOptions& options) : options(options), decoder(this->options, flows, stats) {}
+
+	bool Start(std::string* error);
+	void StepClassic(size_t stopAt, std::chrono::steady_clock::time_point deadline);
+	void StepPcapng(size_t stopAt, std::chrono::steady_clock::time_point deadline);
+
+	PcapScanOptions options;
+	PcapScanStats stats;
+	FlowTable flows;
+	PacketDecoder decoder;
+
+	MappedFile file;
+	const uint8_t* data = nullptr;
+	size_t size = 0;
+	size_t off = 0;
+	bool done = false;
+
+	bool pcapng = false;
+	bool swap = false;
+	bool nanos = false;    // classic only
+	uint32_t linkType = 0; // classic only
+	std::vector<PcapngInterface> interfaces;
+};
+
+// Records between deadline checks; a clock read per packet would cost more
+// than decoding it.
+constexpr int kRecordsPerClockCheck = 256;
+
+bool PcapScanner::Impl::Start(std::string* error)
+{
+	if (!data || size < 12)
+	{
+		if (error)
+			*error = "file too small to be a capture";
+		return false;
+	}
+
+	uint32_t magic;
+	std::memcpy(&magic, data, 4);
+	if (magic == kPcapngShb)
+	{
+		// Later sections may switch byte order; the first one must be valid.
+		if (Load32(data + 8, false) != kPcapngBom && Load32(data + 8, true) != kPcapngBom)
+		{
+			if (error)
+				*error = "bad pcapng byte-order magic";
+			return false;
+		}
+		pcapng = true;
+		return true;
+	}
+
+	if (magic == kPcapMagicUs) {}
+	else if (magic == kPcapMagicNs) nanos = true;
+	else if (Load32(data, true) == kPcapMagicUs) swap = true;
+	else if (Load32(data, true) == kPcapMagicNs) swap = nanos = true;
+	else
+	{
+		if (error)
+			*error = "not a pcap or pcapng file";
+		return false;
+	}
+
+	if (size < 24)
+	{
+		if (error)
+			*error = "truncated pcap header";
+		return false;
+	}
+
+	linkType = Load32(data + 20, swap) & 0x0FFFFFFF; // upper bits carry FCS flags
+	off = 24;
+	return true;
+}
+
+void PcapScanner::Impl::StepClassic(size_t stopAt, std::chrono::steady_clock::time_point deadline)
+{
+	int sinceCheck = 0;
+	while (off + 16 <= size)
+	{
+		const uint8_t* rec = data + off;
+		uint64_t sec = Load32(rec, swap);
+		uint64_t frac = Load32(rec + 4, swap);
+		uint32_t capLen = Load32(rec + 8, swap);
+		if (capLen > size - off - 16)
+			break; // truncated tail
+
+		uint64_t tsUs = sec * 1000000ull + (nanos ? frac / 1000 : frac);
+		decoder.Decode(linkType, rec + 16, capLen, tsUs);
+		off += 16 + (size_t)capLen;
+
+		if (off >= stopAt)
+			return;
+		if (++sinceCheck == kRecordsPerClockCheck)
+		{
+			sinceCheck = 0;
+			if (std::chrono::steady_clock::now() >= deadline)
+				return;
+		}
+	}
+	done = true;
+}
+
+void PcapScanner::Impl::StepPcapng(size_t stopAt, std::chrono::steady_clock::time_point deadline)
+{
+	int sinceCheck = 0;
+	while (off + 12 <= size)
+	{
+		const uint8_t* blk = data + off;
+		uint32_t type;
+		std::memcpy(&type, blk, 4); // SHB type is a palindrome, others use the section order
+
+		if (type == kPcapngShb)
+		{
+			uint32_t bom;
+			std::memcpy(&bom, blk + 8, 4);
+			if (bom == kPcapngBom)
+				swap = false;
+			else if (Load32(blk + 8, true) == kPcapngBom)
+				swap = true;
+			else
+				break; // corrupt later section; keep what was read
+			interfaces.clear();
+		}
+		else if (swap)
+		{
+			type = Load32(blk, true);
+		}
+
+		uint32_t blockLen = Load32(blk + 4, swap);
+		if (blockLen < 12 || (blockLen & 3) != 0 || blockLen > size - off)
+			break; // corrupt or truncated tail
+
+		const uint8_t* body = blk + 8;
+		size_t bodyLen = blockLen - 12;
+
+		switch (type)
+		{
+		case 1: // Interface Description Block
+			if (bodyLen >= 8)
+			{
+				PcapngInterface itf;
+				itf.linkType = Load16(body, swap);
+				itf.snapLen = Load32(body + 4, swap);
+				itf.unitsPerSecond = ParseTsResol(body + 8, bodyLen - 8, swap);
+				interfaces.push_back(itf);
+			}
+			break;
+		case 6: // Enhanced Packet Block
+			if (bodyLen >= 20)
+			{
+				uint32_t ifId = Load32(body, swap);
+				uint64_t ts = ((uint64_t)Load32(body + 4, swap) << 32) | Load32(body + 8, swap);
+				uint32_t capLen = Load32(body + 12, swap);
+				if (ifId < interfaces.size() && capLen <= bodyLen - 20)
+				{
+					const PcapngInterface& itf = interfaces[ifId];
+					decoder.Decode(itf.linkType, body + 20, capLen, ToMicros(ts, itf.unitsPerSecond));
+				}
+				else
+				{
+					stats.skipped++;
+				}
+			}
+			break;
+		case 3: // Simple Packet Block, interface 0, no timestamp
+			if (bodyLen >= 4 && !interfaces.empty())
+			{
+				uint32_t origLen = Load32(body, swap);
+				size_t capLen = std::min<size_t>(origLen, bodyLen - 4);
+				if (interfaces[0].snapLen != 0)
+					capLen = std::min<size_t>(capLen, interfaces[0].snapLen);
+				decoder.Decode(interfaces[0].linkType, body + 4, capLen, 0);
+			}
+			break;
+		case 2: // obsolete Packet Block
+			if (bodyLen >= 20)
+			{
+				uint16_t ifId = Load16(body, swap);
+				uint64_t ts = ((uint64_t)Load32(body + 4, swap) << 32) | Load32(body + 8, swap);
+				uint32_t capLen = Load32(body + 12, swap);
+				if (ifId < interfaces.size() && capLen <= bodyLen - 20)
+					decoder.Decode(interfaces[ifId].linkType, body + 20, capLen, ToMicros(ts, interfaces[ifId].unitsPerSecond));
+			}
+			break;
+		default:
+			break; // statistics, name resolution, custom blocks
+		}
+
+		off += blockLen;
+
+		if (off >= stopAt)
+			return;
+		if (++sinceCheck == kRecordsPerClockCheck)
+		{
+			sinceCheck = 0;
+			if (std::chrono::steady_clock::now() >= deadline)
+				return;
+		}
+	}
+	done = true;
+}
+
+PcapScanner::PcapScanner() = default;
+PcapScanner::~PcapScanner() = default;
+
+bool PcapScanner::Open(const std::string& path, const PcapScanOptions& options, std::string* error)
+{
+	impl = std::make_unique<Impl>(options);
+	if (!impl->file.Open(path, error))
+	{
+		impl.reset();
+		return false;
+	}
+	impl->data = impl->file.data();
+	impl->size = impl->file.size();
+	if (!impl->Start(error))
+	{
+		impl.reset();
+		return false;
+	}
+	return true;
+}
+
+bool PcapScanner::OpenBuffer(const uint8_t* data, size_t size, const PcapScanOptions& options, std::string* error)
+{
+	impl = std::make_unique<Impl>(options);
+	impl->data = data;
+	impl->size = size;
+	if (!impl->Start(error))
+	{
+		impl.reset();
+		return false;
+	}
+	return true;
+}
+
+bool PcapScanner::Step(uint64_t maxBytes, std::chrono::steady_clock::time_point deadline)
+{
+	if (!impl || impl->done)
+		return false;
+
+	size_t start = impl->off;
+	size_t stopAt = maxBytes >= impl->size - start ? impl->size : start + (size_t)maxBytes;
+	if (impl->pcapng)
+		impl->StepPcapng(stopAt, deadline);
+	else
+		impl->StepClassic(stopAt, deadline);
+
+	impl->stats.bytes += impl->off - start;
+	return !impl->done;
+}
+
+void PcapScanner::Finish(std::vector<PcapFlow>& outFlows)
+{
+	if (!impl)
+		return;
+
+	const PcapScanOptions& options = impl->options;
+	impl->stats.candidateFlows += impl->flows.flows.size();
+
+	std::vector<PcapFlow> found;
+	for (const FlowAccum& f : impl->flows.flows)
+	{
+		uint64_t packets = f.fromServer + f.toServer;
+		if (packets < options.minPackets)
+			continue;
+		if (options.requireBidirectional && (f.fromServer == 0 || f.toServer == 0))
+			continue;
+
+		// Simple Packet Blocks carry no timestamp; judge those on volume alone.
+		if (f.lastSeenUs > f.firstSeenUs)
+		{
+			double seconds = (double)(f.lastSeenUs - f.firstSeenUs) / 1e6;
+			if ((double)packets / seconds < options.minPacketsPerSecond)
+				continue;
+		}
+
+		PcapFlow out;
+		out.address = FormatAddress(f.key);
+		out.port = f.key.port;
+		out.firstSeenUs = f.firstSeenUs;
+		out.lastSeenUs = f.lastSeenUs;
+		out.packetsFromServer = f.fromServer;
+		out.packetsToServer = f.toServer;
+		out.bytes = f.bytes;
+		found.push_back(std::move(out));
+	}
+
+	std::sort(found.begin(), found.end(),
+		[](const PcapFlow& a, const PcapFlow& b) { return a.firstSeenUs < b.firstSeenUs; });
+
+	outFlows.insert(outFlows.end(), found.begin(), found.end());
+
+	// Stats stay readable; the mapping and flow table go.
+	impl->file.Close();
+	impl->data = nullptr;
+	impl->size = impl->off = 0;
+	impl->done = true;
+	impl->flows = FlowTable();
+}
+
+const PcapScanStats& PcapScanner::Stats() const
+{
+	static const PcapScanStats empty;
+	return impl ? impl->stats : empty;
+}
+
+uint64_t PcapScanner::Remaining() const
+{
+	return impl && !impl->done ? impl->size - impl->off : 0;
+}
+
+// ----------------- One-shot scans -----------------
+
+namespace
+{
+	void ScanToEnd(PcapScanner& scanner, std::vector<PcapFlow>& outFlows, PcapScanStats* stats)
+	{
+		while (scanner.Step(UINT64_MAX, std::chrono::steady_clock::time_point::max()))
+		{
+		}
+		scanner.Finish(outFlows);
+
+		if (stats)
+		{
+			const PcapScanStats& st = scanner.Stats();
+			stats->bytes += st.bytes;
+			stats->packets += st.packets;
+			stats->udpPackets += st.udpPackets;
+			stats->skipped += st.skipped;
+			stats->candidateFlows += st.candidateFlows;
+		}
+	}
+}
+
+bool ScanPcapBuffer(
+	const uint8_t* data,
+	size_t size,
+	const PcapScanOptions& options,
+	std::vector<PcapFlow>& outFlows,
+	PcapScanStats* stats,
+	std::string* error)
+{
+	PcapScanner scanner;
+	if (!scanner.OpenBuffer(data, size, options, error))
+		return false;
+	ScanToEnd(scanner, outFlows, stats);
+	return true;
+}
+
+bool ScanPcapFile(
+	const std::string& path,
+	const PcapScanOptions& options,
+	std::vector<PcapFlow>& outFlows,
+	PcapScanStats* stats,
+	std::string* error)
+{
+	PcapScanner scanner;
+	if (!scanner.Open(path, options, error))
+		return false;
+	ScanToEnd(scanner, outFlows, stats);
+	return true;
+}
@@ -0,0 +1,103 @@
+#pragma once
+
+// Offline packet-capture reader used as a second endpoint source next to
+// Launch.log scraping.
+//
+// Parses classic pcap (µs and ns, either byte order) and pcapng files
+// straight out of a read-only mapping, decodes Ethernet / Linux SLL / raw IP
+// framing, IPv4, IPv6 and UDP, and aggregates UDP traffic per server
+// endpoint. A flow is reported as a game server when its port lies in the
+// configured range and it carries a sustained, bidirectional packet rate
+// (Rocket League servers tick at 60-120 packets per second).
+//
+// Portable, no SDK dependencies.
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+struct PcapScanOptions
+{
+	uint16_t minServerPort = 7000;       // game servers listen in this range
+	uint16_t maxServerPort = 9999;
+	uint64_t minPackets = 100;           // both directions together
+	double   minPacketsPerSecond = 20.0; // averaged over the flow lifetime
+	bool     requireBidirectional = true;
+};
+
+struct PcapFlow
+{
+	std::string address;      // "1.2.3.4" or "2001:db8::1"
+	uint16_t    port = 0;
+	uint64_t    firstSeenUs = 0; // capture timestamps, microseconds since epoch
+	uint64_t    lastSeenUs = 0;
+	uint64_t    packetsFromServer = 0;
+	uint64_t    packetsToServer = 0;
+	uint64_t    bytes = 0;
+
+	// GameURL-style "ip:port" ("[v6]:port" for IPv6) as used by Launch.log.
+	std::string Endpoint() const;
+	uint64_t Packets() const { return packetsFromServer + packetsToServer; }
+};
+
+struct PcapScanStats
+{
+	uint64_t bytes = 0;          // capture bytes walked
+	uint64_t packets = 0;        // packet records
+	uint64_t udpPackets = 0;     // UDP datagrams with a port in range
+	uint64_t skipped = 0;        // unsupported link types, fragments, truncated headers
+	uint64_t candidateFlows = 0; // flows before the rate heuristic
+};
+
+// Resumable scan for callers that must not block: Open, then Step until it
+// returns false, then Finish. Each Step stops at the first record boundary
+// past either limit; at least one record is always walked.
+class PcapScanner
+{
+public:
+	PcapScanner();
+	~PcapScanner();
+	PcapScanner(const PcapScanner&) = delete;
+	PcapScanner& operator=(const PcapScanner&) = delete;
+
+	// Maps `path`; fails like ScanPcapFile on an unreadable or unknown file.
+	bool Open(const std::string& path, const PcapScanOptions& options, std::string* error = nullptr);
+	// Scans caller memory, which must outlive the scanner.
+	bool OpenBuffer(const uint8_t* data, size_t size, const PcapScanOptions& options, std::string* error = nullptr);
+
+	// Returns true while records remain.
+	bool Step(uint64_t maxBytes, std::chrono::steady_clock::time_point deadline);
+
+	// Applies the game-server heuristic, appends the flows sorted by first
+	// sighting and releases the file.
+	void Finish(std::vector<PcapFlow>& outFlows);
+
+	const PcapScanStats& Stats() const;
+	uint64_t Remaining() const; // capture bytes not walked yet
+
+private:
+	struct Impl;
+	std::unique_ptr<Impl> impl;
+};
+
+// Scans an in-memory capture. Returns false (with `error`) only if the file
+// format is not recognised or the framing is corrupt before any packet was
+// read; a truncated tail just ends the scan.
+bool ScanPcapBuffer(
+	const uint8_t* data,
+	size_t size,
+	const PcapScanOptions& options,
+	std::vector<PcapFlow>& outFlows,
+	PcapScanStats* stats = nullptr,
+	std::string* error = nullptr);
+
+// Maps `path` and scans it in place without copying packet data.
+bool ScanPcapFile(
+	const std::string& path,
+	const PcapScanOptions& options,
+	std::vector<PcapFlow>& outFlows,
+	PcapScanStats* stats = nullptr,
+	std::string* error = nullptr);
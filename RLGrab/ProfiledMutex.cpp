@@ -0,0 +1,305 @@
+#include "ProfiledMutex.h"
+
+#include <algorithm>
+#include <bit>
+#include <cstdio>
+#include <cstring>
+
+namespace
+{
+	std::atomic<bool> profilingEnabled{ false };
+
+#if RLGRAB_LOCK_PROFILING
+	uint64_t ElapsedNs(std::chrono::steady_clock::time_point from, std::chrono::steady_clock::time_point to)
+	{
+		auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(to - from).count();
+		return ns > 0 ? (uint64_t)ns : 0;
+	}
+#endif
+
+	// MSVC reports "void __cdecl RLGrab::StoreEndpoints(class std::vector<...> &)";
+	// keep the qualified name only.
+	std::string TrimFunction(const char* function)
+	{
+		std::string s = function ? function : "";
+		size_t paren = s.find('(');
+		if (paren != std::string::npos && paren > 0)
+			s.resize(paren);
+		size_t space = s.rfind(' ');
+		if (space != std::string::npos)
+			s.erase(0, space + 1);
+		return s;
+	}
+
+	std::string BaseName(const char* path)
+	{
+		std::string s = path ? path : "";
+		size_t slash = s.find_last_of("/\\");
+		return slash == std::string::npos ? s : s.substr(slash + 1);
+	}
+
+	void AppendDuration(std::string& out, uint64_t ns)
+	{
+		char buf[32];
+		if (ns < 1000)
+			std::snprintf(buf, sizeof(buf), "<1 us");
+		else if (ns < 10'000'000)
+			std::snprintf(buf, sizeof(buf), "%llu us", (unsigned long long)(ns / 1000));
+		else
+			std::snprintf(buf, sizeof(buf), "%llu ms", (unsigned long long)(ns / 1'000'000));
+		out += buf;
+	}
+
+	// Names are prettified and totals merged outside the lock.
+	void FinishSnapshot(LockStats& stats, const char* name)
+	{
+		stats.name = name;
+		stats.total = LockSiteStats();
+		stats.total.function = "(all sites)";
+		for (auto& s : stats.sites)
+		{
+			s.function = s.line ? TrimFunction(s.function.c_str()) : s.function;
+			s.file = s.line ? BaseName(s.file.c_str()) : "";
+			stats.total.acquisitions += s.acquisitions;
+			stats.total.contended += s.contended;
+			stats.total.wait.Merge(s.wait);
+			stats.total.hold.Merge(s.hold);
+		}
+		std::sort(stats.sites.begin(), stats.sites.end(), [](const LockSiteStats& a, const LockSiteStats& b)
+			{
+				return a.hold.totalNs + a.wait.totalNs > b.hold.totalNs + b.wait.totalNs;
+			});
+	}
+
+	void AppendHistogram(std::string& out, const char* label, const LockHistogram& h)
+	{
+		out += label;
+		out += " p50 ";
+		AppendDuration(out, h.Quantile(0.5));
+		out += " p99 ";
+		AppendDuration(out, h.Quantile(0.99));
+		out += " max ";
+		AppendDuration(out, h.maxNs);
+	}
+}
+
+// ----------------- LockHistogram -----------------
+
+void LockHistogram::Add(uint64_t ns)
+{
+	size_t bucket = std::min<size_t>((size_t)std::bit_width(ns), kBuckets - 1);
+	counts[bucket]++;
+	totalNs += ns;
+	maxNs = std::max(maxNs, ns);
+}
+
+void LockHistogram::Merge(const LockHistogram& other)
+{
+	for (size_t i = 0; i < kBuckets; ++i)
+		counts[i] += other.counts[i];
+	totalNs += other.totalNs;
+	maxNs = std::max(maxNs, other.maxNs);
+}
+
+uint64_t LockHistogram::Count() const
+{
+	uint64_t n = 0;
+	for (uint64_t c : counts)
+		n += c;
+	return n;
+}
+
+uint64_t LockHistogram::Quantile(double q) const
+{
+	uint64_t n = Count();
+	if (n == 0)
+		return 0;
+
+	uint64_t rank = (uint64_t)(q * (double)(n - 1)) + 1;
+	uint64_t seen = 0;
+	for (size_t i = 0; i < kBuckets; ++i)
+	{
+		seen += counts[i];
+		if (seen >= rank)
+			return std::min<uint64_t>(i == 0 ? 0 : (1ull << i) - 1, maxNs);
+	}
+	return maxNs;
+}
+
+// ----------------- ProfiledMutex -----------------
+
+void ProfiledMutex::SetProfilingEnabled(bool enabled)
+{
+	profilingEnabled.store(enabled, std::memory_order_relaxed);
+}
+
+bool ProfiledMutex::ProfilingEnabled()
+{
+	return RLGRAB_LOCK_PROFILING && profilingEnabled.load(std::memory_order_relaxed);
+}
+
+#if RLGRAB_LOCK_PROFILING
+
+size_t ProfiledMutex::FindSite(const std::source_location& site)
+{
+	for (size_t i = 0; i < siteCount; ++i)
+	{
+		const Site& s = sites[i];
+		if (s.line == site.line() && (s.file == site.file_name() || std::strcmp(s.file, site.file_name()) == 0))
+			return i;
+	}
+	if (siteCount == kMaxSites)
+		return kMaxSites - 1;
+
+	Site& s = sites[siteCount];
+	s.file = site.file_name();
+	s.function = siteCount == kMaxSites - 1 ? "(other sites)" : site.function_name();
+	s.line = siteCount == kMaxSites - 1 ? 0 : site.line();
+	return siteCount++;
+}
+
+void ProfiledMutex::Lock(const std::source_location& site)
+{
+	if (!profilingEnabled.load(std::memory_order_relaxed))
+	{
+		mutex.lock();
+		return;
+	}
+
+	// The uncontended path reads the clock once.
+	uint64_t waitNs = 0;
+	bool contended = !mutex.try_lock();
+	if (contended)
+	{
+		auto start = std::chrono::steady_clock::now();
+		mutex.lock();
+		holdStart = std::chrono::steady_clock::now();
+		waitNs = ElapsedNs(start, holdStart);
+	}
+	else
+	{
+		holdStart = std::chrono::steady_clock::now();
+	}
+
+	size_t index = FindSite(site);
+	Site& s = sites[index];
+	s.acquisitions++;
+	s.contended += contended ? 1 : 0;
+	s.wait.Add(waitNs);
+	holder = (int)index;
+}
+
+void ProfiledMutex::Unlock()
+{
+	if (holder >= 0)
+	{
+		sites[holder].hold.Add(ElapsedNs(holdStart, std::chrono::steady_clock::now()));
+		holder = -1;
+	}
+	mutex.unlock();
+}
+
+bool ProfiledMutex::try_lock()
+{
+	if (!mutex.try_lock())
+		return false;
+	holder = -1;
+	return true;
+}
+
+void ProfiledMutex::CollectLocked(LockStats& stats) const
+{
+	stats.sites.clear();
+	for (size_t i = 0; i < siteCount; ++i)
+	{
+		const Site& s = sites[i];
+		LockSiteStats out;
+		out.function = s.function;
+		out.file = s.file;
+		out.line = s.line;
+		out.acquisitions = s.acquisitions;
+		out.contended = s.contended;
+		out.wait = s.wait;
+		out.hold = s.hold;
+		stats.sites.push_back(std::move(out));
+	}
+}
+
+LockStats ProfiledMutex::Snapshot()
+{
+	LockStats stats;
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		CollectLocked(stats);
+	}
+	FinishSnapshot(stats, name);
+	return stats;
+}
+
+bool ProfiledMutex::TrySnapshot(LockStats& out)
+{
+	LockStats stats;
+	{
+		std::unique_lock<std::mutex> lock(mutex, std::try_to_lock);
+		if (!lock.owns_lock())
+			return false;
+		CollectLocked(stats);
+	}
+	FinishSnapshot(stats, name);
+	out = std::move(stats);
+	return true;
+}
+
+void ProfiledMutex::ResetStats()
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	for (size_t i = 0; i < siteCount; ++i)
+		sites[i] = Site();
+	siteCount = 0;
+}
+
+#else
+
+void ProfiledMutex::Lock(const std::source_location&)
+{
+	mutex.lock();
+}
+
+void ProfiledMutex::Unlock()
+{
+	mutex.unlock();
+}
+
+bool ProfiledMutex::try_lock()
+{
+	return mutex.try_lock();
+}
+
+LockStats ProfiledMutex::Snapshot()
+{
+	LockStats stats;
+	FinishSnapshot(stats, name);
+	stats.total.function = "(profiling compiled out)";
+	return stats;
+}
+
+bool ProfiledMutex::TrySnapshot(LockStats& out)
+{
+	out = Snapshot();
+	return true;
+}
+
+void ProfiledMutex::ResetStats()
+{
+}
+
+#endif
+
+std::string FormatLockStats(const LockSiteStats& stats)
+{
+	std::string out = std::to_string(stats.acquisitions) + " locks, " + std::to_string(stats.contended) + " contended, ";
+	AppendHistogram(out, "wait", stats.wait);
+	out += ", ";
+	AppendHistogram(out, "hold", stats.hold);
+	return out;
+}
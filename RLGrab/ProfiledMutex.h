@@ -0,0 +1,138 @@
+#pragma once
+
+// std::mutex with optional wait/hold profiling per call site.
+//
+// Lock through ProfiledLock (a lock_guard that captures its source
+// location) and every acquisition records how long it waited and, on
+// release, how long the lock was held, into log2 nanosecond histograms
+// kept per call site. All bookkeeping happens while the lock itself is
+// held, so the counters need no atomics of their own; Snapshot() simply
+// takes the lock.
+//
+// Profiling is off until SetProfilingEnabled(true). While off a lock costs
+// one relaxed atomic load over a plain std::mutex. Define
+// RLGRAB_LOCK_PROFILING=0 to compile the instrumentation out entirely.
+//
+// Portable, no SDK dependencies.
+
+#ifndef RLGRAB_LOCK_PROFILING
+#define RLGRAB_LOCK_PROFILING 1
+#endif
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <source_location>
+#include <string>
+#include <vector>
+
+struct LockHistogram
+{
+	// Bucket i counts durations below 2^i ns (bucket 0: exactly 0).
+	static constexpr size_t kBuckets = 40;
+
+	uint64_t counts[kBuckets] = {};
+	uint64_t totalNs = 0;
+	uint64_t maxNs = 0;
+
+	void Add(uint64_t ns);
+	void Merge(const LockHistogram& other);
+	uint64_t Count() const;
+
+	// Upper bound of the bucket holding quantile q (0..1), in ns.
+	uint64_t Quantile(double q) const;
+};
+
+struct LockSiteStats
+{
+	std::string function;   // as reported by the compiler, trimmed
+	std::string file;       // base name
+	uint32_t line = 0;
+	uint64_t acquisitions = 0;
+	uint64_t contended = 0; // had to wait at all
+	LockHistogram wait;
+	LockHistogram hold;
+};
+
+struct LockStats
+{
+	std::string name;
+	std::vector<LockSiteStats> sites; // busiest first
+	LockSiteStats total;              // all sites merged
+};
+
+class ProfiledMutex
+{
+public:
+	explicit ProfiledMutex(const char* name) : name(name) {}
+	ProfiledMutex(const ProfiledMutex&) = delete;
+	ProfiledMutex& operator=(const ProfiledMutex&) = delete;
+
+	static void SetProfilingEnabled(bool enabled);
+	static bool ProfilingEnabled();
+
+	void Lock(const std::source_location& site);
+	void Unlock();
+
+	// Lockable, for the standard lock types; these attribute to one site.
+	void lock() { Lock(std::source_location::current()); }
+	void unlock() { Unlock(); }
+	bool try_lock();
+
+	const char* Name() const { return name; }
+	LockStats Snapshot();
+	void ResetStats();
+
+	// Snapshot without waiting, for the render thread; false if the lock
+	// was busy (`out` untouched).
+	bool TrySnapshot(LockStats& out);
+
+private:
+#if RLGRAB_LOCK_PROFILING
+	static constexpr size_t kMaxSites = 32; // the last slot collects any overflow
+
+	struct Site
+	{
+		const char* file = nullptr;
+		const char* function = nullptr;
+		uint32_t line = 0;
+		uint64_t acquisitions = 0;
+		uint64_t contended = 0;
+		LockHistogram wait;
+		LockHistogram hold;
+	};
+
+	size_t FindSite(const std::source_location& site);
+	void CollectLocked(LockStats& out) const;
+
+	Site sites[kMaxSites];
+	size_t siteCount = 0;
+	int holder = -1; // site index of the current profiled hold
+	std::chrono::steady_clock::time_point holdStart;
+#endif
+
+	std::mutex mutex;
+	const char* name;
+};
+
+// lock_guard for ProfiledMutex that records where it was taken.
+class ProfiledLock
+{
+public:
+	explicit ProfiledLock(ProfiledMutex& mutex, const std::source_location& site = std::source_location::current())
+		: mutex(mutex)
+	{
+		mutex.Lock(site);
+	}
+	~ProfiledLock() { mutex.Unlock(); }
+
+	ProfiledLock(const ProfiledLock&) = delete;
+	ProfiledLock& operator=(const ProfiledLock&) = delete;
+
+private:
+	ProfiledMutex& mutex;
+};
+
+// "1204 locks, 3 contended, wait p50 <1 us p99 15 us max 21 us, hold p50 ..."
+std::string FormatLockStats(const LockSiteStats& stats);
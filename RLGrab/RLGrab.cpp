@@ -2,6 +2,7 @@
 #include "RLGrab.h"
 
 #include "imgui/imgui.h"
+#include "imgui/imguivariouscontrols.h"
 
 #include <Windows.h>
 #include <shlobj_core.h>
@@ -10,7 +11,9 @@
 #include <sstream>
 #include <set>
 #include <chrono>
-#include <regex>
+#include <algorithm>
+#include <cstdlib>
+#include <ctime>
 
 #pragma comment(lib, "shell32.lib")
 
@@ -63,6 +66,67 @@ std::string RLGrab::ExtractIpOnly(const std::string& endpoint)
 	return endpoint.substr(0, colon);
 }
 
+uint64_t RLGrab::FileModifiedMs(const std::string& path)
+{
+	std::error_code ec;
+	auto written = std::filesystem::last_write_time(path, ec);
+	if (ec)
+		return 0;
+	auto sinceEpoch = std::chrono::clock_cast<std::chrono::system_clock>(written).time_since_epoch();
+	return (uint64_t)std::max<long long>(0, std::chrono::duration_cast<std::chrono::milliseconds>(sinceEpoch).count());
+}
+
+std::string RLGrab::LogDirectory(const std::string& logPath)
+{
+	std::filesystem::path dir = std::filesystem::path(logPath).parent_path();
+	if (dir.empty())
+		return ".";
+	return dir.make_preferred().string();
+}
+
+bool RLGrab::SameDirectory(const std::string& a, const std::string& b)
+{
+	// Windows paths compare case-insensitively; both sides come from
+	// LogDirectory, so separators already agree.
+	return _stricmp(a.c_str(), b.c_str()) == 0;
+}
+
+// ----------------- Console -----------------
+
+void RLGrab::QueueLog(std::string message)
+{
+	bool schedule;
+	{
+		ProfiledLock lock(logQueueMutex);
+		logQueue.push_back(std::move(message));
+		// While unloading, onUnload's own FlushLogQueue picks the message up.
+		schedule = !logFlushScheduled && !unloading;
+		logFlushScheduled = true;
+	}
+	// One game-thread callback drains everything queued until it runs.
+	if (schedule)
+	{
+		std::weak_ptr<int> alive = logFlushAlive;
+		gameWrapper->Execute([this, alive](GameWrapper*)
+			{
+				if (!alive.expired())
+					FlushLogQueue();
+			});
+	}
+}
+
+void RLGrab::FlushLogQueue()
+{
+	std::vector<std::string> messages;
+	{
+		ProfiledLock lock(logQueueMutex);
+		messages.swap(logQueue);
+		logFlushScheduled = false;
+	}
+	for (const auto& message : messages)
+		cvarManager->log(message);
+}
+
 // ----------------- Log file helpers -----------------
 
 std::string RLGrab::GetDocumentsPath()
@@ -88,126 +152,459 @@ std::string RLGrab::GetLaunchLogPath()
 	return oss.str();
 }
 
-void RLGrab::ParseLaunchLogLine(
-	const std::string& line,
-	std::string& outServerName,
-	std::string& outGameUrl)
+std::vector<std::pair<std::string, std::string>> RLGrab::ParseLogSourceSpec(const std::string& spec)
 {
-	// Look for ServerName="..."
-	// and GameURL="..."
-	static const std::regex serverNameRegex(R"(ServerName="([^"]*)\")");
-		static const std::regex gameUrlRegex(R"(GameURL="([^"]*)\")");
-
-		std::smatch m;
-	if (std::regex_search(line, m, serverNameRegex) && m.size() > 1)
+	// "default;alt=D:\\Users\\bob\\Documents\\My Games\\Rocket League\\TAGame\\Logs"
+	// Entries are "name=path" or a bare path; "default" is the current user's Launch.log.
+	// A path that does not end in .log is taken as the Logs directory.
+	std::vector<std::pair<std::string, std::string>> out;
+	std::stringstream ss(spec);
+	std::string entry;
+	while (std::getline(ss, entry, ';'))
 	{
-		outServerName = m[1].str();
+		entry = Trim(entry);
+		if (entry.empty())
+			continue;
+
+		std::string name;
+		std::string path;
+		auto eq = entry.find('=');
+		if (eq != std::string::npos)
+		{
+			name = Trim(entry.substr(0, eq));
+			path = Trim(entry.substr(eq + 1));
+		}
+		else
+		{
+			path = entry;
+		}
+
+		if (path == "default")
+		{
+			path = GetLaunchLogPath();
+			if (name.empty())
+				name = "default";
+		}
+		if (path.empty())
+			continue;
+
+		std::string lower = path;
+		std::transform(lower.begin(), lower.end(), lower.begin(), [](unsigned char c) { return (char)std::tolower(c); });
+		if (lower.size() < 4 || lower.compare(lower.size() - 4, 4, ".log") != 0)
+		{
+			if (path.back() != '\\' && path.back() != '/')
+				path += "\\";
+			path += "Launch.log";
+		}
+
+		if (name.empty())
+			name = "log" + std::to_string(out.size() + 1);
+
+		bool duplicate = false;
+		for (const auto& it : out)
+			if (it.second == path)
+				duplicate = true;
+		if (!duplicate)
+			out.emplace_back(name, path);
 	}
-	if (std::regex_search(line, m, gameUrlRegex) && m.size() > 1)
+	return out;
+}
+
+void RLGrab::ApplyLogSources()
+{
+	const std::string& spec = workerConfig->logSources;
+	if (logSourcesApplied && spec == appliedLogSources)
+		return;
+	appliedLogSources = spec;
+	logSourcesApplied = true;
+
+	// Keep tail state for paths that stay configured.
+	std::vector<std::unique_ptr<LogSource>> next;
+	for (auto& [name, path] : ParseLogSourceSpec(spec))
 	{
-		outGameUrl = m[1].str();
+		std::unique_ptr<LogSource> src;
+		for (auto& old : logSources)
+		{
+			if (old && old->tail.Path() == path)
+			{
+				src = std::move(old);
+				break;
+			}
+		}
+		if (!src)
+		{
+			src = std::make_unique<LogSource>();
+			src->tail = LogTail(path);
+			AdoptSourceState(*src);
+		}
+		src->name = name;
+		next.push_back(std::move(src));
 	}
+	logSources = std::move(next);
+
+	// Publish the new source set right away; endpoint tags depend on its size.
+	ProfiledLock lock(ipsMutex);
+	sourceStatus.clear();
+	for (const auto& src : logSources)
+		sourceStatus.push_back({ src->name, src->tail.Path(), false, src->bytesRead, src->endpointsFound, src->restarts });
 }
 
-void RLGrab::ScanLaunchLog()
+std::filesystem::path RLGrab::GetRulesPath()
 {
-	std::string path = GetLaunchLogPath();
-	if (path.empty())
+	return gameWrapper->GetDataFolder() / "RLGrab" / "extraction_rules.txt";
+}
+
+void RLGrab::LoadExtractionRules()
+{
+	// Built-in ServerName/GameURL rules first, then the user's file, e.g.
+	//   Region|Region="|"
+	//   Playlist|PlaylistId=|,
+	std::vector<ExtractionRule> rules = ExtractionEngine::DefaultRules();
+
+	std::filesystem::path path = GetRulesPath();
+	std::ifstream file(path, std::ios::in | std::ios::binary);
+	if (file.is_open())
 	{
-		return;
+		std::stringstream text;
+		text << file.rdbuf();
+		std::string error;
+		if (!ExtractionEngine::ParseRules(text.str(), rules, &error))
+		{
+			QueueLog("RLGrab: ignoring " + path.string() + ": " + error);
+			rules = ExtractionEngine::DefaultRules();
+		}
 	}
 
-	std::ifstream file(path, std::ios::in);
-	if (!file.is_open())
+	auto engine = std::make_shared<ExtractionEngine>();
+	std::string error;
+	if (!engine->Compile(rules, &error))
+	{
+		QueueLog("RLGrab: extraction rules failed to compile: " + error);
+		engine->Compile(ExtractionEngine::DefaultRules());
+	}
+
+	QueueLog("RLGrab: " + std::to_string(engine->RuleCount()) + " extraction rule(s), "
+		+ std::to_string(engine->FieldCount()) + " field(s)");
+
+	ProfiledLock lock(rulesMutex);
+	extractor = std::move(engine);
+	extractorGeneration++;
+}
+
+void RLGrab::AdoptSourceState(LogSource& source)
+{
+	for (auto it = adoptedSources.begin(); it != adoptedSources.end(); ++it)
 	{
+		if (it->path != source.tail.Path())
+			continue;
+
+		// Continue the tail where the previous instance stopped. If the game
+		// recreated the log meanwhile, the head signature check restarts it.
+		source.tail.Restore(it->offset, std::move(it->head));
+		source.parse.serverName = std::move(it->currentServerName);
+		source.parse.gameUrl = std::move(it->currentGameUrl);
+		source.parse.logOpenMs = it->logOpenMs;
+		source.bytesRead = it->bytesRead;
+		source.endpointsFound = it->endpointsFound;
+		source.restarts = it->restarts;
+		source.historyOffset = it->historyOffset;
+
+		// Sticky fields travel by name; rules may have changed in between.
+		std::shared_ptr<const ExtractionEngine> engine;
+		{
+			ProfiledLock lock(rulesMutex);
+			engine = extractor;
+			source.parse.generation = extractorGeneration;
+		}
+		if (engine)
+		{
+			source.parse.extras.assign(engine->FieldCount(), std::string());
+			for (auto& [name, value] : it->extras)
+			{
+				int f = engine->FindField(name);
+				if (f >= 0)
+					source.parse.extras[f] = std::move(value);
+			}
+		}
+
+		adoptedSources.erase(it);
 		return;
 	}
+}
+
+bool RLGrab::ScanLaunchLog(const LogTailLimits& limits)
+{
+	ProfiledLock scanLock(scanMutex);
+	ApplyLogSources();
+
+	// Sources share the slice budget; whatever is left over stays ready
+	// and is resumed from its saved offset and parser state next slice.
+	uint64_t bytesLeft = limits.maxBytes;
+	bool more = false;
+	for (auto& src : logSources)
+	{
+		if (!src->ready)
+			continue;
+		if (bytesLeft == 0 || std::chrono::steady_clock::now() >= limits.deadline)
+		{
+			more = true;
+			break;
+		}
 
-	// We will parse from the beginning each time.
-	// To avoid duplicates, we keep a set of endpoints we have seen in this plugin instance.
-	std::vector<std::string> newEndpoints;
-	std::set<std::string> seenEndpoints;
+		LogTailLimits sourceLimits{ bytesLeft, limits.deadline };
+		uint64_t consumed = ScanLogSource(*src, sourceLimits);
+		bytesLeft = consumed >= bytesLeft ? 0 : bytesLeft - consumed;
+		more = more || src->ready;
+	}
 
+	// Snapshot for the settings panel so the UI never waits on a scan.
+	std::vector<LogSourceStatus> status;
+	uint64_t backlog = 0;
+	for (const auto& src : logSources)
 	{
-		std::lock_guard<std::mutex> lock(ipsMutex);
-		seenEndpoints.insert(knownEndpoints.begin(), knownEndpoints.end());
+		status.push_back({ src->name, src->tail.Path(), src->available, src->bytesRead, src->endpointsFound, src->restarts, src->backlog });
+		backlog += src->backlog;
 	}
+	backlogBytes = backlog + captureBacklog;
 
-	std::string line;
-	std::string currentServerName;
-	std::string currentGameUrl;
+	ProfiledLock lock(ipsMutex);
+	sourceStatus = std::move(status);
+	return more;
+}
+
+uint64_t RLGrab::ScanLogSource(LogSource& source, const LogTailLimits& limits)
+{
+	source.ready = false;
+
+	// Only bytes appended since the last poll are parsed; parser state
+	// carries over so a ServerName line still pairs with a later GameURL,
+	// whether the previous poll ended at EOF or on the slice budget.
+	std::vector<EndpointRecord> newEndpoints;
 
-	while (std::getline(file, line))
+	std::shared_ptr<const ExtractionEngine> engine;
+	uint64_t generation;
 	{
-		std::string serverName;
-		std::string gameUrl;
-		ParseLaunchLogLine(line, serverName, gameUrl);
+		ProfiledLock lock(rulesMutex);
+		engine = extractor;
+		generation = extractorGeneration;
+	}
+	if (!engine)
+		return 0;
+
+	LaunchLogParser parser(*engine, generation);
 
-		if (!serverName.empty())
-			currentServerName = serverName;
-		if (!gameUrl.empty())
-			currentGameUrl = gameUrl;
+	// A rescan reads lines whose sightings the history already holds; those
+	// come first in the batch, so only their count is passed on.
+	size_t alreadyRecorded = 0;
 
-		// When we have a GameURL, we can log an endpoint.
-		if (!currentGameUrl.empty())
+	auto result = source.tail.Poll([&](const std::string& line)
 		{
-			// GameURL expected like "ip:port" or maybe with additional query params; keep it raw.
-			std::string endpointLabel;
-			if (!currentServerName.empty())
-			{
-				// Format: ServerName (ip:port)
-				std::ostringstream ss;
-				ss << currentServerName << " (" << currentGameUrl << ")";
-				endpointLabel = ss.str();
-			}
-			else
-			{
-				endpointLabel = currentGameUrl;
-			}
+			// Duplicates are dropped in StoreEndpoints unless configured otherwise.
+			parser.Feed(line, source.parse, source.name, newEndpoints);
+			if (source.tail.LineEnd() <= source.historyOffset)
+				alreadyRecorded = newEndpoints.size();
+		},
+		[&]()
+		{
+			// New game session wrote a fresh Launch.log; pairing state from
+			// the old file must not leak into it, and none of its lines are
+			// in the history yet.
+			source.parse.Clear();
+			source.restarts++;
+			source.historyOffset = 0;
+		},
+		limits);
 
-			// Avoid pure duplicates if logDuplicates == false.
-			bool alreadySeen = (seenEndpoints.find(endpointLabel) != seenEndpoints.end());
+	source.available = result.opened;
+	source.bytesRead += result.bytes;
+	source.backlog = result.remaining;
+	source.ready = result.more;
 
-			if (logDuplicates || !alreadySeen)
+	// Lines without a usable timestamp (no "Log file open" line seen, e.g. a
+	// log cut at the head) were written no later than the file's last write.
+	uint64_t modifiedMs = 0;
+	for (auto& ep : newEndpoints)
+	{
+		if (ep.lastSeenMs != 0)
+			continue;
+		if (modifiedMs == 0)
+			modifiedMs = FileModifiedMs(source.tail.Path());
+		ep.firstSeenMs = ep.lastSeenMs = modifiedMs;
+	}
+
+	// Publish this slice's results right away.
+	source.historyOffset = std::max(source.historyOffset, source.tail.Offset());
+	source.endpointsFound += StoreEndpoints(newEndpoints, alreadyRecorded);
+	return result.bytes;
+}
+
+// Walks the capture in progress for one slice, opening the next queued one
+// when none is. Returns true while capture bytes remain.
+bool RLGrab::StepCapture(const LogTailLimits& limits)
+{
+	if (!captureScanner)
+	{
+		{
+			ProfiledLock lock(capturesMutex);
+			if (pendingCaptures.empty())
 			{
-				newEndpoints.push_back(endpointLabel);
-				seenEndpoints.insert(endpointLabel);
+				captureBacklog = 0;
+				return false;
 			}
+			activeCapture = std::move(pendingCaptures.front());
+			pendingCaptures.erase(pendingCaptures.begin());
+		}
 
-			// Reset currentGameUrl so a single line doesn't repeatedly add.
-			currentGameUrl.clear();
+		auto scanner = std::make_unique<PcapScanner>();
+		std::string error;
+		if (!scanner->Open(activeCapture.path, activeCapture.options, &error))
+		{
+			QueueLog("RLGrab: capture " + activeCapture.path + " not ingested: " + error);
+			return true; // the next queued capture, if any, opens next slice
 		}
+		captureScanner = std::move(scanner);
+		captureBusy = {};
+	}
+
+	auto start = std::chrono::steady_clock::now();
+	bool more = captureScanner->Step(limits.maxBytes, limits.deadline);
+	captureBusy += std::chrono::steady_clock::now() - start;
+	captureBacklog = captureScanner->Remaining();
+	if (more)
+		return true;
+
+	FinishCapture();
+	ProfiledLock lock(capturesMutex);
+	return !pendingCaptures.empty();
+}
+
+void RLGrab::FinishCapture()
+{
+	std::vector<PcapFlow> flows;
+	captureScanner->Finish(flows);
+	const PcapScanStats stats = captureScanner->Stats();
+	captureScanner.reset();
+	captureBacklog = 0;
+
+	// Captures carry no server names; label by GameURL like a nameless log
+	// entry. StoreEndpoints folds them into a named record of the same GameURL.
+	std::vector<EndpointRecord> newEndpoints;
+	for (const auto& flow : flows)
+	{
+		EndpointRecord ep;
+		ep.label = flow.Endpoint();
+		ep.gameUrl = ep.label;
+		ep.source = "pcap";
+		ep.firstSeenMs = flow.firstSeenUs / 1000;
+		ep.lastSeenMs = flow.lastSeenUs / 1000;
+		newEndpoints.push_back(std::move(ep));
 	}
 
+	size_t stored = StoreEndpoints(newEndpoints);
+
+	double elapsed = std::chrono::duration<double>(captureBusy).count();
+	std::ostringstream ss;
+	ss << "RLGrab: capture " << activeCapture.path << ": " << stats.packets << " packets, "
+		<< flows.size() << " game server flow(s), " << stored << " new, "
+		<< (elapsed > 0 ? (double)stats.bytes / elapsed / (1024.0 * 1024.0) : 0.0) << " MiB/s";
+	QueueLog(ss.str());
+}
+
+// The first `alreadyRecorded` records are re-reads whose sightings the
+// history already holds; they still refresh the endpoint list.
+size_t RLGrab::StoreEndpoints(std::vector<EndpointRecord>& newEndpoints, size_t alreadyRecorded)
+{
 	if (newEndpoints.empty())
-		return;
+		return 0;
+
+	// Records arrive timed from their source when it can tell; this is only
+	// the last resort.
+	const uint64_t nowMs = (uint64_t)std::chrono::duration_cast<std::chrono::milliseconds>(
+		std::chrono::system_clock::now().time_since_epoch()).count();
 
 	// Store with newest on top.
 	{
-		std::lock_guard<std::mutex> lock(ipsMutex);
-		for (const auto& ep : newEndpoints)
+		ProfiledLock lock(ipsMutex);
+
+		// Avoid pure duplicates unless the config keeps them; a dropped
+		// duplicate still refreshes the last-seen time of the stored one.
+		size_t kept = 0;
+		for (size_t i = 0; i < newEndpoints.size(); ++i)
+		{
+			EndpointRecord& ep = newEndpoints[i];
+			if (ep.firstSeenMs == 0)
+				ep.firstSeenMs = nowMs;
+			if (ep.lastSeenMs == 0)
+				ep.lastSeenMs = nowMs;
+			if (i >= alreadyRecorded)
+				history.Append(ep.lastSeenMs, ep.serverName, ep.gameUrl, ep.source);
+
+			// Captures carry no server name, so their "ip:port" labels never
+			// match a log record's; a flow is a duplicate of whatever record
+			// already holds its GameURL, named or not.
+			bool alreadySeen = !knownLabels.Accept(ep);
+			uint32_t id;
+			bool found;
+			if (ep.source == "pcap")
+				alreadySeen = found = endpointIndex.FindGameUrl(ep.gameUrl, id);
+			else
+				found = alreadySeen && endpointIndex.FindLabel(ep.label, id);
+			if (!workerConfig->logDuplicates && alreadySeen)
+			{
+				if (found)
+				{
+					EndpointRecord& stored = knownEndpoints[knownEndpoints.size() - 1 - id];
+					stored.lastSeenMs = std::max(stored.lastSeenMs, ep.lastSeenMs);
+					stored.seenCount++;
+					endpointIndex.Touch(id, stored.lastSeenMs);
+					endpointTable.Touch(id, stored);
+				}
+				continue;
+			}
+			if (&newEndpoints[kept] != &ep)
+				newEndpoints[kept] = std::move(ep);
+			kept++;
+		}
+		newEndpoints.resize(kept);
+
+		const uint64_t maxAgeMs = (uint64_t)workerConfig->historyMaxDays * 24 * 3600 * 1000;
+		history.Expire((uint64_t)workerConfig->historyMaxRows, nowMs > maxAgeMs ? nowMs - maxAgeMs : 0);
+
+		for (auto& ep : newEndpoints)
 		{
+			// Tag with the source once more than one can produce endpoints.
+			ep.display = (sourceStatus.size() > 1 || ep.source == "pcap") ? ep.label + "  [" + ep.source + "]" : ep.label;
+
 			// Insert at the beginning so newest appear first.
-			knownEndpoints.insert(knownEndpoints.begin(), ep);
+			knownEndpoints.push_front(ep);
+			uint32_t id = endpointIndex.Insert(ep);
+			searchIndex.Insert(id, ep.display);
+			endpointTable.Insert(id, ep);
 		}
 
+		// ipsMutex also serializes writers of the shared page.
+		for (const auto& ep : newEndpoints)
+			sharedPage.Publish(ep.serverName.c_str(), ep.gameUrl.c_str(), nowMs);
+
 		// Adjust selection to the first/newest if nothing selected yet.
 		if (selectedIndex < 0 && !knownEndpoints.empty())
 		{
 			selectedIndex = 0;
 		}
 	}
+
+	return newEndpoints.size();
 }
 
 // ----------------- BakkesMod lifecycle -----------------
 
 void RLGrab::onLoad()
 {
-	// Defaults
-	pollIntervalMs = 3000; // check every few seconds
-	logDuplicates = false;
+	auto loadStart = std::chrono::steady_clock::now();
 
+	// Defaults live in WorkerConfig; the cvars below start from them.
 	running = true;
+	wakeEvent = CreateEventW(nullptr, FALSE, FALSE, nullptr);
 	inMatch = false;   // no longer used for network state, but kept for compatibility
 	ipScanDone = false; // no longer used to stop scanning, always scanning
 
@@ -217,22 +614,176 @@ void RLGrab::onLoad()
 
 	_globalCvarManager = cvarManager;
 
-	// Initial scan on load
-	ScanLaunchLog();
-
-	// Worker thread: periodically re-read Launch.log
+	// Everything that scales with log size (rules, shared page, the initial
+	// scan) happens in WarmStart on the worker; the list fills in
+	// progressively while the UI shows the warming state.
+	warming = true;
 	workerThread = std::thread([this]() { WorkerLoop(); });
 
-	cvarManager->log("RLGrab loaded (log watcher).");
+	auto loadUs = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - loadStart).count();
+	cvarManager->log("RLGrab loaded (log watcher) in " + std::to_string(loadUs) + " us on the game thread.");
+}
+
+void RLGrab::WarmStart()
+{
+	warmStart = std::chrono::steady_clock::now();
+
+	// Compile the extraction automaton once; scans only run it.
+	LoadExtractionRules();
+
+	if (!sharedPage.Open())
+		QueueLog("RLGrab: shared endpoint page unavailable, overlays will not see updates.");
+
+	// After a `plugin reload`, continue from the previous instance's state
+	// instead of rescanning every log.
+	AdoptHandoffState();
+}
+
+void RLGrab::AdoptHandoffState()
+{
+	HandoffState state;
+	std::string reason;
+	switch (LoadHandoff(DefaultHandoffPath(), state, &reason))
+	{
+	case HandoffResult::Missing:
+		return;
+	case HandoffResult::Rejected:
+		QueueLog("RLGrab: previous state not adopted (" + reason + "), rescanning logs.");
+		return;
+	case HandoffResult::Adopted:
+		break;
+	}
+
+	size_t endpointCount;
+	{
+		ProfiledLock lock(ipsMutex);
+		knownEndpoints.assign(std::make_move_iterator(state.endpoints.begin()), std::make_move_iterator(state.endpoints.end()));
+		endpointCount = knownEndpoints.size();
+		knownLabels.Clear();
+		for (const auto& ep : knownEndpoints)
+			knownLabels.Accept(ep);
+
+		// Ids count from the oldest record.
+		storeGeneration++;
+		endpointIndex.Clear();
+		searchIndex.Clear();
+		endpointTable.Clear();
+		for (auto it = knownEndpoints.rbegin(); it != knownEndpoints.rend(); ++it)
+		{
+			uint32_t id = endpointIndex.Insert(*it);
+			searchIndex.Insert(id, it->display);
+			endpointTable.Insert(id, *it);
+		}
+		if (!history.Load(state.history))
+			QueueLog("RLGrab: previous sighting history was unreadable, starting a new one.");
+		selectedIndex = state.selectedIndex < (int)knownEndpoints.size() ? state.selectedIndex : -1;
+
+		// Refill the overlay page, oldest of the recent ones first.
+		const uint64_t nowMs = (uint64_t)std::chrono::duration_cast<std::chrono::milliseconds>(
+			std::chrono::system_clock::now().time_since_epoch()).count();
+		size_t recent = std::min<size_t>(knownEndpoints.size(), kSharedEndpointHistory);
+		for (size_t i = recent; i-- > 0;)
+			sharedPage.Publish(knownEndpoints[i].serverName.c_str(), knownEndpoints[i].gameUrl.c_str(), nowMs);
+	}
+
+	size_t sourceCount = state.sources.size();
+	{
+		ProfiledLock scanLock(scanMutex);
+		adoptedSources = std::move(state.sources);
+	}
+
+	QueueLog("RLGrab: adopted " + std::to_string(endpointCount) + " endpoints and "
+		+ std::to_string(sourceCount) + " log cursors from the previous instance.");
+}
+
+void RLGrab::SaveHandoffState()
+{
+	HandoffState state;
+	{
+		ProfiledLock lock(ipsMutex);
+		state.endpoints.assign(knownEndpoints.begin(), knownEndpoints.end());
+		state.selectedIndex = selectedIndex;
+		state.history = history.Save();
+	}
+
+	{
+		ProfiledLock scanLock(scanMutex);
+		std::shared_ptr<const ExtractionEngine> engine;
+		{
+			ProfiledLock lock(rulesMutex);
+			engine = extractor;
+		}
+
+		for (const auto& src : logSources)
+		{
+			HandoffSource h;
+			h.name = src->name;
+			h.path = src->tail.Path();
+			h.offset = src->tail.Offset();
+			h.head = src->tail.HeadSignature();
+			h.currentServerName = src->parse.serverName;
+			h.currentGameUrl = src->parse.gameUrl;
+			h.logOpenMs = src->parse.logOpenMs;
+			if (engine && src->parse.extras.size() == engine->FieldCount())
+				for (size_t f = 0; f < src->parse.extras.size(); ++f)
+					if (!src->parse.extras[f].empty())
+						h.extras.emplace_back(engine->FieldName(f), src->parse.extras[f]);
+			h.bytesRead = src->bytesRead;
+			h.endpointsFound = src->endpointsFound;
+			h.restarts = src->restarts;
+			h.historyOffset = src->historyOffset;
+			state.sources.push_back(std::move(h));
+		}
+	}
+
+	std::string error;
+	if (!SaveHandoff(DefaultHandoffPath(), state, &error))
+		cvarManager->log("RLGrab: could not save state for the next load: " + error);
+}
+
+void RLGrab::FinishWarmStart()
+{
+	if (!warming.exchange(false))
+		return;
+
+	uint64_t bytes = 0;
+	{
+		ProfiledLock lock(ipsMutex);
+		for (const auto& st : sourceStatus)
+			bytes += st.bytesRead;
+	}
+	auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - warmStart).count();
+	QueueLog("RLGrab: warm start done in " + std::to_string(ms) + " ms (" + std::to_string(bytes / 1024) + " KiB of logs).");
 }
 
 void RLGrab::onUnload()
 {
+	{
+		ProfiledLock lock(logQueueMutex);
+		unloading = true;
+	}
+	// Game thread: no flush callback can be running right now.
+	logFlushAlive.reset();
+
 	running = false;
 	inMatch = false;
+	WakeWorker();
 
 	if (workerThread.joinable())
 		workerThread.join();
+	StopExport();
+
+	// Worker is gone, so the store and cursors are quiescent.
+	SaveHandoffState();
+	FlushLogQueue();
+
+	sharedPage.Close();
+
+	if (wakeEvent)
+	{
+		CloseHandle(wakeEvent);
+		wakeEvent = nullptr;
+	}
 
 	cvarManager->log("RLGrab unloaded.");
 }
@@ -245,77 +796,519 @@ void RLGrab::SetImGuiContext(uintptr_t ctx)
 
 void RLGrab::RenderSettings()
 {
+	RenderCostScope cost(settingsCost);
+
 	ImGui::TextUnformatted("RL server IPs seen from Launch.log:");
 	ImGui::Separator();
 	RenderIpListUI();
 
 	ImGui::Separator();
 
-	// Basic options
-	int poll = pollIntervalMs;
+	// Basic options. Widgets only set the cvar; its callback publishes the
+	// new config snapshot.
+	auto cfg = config.Current();
+
+	int poll = cfg->pollIntervalMs;
 	if (ImGui::SliderInt("Poll interval (ms)", &poll, 1000, 10000))
 	{
-		pollIntervalMs = poll;
 		auto c = cvarManager->getCvar("rlgrab_poll_interval_ms");
 		if (!c.IsNull())
-			c.setValue(pollIntervalMs);
+			c.setValue(poll);
 	}
 
-	bool logDup = logDuplicates;
+	bool logDup = cfg->logDuplicates;
 	if (ImGui::Checkbox("Keep duplicate endpoints", &logDup))
 	{
-		logDuplicates = logDup;
 		auto c = cvarManager->getCvar("rlgrab_log_duplicates");
 		if (!c.IsNull())
-			c.setValue(logDuplicates);
+			c.setValue(logDup);
+	}
+
+	int cpu = cfg->scanCpuPercent;
+	if (ImGui::SliderInt("Worker CPU share (%)", &cpu, 1, 100))
+	{
+		auto c = cvarManager->getCvar("rlgrab_scan_cpu_percent");
+		if (!c.IsNull())
+			c.setValue(cpu);
+	}
+
+	int budget = cfg->scanBudgetUs;
+	if (ImGui::SliderInt("Slice budget (us)", &budget, 250, 20000))
+	{
+		auto c = cvarManager->getCvar("rlgrab_scan_budget_us");
+		if (!c.IsNull())
+			c.setValue(budget);
 	}
+
+	ImGui::TextDisabled("Worker: %.1f%% CPU, last slice %llu us, backlog %.1f KiB",
+		workerCpuPercent.load(), (unsigned long long)lastSliceUs.load(), backlogBytes.load() / 1024.0);
+
+	RenderLogSourcesUI();
+	RenderThreadQoSUI();
+	RenderExportUI();
+	RenderLockProfileUI();
+	RenderFrameCostUI();
 }
 
 // ----------------- UI -----------------
 
 void RLGrab::RenderIpListUI()
 {
-	std::lock_guard<std::mutex> lock(ipsMutex);
+	RenderCostScope cost(ipListCost);
 
-	if (knownEndpoints.empty())
+	// The copy takes ipsMutex itself, so it runs after the list is drawn.
+	bool copyRequested = false;
 	{
-		ImGui::TextUnformatted("No endpoints found yet. Play a match so Launch.log contains server info.");
+		ProfiledLock lock(ipsMutex);
+
+		if (warming)
+			ImGui::TextDisabled("Warming up: reading existing logs (%.1f KiB left)...", backlogBytes.load() / 1024.0);
+
+		if (knownEndpoints.empty())
+		{
+			if (!warming)
+				ImGui::TextUnformatted("No endpoints found yet. Play a match so Launch.log contains server info.");
+			return;
+		}
+
+		ImGui::PushItemWidth(-1.0f);
+		ImGui::InputTextWithHint("##rlgrab_search", "Filter, e.g. eu 185.60", &searchText);
+
+		// Each keystroke narrows the previous result; rows stored since are
+		// checked on their own.
+		bool searchChanged = search.Update(searchIndex, searchText);
+		const std::vector<uint32_t>* filter = search.Active() ? &search.Results() : nullptr;
+		endpointTable.Update(filter, searchChanged);
+		ImGui::PopItemWidth();
+
+		// Rows map back to knownEndpoints by id.
+		auto indexOf = [this](uint32_t id) { return (int)(knownEndpoints.size() - 1 - id); };
+
+		if (selectedIndex < 0 || selectedIndex >= (int)knownEndpoints.size())
+			selectedIndex = endpointTable.RowCount() ? indexOf(endpointTable.IdAt(0)) : -1;
+
+		if (search.Active())
+			ImGui::Text("Endpoints (%d of %d):", (int)endpointTable.RowCount(), (int)knownEndpoints.size());
+		else
+			ImGui::Text("Endpoints (%d):", (int)endpointTable.RowCount());
+		ImGui::SameLine();
+		ImGui::Checkbox("Group by region##rlgrab_group", &groupEndpoints);
+
+		if (searchChanged)
+			endpointTreeFilterStale = true;
+		if (groupEndpoints)
+			RenderEndpointTree(filter);
+		else
+			RenderEndpointTable(filter);
+
+		copyRequested = ImGui::Button("Copy IP");
+	}
+
+	if (copyRequested)
+		CopySelectedIpToClipboard();
+}
+
+// Caller holds ipsMutex.
+void RLGrab::RenderEndpointTable(const std::vector<uint32_t>* filter)
+{
+	// Rows map back to knownEndpoints by id.
+	auto indexOf = [this](uint32_t id) { return (int)(knownEndpoints.size() - 1 - id); };
+
+	// Header row: a click sorts on the column, another flips the direction.
+	// Until then the rows are newest first.
+	const int columnCount = (int)kEndpointColumnCount;
+	ImGui::Columns(columnCount, "##rlgrab_eps_header");
+	if (!endpointColumnsSized)
+	{
+		static const float weights[kEndpointColumnCount] = { 0.22f, 0.15f, 0.07f, 0.18f, 0.18f, 0.08f, 0.12f };
+		float width = ImGui::GetWindowContentRegionWidth();
+		float offset = 0.0f;
+		for (int c = 0; c < columnCount; ++c)
+		{
+			ImGui::SetColumnOffset(c, offset);
+			offset += weights[c] * width;
+		}
+		endpointColumnsSized = true;
+	}
+	float widths[kEndpointColumnCount];
+	for (int c = 0; c < columnCount; ++c)
+	{
+		EndpointColumn column = (EndpointColumn)c;
+		bool active = endpointTable.Sorted() && endpointTable.SortColumn() == column;
+		std::string header = EndpointColumnName(column);
+		if (active)
+			header += endpointTable.Descending() ? " v" : " ^";
+		if (ImGui::Selectable((header + "##sort").c_str(), active))
+			endpointTable.SetSort(true, column, active ? !endpointTable.Descending() : EndpointColumnDescendingByDefault(column));
+		widths[c] = ImGui::GetColumnWidth(c);
+		ImGui::NextColumn();
+	}
+	ImGui::Columns(1);
+	endpointTable.Update(filter, false);
+
+	// Body: same column widths, only the rows in view are submitted.
+	const float rowHeight = ImGui::GetTextLineHeightWithSpacing();
+	ImGui::PushStyleVar(ImGuiStyleVar_WindowPadding, ImVec2(0.0f, 0.0f));
+	ImGui::BeginChild("##rlgrab_eps", ImVec2(0.0f, rowHeight * 8.0f), false);
+	ImGui::Columns(columnCount, "##rlgrab_eps_rows", false);
+	for (int c = 0; c + 1 < columnCount; ++c)
+		ImGui::SetColumnWidth(c, widths[c]);
+
+	ImGuiListClipper clipper((int)endpointTable.RowCount(), rowHeight);
+	while (clipper.Step())
+	{
+		for (int row = clipper.DisplayStart; row < clipper.DisplayEnd; ++row)
+		{
+			uint32_t id = endpointTable.IdAt((size_t)row);
+			int index = indexOf(id);
+			const EndpointRecord& ep = knownEndpoints[index];
+			std::string_view host, port;
+			SplitGameUrl(ep.gameUrl, host, port);
+			const std::string* region = ep.Field("Region");
+
+			ImGui::PushID((int)id);
+			if (ImGui::Selectable(ep.serverName.empty() ? "-" : ep.serverName.c_str(), index == selectedIndex, ImGuiSelectableFlags_SpanAllColumns))
+				selectedIndex = index;
+			if (ImGui::IsItemHovered() && ep.display != ep.label)
+				ImGui::SetTooltip("%s", ep.display.c_str());
+			ImGui::NextColumn();
+			ImGui::TextUnformatted(host.data(), host.data() + host.size());
+			ImGui::NextColumn();
+			ImGui::TextUnformatted(port.data(), port.data() + port.size());
+			ImGui::NextColumn();
+			ImGui::TextUnformatted(FormatUnixMs(ep.firstSeenMs).c_str());
+			ImGui::NextColumn();
+			ImGui::TextUnformatted(FormatUnixMs(ep.lastSeenMs).c_str());
+			ImGui::NextColumn();
+			ImGui::Text("%u", ep.seenCount);
+			ImGui::NextColumn();
+			ImGui::TextUnformatted(region ? region->c_str() : "");
+			ImGui::NextColumn();
+			ImGui::PopID();
+		}
+	}
+	ImGui::Columns(1);
+	ImGui::EndChild();
+	ImGui::PopStyleVar();
+}
+
+// Caller holds ipsMutex.
+void RLGrab::RenderEndpointTree(const std::vector<uint32_t>* filter)
+{
+	// Built the first time the view is shown, then topped up with the rows
+	// stored since; a new store starts it over.
+	if (endpointTreeGeneration != storeGeneration)
+	{
+		endpointTree.Clear();
+		endpointTreeGeneration = storeGeneration;
+		endpointTreeFilterStale = true;
+	}
+	for (size_t id = endpointTree.Size(); id < knownEndpoints.size(); ++id)
+		endpointTree.Insert((uint32_t)id, knownEndpoints[knownEndpoints.size() - 1 - id]);
+	if (endpointTreeFilterStale)
+	{
+		endpointTree.SetFilter(filter);
+		endpointTreeFilterStale = false;
+	}
+
+	const float rowHeight = ImGui::GetTextLineHeightWithSpacing();
+	ImGui::BeginChild("##rlgrab_eps_tree", ImVec2(0.0f, rowHeight * 9.0f), false);
+	int selectedId = selectedIndex >= 0 ? (int)(knownEndpoints.size() - 1 - (size_t)selectedIndex) : -1;
+	if (endpointTree.Render(selectedId))
+		selectedIndex = (int)(knownEndpoints.size() - 1 - (size_t)selectedId);
+	ImGui::EndChild();
+}
+
+void RLGrab::RenderLogSourcesUI()
+{
+	RenderCostScope cost(logSourcesCost);
+
+	if (!ImGui::CollapsingHeader("Log sources"))
 		return;
+
+	if (!specLoaded)
+	{
+		auto c = cvarManager->getCvar("rlgrab_log_sources");
+		if (!c.IsNull())
+			specEdit = c.getStringValue();
+		specLoaded = true;
+	}
+
+	ImGui::TextUnformatted("name=path;... ('default' = this user's Launch.log, path may be a Logs folder)");
+	ImGui::PushItemWidth(-60.0f);
+	ImGui::InputText("##rlgrab_sources", &specEdit);
+	ImGui::PopItemWidth();
+	ImGui::SameLine();
+	if (ImGui::Button("Apply"))
+	{
+		auto c = cvarManager->getCvar("rlgrab_log_sources");
+		if (!c.IsNull())
+			c.setValue(specEdit);
 	}
 
-	// Build list of labels (newest first)
-	std::vector<const char*> items;
-	items.reserve(knownEndpoints.size());
-	for (const auto& ep : knownEndpoints)
+	ProfiledLock lock(ipsMutex);
+	for (const auto& st : sourceStatus)
 	{
-		items.push_back(ep.c_str());
+		ImGui::Text("%s: %s", st.name.c_str(), st.available ? "watching" : "not found");
+		ImGui::SameLine();
+		ImGui::TextDisabled("%.1f KiB read, %.1f KiB pending, %llu endpoints, %llu restarts",
+			st.bytesRead / 1024.0, st.backlog / 1024.0, (unsigned long long)st.endpointsFound, (unsigned long long)st.restarts);
+		if (ImGui::IsItemHovered())
+			ImGui::SetTooltip("%s", st.path.c_str());
 	}
+}
+
+void RLGrab::RenderThreadQoSUI()
+{
+	RenderCostScope cost(threadQoSCost);
 
-	if (selectedIndex < 0 || selectedIndex >= (int)items.size())
-		selectedIndex = 0;
+	if (!ImGui::CollapsingHeader("Worker scheduling"))
+		return;
 
-	ImGui::Text("Endpoints (%d):", (int)items.size());
-	ImGui::PushItemWidth(-1.0f);
+	const ThreadQoS qos = config.Current()->threadQoS;
 
-	ImGui::ListBox("##rlgrab_eps", &selectedIndex, items.data(), (int)items.size(), 6);
+	static const char* priorities[] = { "Normal", "Below normal", "Lowest", "Idle" };
+	int priority = (int)qos.priority;
+	if (ImGui::Combo("Thread priority", &priority, priorities, IM_ARRAYSIZE(priorities)))
+	{
+		auto c = cvarManager->getCvar("rlgrab_thread_priority");
+		if (!c.IsNull())
+			c.setValue(std::string(ThreadPriorityName((ThreadPriority)priority)));
+	}
+
+	bool backgroundIo = qos.backgroundIo;
+	if (ImGui::Checkbox("Background I/O", &backgroundIo))
+	{
+		auto c = cvarManager->getCvar("rlgrab_thread_background_io");
+		if (!c.IsNull())
+			c.setValue(backgroundIo);
+	}
+
+	if (affinityShown != qos.affinityMask)
+	{
+		affinityEdit = FormatAffinityMask(qos.affinityMask);
+		affinityShown = qos.affinityMask;
+	}
+	ImGui::PushItemWidth(120.0f);
+	ImGui::InputText("Cores##rlgrab_affinity", &affinityEdit);
 	ImGui::PopItemWidth();
+	ImGui::SameLine();
+	if (ImGui::Button("Apply##rlgrab_affinity"))
+	{
+		auto c = cvarManager->getCvar("rlgrab_thread_affinity");
+		if (!c.IsNull())
+			c.setValue(affinityEdit);
+	}
+	ImGui::TextDisabled("Core list like 2-5,7 or a 0x mask; 0 = any of the %u cores.", LogicalCoreCount());
+	if (threadQoSFailed)
+		ImGui::TextDisabled("Last change was only partly applied; see the console.");
+}
+
+void RLGrab::RenderExportUI()
+{
+	RenderCostScope cost(exportCost);
+
+	if (!ImGui::CollapsingHeader("Export"))
+		return;
 
-	if (ImGui::Button("Copy IP"))
+	if (exportRunning)
 	{
-		CopySelectedIpToClipboard();
+		uint64_t total = exportTotal.load();
+		uint64_t rows = exportRows.load();
+		char overlay[64];
+		snprintf(overlay, sizeof(overlay), "%llu / %llu", (unsigned long long)rows, (unsigned long long)total);
+		ImGui::ProgressBar(total ? (float)((double)rows / (double)total) : 0.0f, ImVec2(-80.0f, 0.0f), overlay);
+		ImGui::SameLine();
+		if (ImGui::Button("Cancel"))
+			exportCancel = true;
+	}
+	else
+	{
+		if (ImGui::Button("Export CSV"))
+			StartExport(ExportFormat::Csv, "");
+		ImGui::SameLine();
+		if (ImGui::Button("Export JSONL"))
+			StartExport(ExportFormat::JsonLines, "");
+		ImGui::SameLine();
+		if (ImGui::Button("Export columnar"))
+			StartExport(ExportFormat::Columnar, "");
+	}
+
+	ProfiledLock lock(exportStatusMutex);
+	if (!exportStatus.empty())
+		ImGui::TextWrapped("%s", exportStatus.c_str());
+}
+
+std::vector<ProfiledMutex*> RLGrab::ProfiledLocks()
+{
+	return { &ipsMutex, &scanMutex, &rulesMutex, &capturesMutex, &exportStatusMutex, &logQueueMutex };
+}
+
+void RLGrab::RenderLockProfileUI()
+{
+	RenderCostScope cost(lockProfileCost);
+
+	if (!ImGui::CollapsingHeader("Lock profiling"))
+		return;
+
+	bool enabled = ProfiledMutex::ProfilingEnabled();
+	if (ImGui::Checkbox("Record lock wait/hold times", &enabled))
+	{
+		auto c = cvarManager->getCvar("rlgrab_lock_profiling");
+		if (!c.IsNull())
+			c.setValue(enabled);
+	}
+	ImGui::SameLine();
+	if (ImGui::Button("Reset##locks"))
+	{
+		for (ProfiledMutex* m : ProfiledLocks())
+			m->ResetStats();
+		lockStatsView.clear();
+	}
+
+	// A busy lock keeps its previous row rather than stalling the frame.
+	auto now = std::chrono::steady_clock::now();
+	std::vector<ProfiledMutex*> locks = ProfiledLocks();
+	if (lockStatsView.size() != locks.size() || now - lockStatsRefreshed >= std::chrono::milliseconds(500))
+	{
+		lockStatsView.resize(locks.size());
+		for (size_t i = 0; i < locks.size(); ++i)
+			if (!locks[i]->TrySnapshot(lockStatsView[i]) && lockStatsView[i].name.empty())
+				lockStatsView[i].name = locks[i]->Name();
+		lockStatsRefreshed = now;
+	}
+
+	ImGui::Columns(6, "##rlgrab_locks");
+	ImGui::TextUnformatted("Lock / site"); ImGui::NextColumn();
+	ImGui::TextUnformatted("Locks"); ImGui::NextColumn();
+	ImGui::TextUnformatted("Contended"); ImGui::NextColumn();
+	ImGui::TextUnformatted("Wait p99 (us)"); ImGui::NextColumn();
+	ImGui::TextUnformatted("Hold p99 (us)"); ImGui::NextColumn();
+	ImGui::TextUnformatted("Hold max (us)"); ImGui::NextColumn();
+	ImGui::Separator();
+
+	auto row = [](const LockSiteStats& s)
+		{
+			ImGui::Text("%llu", (unsigned long long)s.acquisitions); ImGui::NextColumn();
+			ImGui::Text("%llu", (unsigned long long)s.contended); ImGui::NextColumn();
+			ImGui::Text("%.1f", s.wait.Quantile(0.99) / 1000.0); ImGui::NextColumn();
+			ImGui::Text("%.1f", s.hold.Quantile(0.99) / 1000.0); ImGui::NextColumn();
+			ImGui::Text("%.1f", s.hold.maxNs / 1000.0); ImGui::NextColumn();
+		};
+
+	for (const LockStats& lock : lockStatsView)
+	{
+		bool open = ImGui::TreeNode(lock.name.c_str());
+		ImGui::NextColumn();
+		row(lock.total);
+		if (!open)
+			continue;
+		for (const LockSiteStats& site : lock.sites)
+		{
+			ImGui::TextDisabled("%s  %s:%u", site.function.c_str(), site.file.c_str(), site.line);
+			ImGui::NextColumn();
+			row(site);
+		}
+		ImGui::TreePop();
+	}
+	ImGui::Columns(1);
+}
+
+std::vector<RenderCostSection*> RLGrab::RenderCostSections()
+{
+	return { &settingsCost, &ipListCost, &logSourcesCost, &threadQoSCost, &exportCost, &lockProfileCost };
+}
+
+void RLGrab::RenderFrameCostUI()
+{
+	if (!ImGui::CollapsingHeader("Render cost"))
+		return;
+
+	bool enabled = RenderCostSection::Enabled();
+	if (ImGui::Checkbox("Measure the settings panel's render functions", &enabled))
+	{
+		auto c = cvarManager->getCvar("rlgrab_render_profiling");
+		if (!c.IsNull())
+			c.setValue(enabled);
+	}
+	ImGui::SameLine();
+	if (ImGui::Button("Reset##rendercost"))
+	{
+		for (RenderCostSection* s : RenderCostSections())
+			s->Reset();
+	}
+
+	ImGui::Combo("Graph", &renderCostMetric, [](void*, int i, const char** out)
+		{
+			*out = RenderMetricName((RenderMetric)i);
+			return true;
+		}, nullptr, (int)kRenderMetricCount);
+
+	// RenderSettings includes the others, this panel too.
+	std::vector<RenderCostSection*> sections = RenderCostSections();
+	size_t n = RenderCostSection::kHistory;
+	for (RenderCostSection* s : sections)
+		n = std::min(n, s->Count());
+
+	if (n >= 2)
+	{
+		static const ImColor colors[] = {
+			ImColor(230, 230, 230), ImColor(90, 170, 255), ImColor(255, 170, 60),
+			ImColor(120, 220, 120), ImColor(230, 90, 200), ImColor(240, 220, 80),
+		};
+		std::vector<std::vector<float>> histories(sections.size());
+		std::vector<const void*> datas;
+		std::vector<const char*> names;
+		float top = 0.0f;
+		for (size_t i = 0; i < sections.size(); ++i)
+		{
+			sections[i]->History((RenderMetric)renderCostMetric, n, histories[i]);
+			top = std::max(top, *std::max_element(histories[i].begin(), histories[i].end()));
+			datas.push_back(histories[i].data());
+			names.push_back(sections[i]->Name());
+		}
+		ImGui::PlotMultiLines("##rlgrab_render_cost", (int)sections.size(), names.data(), colors,
+			[](const void* data, int idx) { return static_cast<const float*>(data)[idx]; },
+			datas.data(), (int)n, 0.0f, top > 0.0f ? top * 1.1f : 1.0f, ImVec2(-1.0f, 120.0f));
+	}
+	else
+	{
+		ImGui::TextDisabled(enabled ? "Collecting samples..." : "Off: turn on measuring to collect samples.");
+	}
+
+	// min / avg / p99 over the graphed history.
+	ImGui::Columns(1 + (int)kRenderMetricCount, "##rlgrab_render_cost_stats");
+	ImGui::TextUnformatted("Function"); ImGui::NextColumn();
+	for (size_t m = 0; m < kRenderMetricCount; ++m)
+	{
+		ImGui::TextUnformatted(RenderMetricName((RenderMetric)m));
+		ImGui::NextColumn();
+	}
+	ImGui::Separator();
+	for (RenderCostSection* s : sections)
+	{
+		ImGui::TextUnformatted(s->Name()); ImGui::NextColumn();
+		for (size_t m = 0; m < kRenderMetricCount; ++m)
+		{
+			RenderCostStats st = s->Stats((RenderMetric)m);
+			ImGui::Text("%.0f / %.0f / %.0f", st.min, st.avg, st.p99);
+			ImGui::NextColumn();
+		}
 	}
+	ImGui::Columns(1);
+	ImGui::TextDisabled("min / avg / p99 over the last %d calls", (int)n);
 }
 
 void RLGrab::CopySelectedIpToClipboard()
 {
 	std::string ipOnly;
 	{
-		std::lock_guard<std::mutex> lock(ipsMutex);
+		ProfiledLock lock(ipsMutex);
 
 		if (knownEndpoints.empty() || selectedIndex < 0 || selectedIndex >= (int)knownEndpoints.size())
 			return;
 
-		std::string endpoint = knownEndpoints[selectedIndex];
+		std::string endpoint = knownEndpoints[selectedIndex].label;
 		ipOnly = ExtractIpOnly(endpoint);
 	}
 
@@ -370,22 +1363,211 @@ void RLGrab::CopySelectedIpToClipboard()
 }
 
 
+// ----------------- Export -----------------
+
+std::filesystem::path RLGrab::GetExportPath(ExportFormat format)
+{
+	std::time_t t = std::time(nullptr);
+	std::tm tm{};
+	localtime_s(&tm, &t);
+	char name[64];
+	std::strftime(name, sizeof(name), "endpoints_%Y%m%d_%H%M%S", &tm);
+	return gameWrapper->GetDataFolder() / "RLGrab" / "exports" / (std::string(name) + ExportFileExtension(format));
+}
+
+bool RLGrab::StartExport(ExportFormat format, std::string path)
+{
+	if (exportRunning)
+	{
+		cvarManager->log("RLGrab: an export is already running.");
+		return false;
+	}
+	if (exportThread.joinable())
+		exportThread.join();
+
+	if (path.empty())
+		path = GetExportPath(format).string();
+	std::error_code ec;
+	std::filesystem::create_directories(std::filesystem::path(path).parent_path(), ec);
+
+	auto request = std::make_shared<ExportRequest>();
+	request->path = path;
+	request->format = format;
+	{
+		ProfiledLock lock(rulesMutex);
+		if (extractor)
+			for (size_t f = 0; f < extractor->FieldCount(); ++f)
+				if (extractor->FieldName(f) != "ServerName" && extractor->FieldName(f) != "GameURL")
+					request->extraColumns.push_back(extractor->FieldName(f));
+	}
+
+	// Rows are read by id in short lock holds; ids stay valid while the list
+	// only grows, and a reset aborts the export instead of mixing stores.
+	uint64_t generation;
+	{
+		ProfiledLock lock(ipsMutex);
+		request->totalRows = knownEndpoints.size();
+		generation = storeGeneration;
+	}
+	request->fetch = [this, generation](uint64_t first, size_t count, std::vector<EndpointRecord>& out)
+		{
+			ProfiledLock lock(ipsMutex);
+			if (storeGeneration != generation || first + count > knownEndpoints.size())
+				return false;
+			for (uint64_t id = first; id < first + count; ++id)
+				out.push_back(knownEndpoints[knownEndpoints.size() - 1 - (size_t)id]);
+			return true;
+		};
+	request->progressRows = &exportRows;
+	request->cancel = &exportCancel;
+
+	exportRows = 0;
+	exportTotal = request->totalRows;
+	exportCancel = false;
+	exportRunning = true;
+	{
+		ProfiledLock lock(exportStatusMutex);
+		exportStatus = "Exporting to " + path;
+	}
+
+	exportThread = std::thread([this, request, qos = config.Current()->threadQoS]()
+		{
+			ApplyThreadQoS(qos, "export");
+			auto start = std::chrono::steady_clock::now();
+			std::string error;
+			bool ok = ExportEndpoints(*request, &error);
+			auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+
+			std::string status = ok
+				? "Exported " + std::to_string(request->totalRows) + " endpoint(s) to " + request->path + " in " + std::to_string(ms) + " ms"
+				: "Export failed: " + error;
+			{
+				ProfiledLock lock(exportStatusMutex);
+				exportStatus = status;
+			}
+			QueueLog("RLGrab: " + status);
+			exportRunning = false;
+		});
+	return true;
+}
+
+void RLGrab::StopExport()
+{
+	exportCancel = true;
+	if (exportThread.joinable())
+		exportThread.join();
+}
+
 // ----------------- CVars / Hooks / Match state -----------------
 
 void RLGrab::RegisterCVars()
 {
-	cvarManager->registerCvar("rlgrab_poll_interval_ms", std::to_string(pollIntervalMs), "Poll interval in milliseconds for Launch.log scan")
+	// Each callback edits one field of a fresh config copy; clamping happens
+	// in WorkerConfig::Normalize.
+	auto defaults = config.Current();
+
+	cvarManager->registerCvar("rlgrab_poll_interval_ms", std::to_string(defaults->pollIntervalMs), "Poll interval in milliseconds for Launch.log scan")
+		.addOnValueChanged([this](std::string, CVarWrapper cvar)
+			{
+				int v = cvar.getIntValue();
+				UpdateConfig([v](WorkerConfig& c) { c.pollIntervalMs = v; });
+			});
+
+	cvarManager->registerCvar("rlgrab_scan_budget_us", std::to_string(defaults->scanBudgetUs), "Max microseconds of log parsing per worker slice")
 		.addOnValueChanged([this](std::string, CVarWrapper cvar)
 			{
 				int v = cvar.getIntValue();
-				if (v < 1000) v = 1000;
-				pollIntervalMs = v;
+				UpdateConfig([v](WorkerConfig& c) { c.scanBudgetUs = v; });
 			});
 
-	cvarManager->registerCvar("rlgrab_log_duplicates", logDuplicates ? "1" : "0", "Keep duplicate endpoints")
+	cvarManager->registerCvar("rlgrab_scan_budget_kb", std::to_string(defaults->scanBudgetKb), "Max KiB of log parsed per worker slice")
 		.addOnValueChanged([this](std::string, CVarWrapper cvar)
 			{
-				logDuplicates = cvar.getBoolValue();
+				int v = cvar.getIntValue();
+				UpdateConfig([v](WorkerConfig& c) { c.scanBudgetKb = v; });
+			});
+
+	cvarManager->registerCvar("rlgrab_scan_cpu_percent", std::to_string(defaults->scanCpuPercent), "Share of one core the worker may use while catching up on a backlog", true, true, 1, true, 100)
+		.addOnValueChanged([this](std::string, CVarWrapper cvar)
+			{
+				int v = cvar.getIntValue();
+				UpdateConfig([v](WorkerConfig& c) { c.scanCpuPercent = v; });
+			});
+
+	cvarManager->registerCvar("rlgrab_log_sources", defaults->logSources,
+		"Launch.log sources to watch: name=path entries separated by ';' (path may be a Logs folder, 'default' = this user's log)")
+		.addOnValueChanged([this](std::string, CVarWrapper cvar)
+			{
+				std::string spec = cvar.getStringValue();
+				UpdateConfig([&spec](WorkerConfig& c) { c.logSources = spec; });
+			});
+
+	cvarManager->registerCvar("rlgrab_log_duplicates", defaults->logDuplicates ? "1" : "0", "Keep duplicate endpoints")
+		.addOnValueChanged([this](std::string, CVarWrapper cvar)
+			{
+				bool v = cvar.getBoolValue();
+				UpdateConfig([v](WorkerConfig& c) { c.logDuplicates = v; });
+			});
+
+	cvarManager->registerCvar("rlgrab_history_max_rows", std::to_string(defaults->historyMaxRows), "Sighting history keeps at most this many sightings, dropping the oldest")
+		.addOnValueChanged([this](std::string, CVarWrapper cvar)
+			{
+				int v = cvar.getIntValue();
+				UpdateConfig([v](WorkerConfig& c) { c.historyMaxRows = v; });
+			});
+
+	cvarManager->registerCvar("rlgrab_history_max_days", std::to_string(defaults->historyMaxDays), "Sighting history drops sightings older than this many days")
+		.addOnValueChanged([this](std::string, CVarWrapper cvar)
+			{
+				int v = cvar.getIntValue();
+				UpdateConfig([v](WorkerConfig& c) { c.historyMaxDays = v; });
+			});
+
+	cvarManager->registerCvar("rlgrab_thread_priority", ThreadPriorityName(defaults->threadQoS.priority),
+		"Priority of the worker and export threads: normal, below_normal, lowest or idle")
+		.addOnValueChanged([this](std::string, CVarWrapper cvar)
+			{
+				ThreadPriority v;
+				if (!ParseThreadPriority(cvar.getStringValue(), v))
+				{
+					cvarManager->log("rlgrab_thread_priority: expected normal, below_normal, lowest or idle");
+					return;
+				}
+				UpdateConfig([v](WorkerConfig& c) { c.threadQoS.priority = v; });
+			});
+
+	cvarManager->registerCvar("rlgrab_thread_background_io", defaults->threadQoS.backgroundIo ? "1" : "0",
+		"Run the worker and export threads in background I/O mode")
+		.addOnValueChanged([this](std::string, CVarWrapper cvar)
+			{
+				bool v = cvar.getBoolValue();
+				UpdateConfig([v](WorkerConfig& c) { c.threadQoS.backgroundIo = v; });
+			});
+
+	cvarManager->registerCvar("rlgrab_thread_affinity", FormatAffinityMask(defaults->threadQoS.affinityMask),
+		"Cores the worker and export threads may run on: list like 2-5,7, hex mask 0x3C, or 0 for any")
+		.addOnValueChanged([this](std::string, CVarWrapper cvar)
+			{
+				uint64_t v;
+				if (!ParseAffinityMask(cvar.getStringValue(), v))
+				{
+					cvarManager->log("rlgrab_thread_affinity: expected a core list like 2-5,7, a hex mask like 0x3C, or 0");
+					return;
+				}
+				UpdateConfig([v](WorkerConfig& c) { c.threadQoS.affinityMask = v; });
+			});
+
+	// Diagnostics, not worker config: flips the process-wide switch directly.
+	cvarManager->registerCvar("rlgrab_lock_profiling", "0", "Record wait and hold times of the plugin's locks (see rlgrab_locks)")
+		.addOnValueChanged([](std::string, CVarWrapper cvar)
+			{
+				ProfiledMutex::SetProfilingEnabled(cvar.getBoolValue());
+			});
+
+	cvarManager->registerCvar("rlgrab_render_profiling", "0", "Measure CPU time and draw list growth of the settings panel's render functions")
+		.addOnValueChanged([](std::string, CVarWrapper cvar)
+			{
+				RenderCostSection::SetEnabled(cvar.getBoolValue());
 			});
 }
 
@@ -394,8 +1576,19 @@ void RLGrab::RegisterNotifiers()
 	// Manual reset
 	cvarManager->registerNotifier("rlgrab_reset",
 		[this](std::vector<std::string>) {
-			std::lock_guard<std::mutex> lock(ipsMutex);
+			// A later rescan then records the log's sightings again.
+			ProfiledLock scanLock(scanMutex);
+			for (auto& src : logSources)
+				src->historyOffset = 0;
+
+			ProfiledLock lock(ipsMutex);
 			knownEndpoints.clear();
+			knownLabels.Clear();
+			endpointIndex.Clear();
+			searchIndex.Clear();
+			endpointTable.Clear();
+			history.Clear();
+			storeGeneration++;
 			selectedIndex = -1;
 		},
 		"Reset RLGrab IP list for current session", PERMISSION_ALL);
@@ -403,9 +1596,177 @@ void RLGrab::RegisterNotifiers()
 	// Optional: force rescan of Launch.log
 	cvarManager->registerNotifier("rlgrab_rescan_log",
 		[this](std::vector<std::string>) {
-			ScanLaunchLog();
+			// Re-read every source from the start on the worker thread.
+			rescanRequested = true;
+			WakeWorker();
 		},
 		"Force immediate rescan of Launch.log", PERMISSION_ALL);
+
+	cvarManager->registerNotifier("rlgrab_reload_rules",
+		[this](std::vector<std::string>) {
+			LoadExtractionRules();
+		},
+		"Recompile Launch.log extraction rules from RLGrab/extraction_rules.txt", PERMISSION_ALL);
+
+	// Offline capture ingestion; parsing runs in slices on the worker thread.
+	cvarManager->registerNotifier("rlgrab_ingest_pcap",
+		[this](std::vector<std::string> args) {
+			const char* usage = "usage: rlgrab_ingest_pcap <file.pcap|file.pcapng> [minPort maxPort]";
+			if (args.size() < 2 || args.size() == 3)
+			{
+				cvarManager->log(usage);
+				return;
+			}
+
+			PendingCapture capture;
+			capture.path = args[1];
+			if (args.size() >= 4)
+			{
+				// An empty or inverted range would ingest nothing without a word.
+				int minPort = std::atoi(args[2].c_str());
+				int maxPort = std::atoi(args[3].c_str());
+				if (minPort < 1 || maxPort > 65535 || minPort > maxPort)
+				{
+					cvarManager->log(usage);
+					return;
+				}
+				capture.options.minServerPort = (uint16_t)minPort;
+				capture.options.maxServerPort = (uint16_t)maxPort;
+			}
+
+			ProfiledLock lock(capturesMutex);
+			pendingCaptures.push_back(std::move(capture));
+			cvarManager->log("RLGrab: queued capture " + args[1]);
+			WakeWorker();
+		},
+		"Ingest game server endpoints from a pcap/pcapng file", PERMISSION_ALL);
+
+	// Streams the whole store to disk on a background thread.
+	cvarManager->registerNotifier("rlgrab_export",
+		[this](std::vector<std::string> args) {
+			ExportFormat format;
+			if (args.size() < 2 || !ParseExportFormat(args[1], format))
+			{
+				cvarManager->log("usage: rlgrab_export <csv|jsonl|bin> [file]");
+				return;
+			}
+			StartExport(format, args.size() >= 3 ? args[2] : "");
+		},
+		"Export stored endpoints as CSV, JSON Lines or columnar binary", PERMISSION_ALL);
+
+	cvarManager->registerNotifier("rlgrab_export_cancel",
+		[this](std::vector<std::string>) {
+			exportCancel = true;
+		},
+		"Cancel a running endpoint export", PERMISSION_ALL);
+
+	// Filtered lookup through the secondary indexes, e.g.
+	//   rlgrab_query name:eu ip:10.0.0.0/8 last>=2h limit:20
+	cvarManager->registerNotifier("rlgrab_query",
+		[this](std::vector<std::string> args) {
+			std::string expression;
+			for (size_t i = 1; i < args.size(); ++i)
+				expression += (i > 1 ? " " : "") + args[i];
+
+			const uint64_t nowMs = (uint64_t)std::chrono::duration_cast<std::chrono::milliseconds>(
+				std::chrono::system_clock::now().time_since_epoch()).count();
+			EndpointFilter filter;
+			std::string error;
+			if (!ParseEndpointFilter(expression, nowMs, filter, &error))
+			{
+				cvarManager->log("rlgrab_query: " + error);
+				cvarManager->log("usage: rlgrab_query [name:<prefix>] [ip:<addr>[/bits]] [first|last(>=|<=|>|<)<30m|2h|7d|YYYY-MM-DD[THH:MM]>] [limit:<n>]");
+				return;
+			}
+
+			std::vector<std::string> lines;
+			EndpointIndex::Result result;
+			auto start = std::chrono::steady_clock::now();
+			{
+				ProfiledLock lock(ipsMutex);
+				result = endpointIndex.Query(filter);
+				for (uint32_t id : result.ids)
+				{
+					const EndpointRecord& ep = knownEndpoints[knownEndpoints.size() - 1 - id];
+					lines.push_back("  " + ep.display + "  first " + FormatUnixMs(ep.firstSeenMs) + "  last " + FormatUnixMs(ep.lastSeenMs));
+				}
+			}
+			auto us = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+
+			for (const auto& line : lines)
+				cvarManager->log(line);
+			cvarManager->log("rlgrab_query: " + std::to_string(result.ids.size()) + (result.truncated ? "+" : "")
+				+ " match(es) via " + result.driver + " index, " + std::to_string(result.candidates) + " candidate(s), "
+				+ std::to_string(us) + " us");
+		},
+		"Query stored endpoints: name:<prefix> ip:<addr>[/bits] first>=<t> last>=<t> limit:<n>", PERMISSION_ALL);
+
+	// Raw sightings over a time range, e.g. rlgrab_history 2h or
+	// rlgrab_history 2026-10-01 2026-10-02 100
+	cvarManager->registerNotifier("rlgrab_history",
+		[this](std::vector<std::string> args) {
+			const uint64_t nowMs = (uint64_t)std::chrono::duration_cast<std::chrono::milliseconds>(
+				std::chrono::system_clock::now().time_since_epoch()).count();
+			uint64_t fromMs = 0, toMs = UINT64_MAX;
+			size_t limit = 50;
+			if ((args.size() >= 2 && !ParseQueryTime(args[1], nowMs, fromMs))
+				|| (args.size() >= 3 && !ParseQueryTime(args[2], nowMs, toMs)))
+			{
+				cvarManager->log("usage: rlgrab_history [from] [to] [limit]  (times: 30m|2h|7d|YYYY-MM-DD[THH:MM]|unix ms)");
+				return;
+			}
+			if (args.size() >= 4)
+				limit = (size_t)std::max(0, std::atoi(args[3].c_str()));
+
+			std::vector<std::string> lines;
+			SightingHistory::Stats stats;
+			auto start = std::chrono::steady_clock::now();
+			{
+				ProfiledLock lock(ipsMutex);
+				// Stops at the limit; nothing past it is decoded.
+				if (limit > 0)
+					history.Query(fromMs, toMs, [&](const HistorySighting& s) {
+						lines.push_back("  " + FormatUnixMs(s.timeMs) + "  " + std::string(s.serverName)
+							+ " (" + s.GameUrl() + ")  [" + std::string(s.source) + "]");
+						return lines.size() < limit;
+					});
+				stats = history.GetStats();
+			}
+			auto us = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+
+			for (const auto& line : lines)
+				cvarManager->log(line);
+			std::ostringstream ss;
+			ss << "rlgrab_history: " << lines.size() << (limit > 0 && lines.size() == limit ? "+" : "") << " of " << stats.rows
+				<< " sighting(s) in " << us << " us; store "
+				<< stats.TotalBytes() / 1024 << " KiB (" << stats.sealedBlocks << " sealed block(s), "
+				<< stats.dictionaryBytes / 1024 << " KiB dictionary)";
+			cvarManager->log(ss.str());
+		},
+		"List endpoint sightings between two times: rlgrab_history [from] [to] [limit]", PERMISSION_ALL);
+
+	// Per-lock and per-call-site wait/hold histograms; "reset" clears them.
+	cvarManager->registerNotifier("rlgrab_locks",
+		[this](std::vector<std::string> args) {
+			if (args.size() >= 2 && args[1] == "reset")
+			{
+				for (ProfiledMutex* m : ProfiledLocks())
+					m->ResetStats();
+				cvarManager->log("rlgrab_locks: statistics cleared");
+				return;
+			}
+
+			if (!ProfiledMutex::ProfilingEnabled())
+				cvarManager->log("rlgrab_locks: profiling is off (rlgrab_lock_profiling 1 to record)");
+			for (ProfiledMutex* m : ProfiledLocks())
+			{
+				LockStats stats = m->Snapshot();
+				cvarManager->log(stats.name + ": " + FormatLockStats(stats.total));
+				for (const auto& site : stats.sites)
+					cvarManager->log("  " + site.function + " (" + site.file + ":" + std::to_string(site.line) + "): " + FormatLockStats(site));
+			}
+		},
+		"Dump lock wait/hold statistics per call site: rlgrab_locks [reset]", PERMISSION_ALL);
 }
 
 void RLGrab::RegisterHooks()
@@ -415,7 +1776,7 @@ void RLGrab::RegisterHooks()
 
 	gameWrapper->HookEvent("Function TAGame.GameEvent_Soccar_TA.PostBeginPlay",
 		[this](std::string) {
-			std::lock_guard<std::mutex> lock(ipsMutex);
+			ProfiledLock lock(ipsMutex);
 			// Optionally: clear on new match
 			// knownEndpoints.clear();
 			// selectedIndex = -1;
@@ -440,11 +1801,192 @@ void RLGrab::OnMatchEnded(std::string)
 
 // ----------------- Worker loop -----------------
 
+void RLGrab::WakeWorker()
+{
+	if (wakeEvent)
+		SetEvent(wakeEvent);
+}
+
+void RLGrab::UpdateConfig(const std::function<void(WorkerConfig&)>& edit)
+{
+	// Scheduling changes (interval, budgets, sources) should not wait out
+	// the current poll interval.
+	if (config.Update(edit))
+		WakeWorker();
+}
+
+void RLGrab::RefreshWorkerConfig()
+{
+	if (!workerConfig || workerConfig->version != config.Version())
+		workerConfig = config.Current();
+}
+
+// Applies to the calling thread; failures are logged, never fatal.
+bool RLGrab::ApplyThreadQoS(const ThreadQoS& qos, const char* threadName)
+{
+	std::string error;
+	if (ApplyCurrentThreadQoS(qos, &error))
+		return true;
+	QueueLog(std::string("RLGrab: ") + threadName + " thread QoS only partly applied: " + error);
+	return false;
+}
+
+// Reports the worker's own CPU time (not time spent blocked in I/O) as a
+// share of one core, over windows of at least a second.
+void RLGrab::UpdateWorkerCpuShare(std::chrono::steady_clock::time_point& windowStart, uint64_t& windowCpuUs)
+{
+	auto now = std::chrono::steady_clock::now();
+	auto wall = now - windowStart;
+	if (wall < std::chrono::seconds(1))
+		return;
+
+	uint64_t cpuUs = CurrentThreadCpuUs();
+	double wallUs = std::chrono::duration<double, std::micro>(wall).count();
+	workerCpuPercent = (float)(100.0 * (double)(cpuUs - windowCpuUs) / wallUs);
+	windowStart = now;
+	windowCpuUs = cpuUs;
+}
+
 void RLGrab::WorkerLoop()
 {
+	// One readiness loop for every source: a change notification per
+	// distinct Logs directory plus the wake event, with the poll interval as
+	// a fallback because Windows may delay notifications for files the game
+	// keeps open.
+	struct DirWatch
+	{
+		std::string dir;
+		HANDLE handle;
+	};
+	std::vector<DirWatch> watches;
+
+	auto closeWatches = [&]()
+		{
+			for (auto& w : watches)
+				if (w.handle != INVALID_HANDLE_VALUE)
+					FindCloseChangeNotification(w.handle);
+			watches.clear();
+		};
+
+	RefreshWorkerConfig();
+	ThreadQoS appliedQoS = workerConfig->threadQoS;
+	threadQoSFailed = !ApplyThreadQoS(appliedQoS, "worker");
+	WarmStart();
+
+	auto windowStart = std::chrono::steady_clock::now();
+	uint64_t windowCpuUs = CurrentThreadCpuUs();
+
 	while (running)
 	{
-		ScanLaunchLog();
-		std::this_thread::sleep_for(std::chrono::milliseconds(pollIntervalMs));
+		auto loopStart = std::chrono::steady_clock::now();
+
+		// Tick boundary: everything below sees one consistent config.
+		RefreshWorkerConfig();
+		const WorkerConfig& cfg = *workerConfig;
+		if (cfg.threadQoS != appliedQoS)
+		{
+			appliedQoS = cfg.threadQoS;
+			threadQoSFailed = !ApplyThreadQoS(appliedQoS, "worker");
+		}
+
+		if (rescanRequested.exchange(false))
+		{
+			ProfiledLock scanLock(scanMutex);
+			for (auto& src : logSources)
+			{
+				src->tail.Reset();
+				src->parse = LaunchLogState();
+				src->ready = true;
+			}
+		}
+
+		// One budgeted slice. With backlog left, rest in proportion to the
+		// time just spent so the worker stays under its CPU share, then
+		// resume from the saved cursor instead of waiting for a change. The
+		// slice's wall time bounds its CPU time from above, and unlike the
+		// thread's tick-granular CPU counter it is exact for slices this short.
+		auto sliceStart = std::chrono::steady_clock::now();
+		LogTailLimits limits;
+		limits.maxBytes = (uint64_t)cfg.scanBudgetKb * 1024;
+		limits.deadline = sliceStart + std::chrono::microseconds(cfg.scanBudgetUs);
+		bool more = ScanLaunchLog(limits);
+		// Queued captures get the rest of the slice; live logs come first.
+		more = StepCapture(limits) || more;
+
+		auto busy = std::chrono::steady_clock::now() - loopStart;
+		lastSliceUs = (uint64_t)std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - sliceStart).count();
+
+		if (more)
+		{
+			int share = cfg.scanCpuPercent;
+			auto rest = busy * (100 - share) / share;
+			DWORD restMs = (DWORD)std::max<long long>(1, std::chrono::duration_cast<std::chrono::milliseconds>(rest).count());
+			WaitForSingleObject(wakeEvent, restMs);
+			UpdateWorkerCpuShare(windowStart, windowCpuUs);
+			continue;
+		}
+
+		// First time every source has caught up with its backlog.
+		FinishWarmStart();
+
+		// Rebuild directory watches when the source set changed.
+		std::vector<std::string> dirs;
+		{
+			ProfiledLock scanLock(scanMutex);
+			for (auto& src : logSources)
+			{
+				std::string dir = LogDirectory(src->tail.Path());
+				if (std::none_of(dirs.begin(), dirs.end(), [&](const std::string& d) { return SameDirectory(d, dir); }))
+					dirs.push_back(dir);
+			}
+		}
+		if (watches.size() != dirs.size()
+			|| !std::equal(dirs.begin(), dirs.end(), watches.begin(), [](const std::string& d, const DirWatch& w) { return d == w.dir; }))
+		{
+			closeWatches();
+			for (const auto& dir : dirs)
+			{
+				std::wstring wdir = std::filesystem::path(dir).wstring();
+				HANDLE h = FindFirstChangeNotificationW(wdir.c_str(), FALSE,
+					FILE_NOTIFY_CHANGE_SIZE | FILE_NOTIFY_CHANGE_LAST_WRITE | FILE_NOTIFY_CHANGE_FILE_NAME);
+				watches.push_back({ dir, h });
+			}
+		}
+
+		std::vector<HANDLE> handles;
+		std::vector<size_t> handleWatch;
+		handles.push_back(wakeEvent);
+		for (size_t i = 0; i < watches.size() && handles.size() < MAXIMUM_WAIT_OBJECTS; ++i)
+		{
+			if (watches[i].handle == INVALID_HANDLE_VALUE)
+				continue;
+			handles.push_back(watches[i].handle);
+			handleWatch.push_back(i);
+		}
+
+		DWORD r = WaitForMultipleObjects((DWORD)handles.size(), handles.data(), FALSE, (DWORD)cfg.pollIntervalMs);
+		if (r == WAIT_FAILED)
+			std::this_thread::sleep_for(std::chrono::milliseconds(cfg.pollIntervalMs));
+		UpdateWorkerCpuShare(windowStart, windowCpuUs);
+
+		ProfiledLock scanLock(scanMutex);
+		if (r > WAIT_OBJECT_0 && r < WAIT_OBJECT_0 + handles.size())
+		{
+			// Only sources directly in the signalled directory need a look; a
+			// sibling like "Logs2" is not inside "Logs".
+			const DirWatch& w = watches[handleWatch[r - WAIT_OBJECT_0 - 1]];
+			FindNextChangeNotification(w.handle);
+			for (auto& src : logSources)
+				if (SameDirectory(LogDirectory(src->tail.Path()), w.dir))
+					src->ready = true;
+		}
+		else
+		{
+			// Timeout or explicit wake: poll everything.
+			for (auto& src : logSources)
+				src->ready = true;
+		}
 	}
+
+	closeWatches();
 }
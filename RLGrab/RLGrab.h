@@ -6,12 +6,34 @@
 #include "bakkesmod/plugin/PluginSettingsWindow.h"
 
 #include "version.h"
+#include "SharedEndpointPage.h"
+#include "PcapReader.h"
+#include "ProfiledMutex.h"
+#include "RenderCost.h"
+#include "LogTail.h"
+#include "EndpointExport.h"
+#include "EndpointQuery.h"
+#include "EndpointSearch.h"
+#include "EndpointTable.h"
+#include "EndpointTree.h"
+#include "EndpointRecord.h"
+#include "ExtractionRules.h"
+#include "LaunchLogParser.h"
+#include "SightingHistory.h"
+#include "StateHandoff.h"
+#include "WorkerConfig.h"
 
 #include <mutex>
 #include <atomic>
 #include <thread>
 #include <vector>
+#include <deque>
 #include <string>
+#include <memory>
+#include <utility>
+#include <filesystem>
+#include <chrono>
+#include <unordered_set>
 
 #include <Windows.h>
 
@@ -28,21 +50,145 @@ public:
 	virtual void SetImGuiContext(uintptr_t ctx) override;
 
 private:
-	// Settings
-	int  pollIntervalMs;    // How often to rescan Launch.log
-	bool logDuplicates;     // If false, only keep unique endpoints
+	// Settings: the game thread publishes snapshots, the worker picks the
+	// latest one up at each tick boundary.
+	WorkerConfigStore config;
+	WorkerConfigStore::Snapshot workerConfig; // worker thread only
+	std::string appliedLogSources;            // worker thread only
+	bool logSourcesApplied = false;           // worker thread only
 
 	// State
 	std::atomic<bool> running;
 	std::atomic<bool> inMatch;     // kept for compatibility, not required by log scanning
 	std::atomic<bool> ipScanDone;  // unused by log scanning, kept for compatibility if needed
+	std::atomic<bool> warming;     // initial background scan still catching up
+	std::chrono::steady_clock::time_point warmStart;
 
 	std::thread workerThread;
 
-	std::mutex ipsMutex;
-	std::vector<std::string> knownEndpoints; // labels, e.g. "ServerName (ip:port)" or "ip:port"
+	ProfiledMutex ipsMutex{ "ipsMutex" };
+	std::deque<EndpointRecord> knownEndpoints; // newest first; label e.g. "ServerName (ip:port)" or "ip:port"
+	EndpointDeduplicator knownLabels;         // dedup index over knownEndpoints
+	EndpointIndex endpointIndex;              // id i is knownEndpoints[size - 1 - i]
+	uint64_t storeGeneration = 0;             // bumped whenever knownEndpoints is cleared or replaced
+	SightingHistory history;                  // every sighting, duplicates included, within retention
+	EndpointSearchIndex searchIndex;          // display text by endpointIndex id
+	EndpointSearch search;                    // list filter state (render thread)
+	EndpointTable endpointTable;              // column sort orders by endpointIndex id
+	EndpointTree endpointTree;                // region/server/address groups, built on first use
+	uint64_t endpointTreeGeneration = UINT64_MAX; // storeGeneration the tree was built from
+	bool endpointTreeFilterStale = true;      // search result changed since the tree last applied it
+	bool groupEndpoints = false;
+	bool endpointColumnsSized = false;        // initial column widths applied
+	std::string searchText;
 	int selectedIndex = -1;
 
+	// Newest endpoint + short history for external overlays (seqlock page).
+	SharedEndpointWriter sharedPage;
+
+	// Capture files queued by rlgrab_ingest_pcap, drained by the worker.
+	struct PendingCapture
+	{
+		std::string path;
+		PcapScanOptions options;
+	};
+	ProfiledMutex capturesMutex{ "capturesMutex" };
+	std::vector<PendingCapture> pendingCaptures;
+
+	// Capture being ingested, walked a slice at a time like a log backlog.
+	// Worker only.
+	PendingCapture activeCapture;
+	std::unique_ptr<PcapScanner> captureScanner;
+	std::chrono::steady_clock::duration captureBusy{}; // time spent in its slices
+	uint64_t captureBacklog = 0;       // unread capture bytes after the last slice
+
+	// Watched Launch.log sources (several installs/profiles). Only the
+	// worker touches them, always under scanMutex.
+	struct LogSource
+	{
+		std::string name;
+		LogTail tail;
+		LaunchLogState parse;          // pairing state carried between polls
+		bool ready = true;             // set by the readiness loop
+		bool available = false;        // last poll could open the file
+		uint64_t bytesRead = 0;
+		uint64_t endpointsFound = 0;
+		uint64_t restarts = 0;
+		uint64_t backlog = 0;          // unread bytes after the last slice
+		uint64_t historyOffset = 0;    // sightings before this byte are already in the history
+	};
+	ProfiledMutex scanMutex{ "scanMutex" };
+	std::vector<std::unique_ptr<LogSource>> logSources;
+	std::vector<HandoffSource> adoptedSources; // cursors from a previous instance, claimed by path
+
+	struct LogSourceStatus
+	{
+		std::string name;
+		std::string path;
+		bool available;
+		uint64_t bytesRead;
+		uint64_t endpointsFound;
+		uint64_t restarts;
+		uint64_t backlog;
+	};
+	std::vector<LogSourceStatus> sourceStatus; // guarded by ipsMutex, read by the UI
+
+	// Compiled Launch.log extraction rules; swapped whole on reload.
+	ProfiledMutex rulesMutex{ "rulesMutex" };
+	std::shared_ptr<const ExtractionEngine> extractor;
+	uint64_t extractorGeneration = 0;
+
+	// Worker load, reported in the settings panel.
+	std::atomic<float> workerCpuPercent{ 0.0f }; // thread CPU time over the last second or so
+	std::atomic<uint64_t> lastSliceUs{ 0 };
+	std::atomic<uint64_t> backlogBytes{ 0 };
+	std::atomic<bool> threadQoSFailed{ false }; // last apply on the worker reported an error
+
+	// Background export (rlgrab_export), one at a time.
+	std::thread exportThread;
+	std::atomic<bool> exportRunning{ false };
+	std::atomic<bool> exportCancel{ false };
+	std::atomic<uint64_t> exportRows{ 0 };
+	std::atomic<uint64_t> exportTotal{ 0 };
+	ProfiledMutex exportStatusMutex{ "exportStatusMutex" };
+	std::string exportStatus;          // last outcome, shown in the settings panel
+
+	// Lock profiling view; refreshed with TrySnapshot so the UI never waits.
+	std::vector<LockStats> lockStatsView;
+	std::chrono::steady_clock::time_point lockStatsRefreshed;
+
+	// Render cost of each settings panel function (rlgrab_render_profiling).
+	RenderCostSection settingsCost{ "RenderSettings" };
+	RenderCostSection ipListCost{ "RenderIpListUI" };
+	RenderCostSection logSourcesCost{ "RenderLogSourcesUI" };
+	RenderCostSection threadQoSCost{ "RenderThreadQoSUI" };
+	RenderCostSection exportCost{ "RenderExportUI" };
+	RenderCostSection lockProfileCost{ "RenderLockProfileUI" };
+	int renderCostMetric = 0;
+
+	// Settings panel edit buffers, filled from their cvars.
+	std::string specEdit;
+	bool specLoaded = false;
+	std::string affinityEdit;
+	uint64_t affinityShown = UINT64_MAX;
+
+	// Console messages from other threads, flushed on the game thread.
+	ProfiledMutex logQueueMutex{ "logQueueMutex" };
+	std::vector<std::string> logQueue;
+	bool logFlushScheduled = false;    // guarded by logQueueMutex
+	bool unloading = false;            // guarded by logQueueMutex; no more flushes get scheduled
+	// Flush callbacks hold a weak reference; onUnload drops this so one
+	// already scheduled does nothing once the plugin is gone.
+	std::shared_ptr<int> logFlushAlive = std::make_shared<int>(0);
+
+	std::atomic<bool> rescanRequested{ false };
+	HANDLE wakeEvent = nullptr;        // auto-reset; wakes the readiness loop
+
+	// cvarManager->log is game-thread only; the worker and export threads
+	// queue their messages and the game thread prints them.
+	void QueueLog(std::string message);
+	void FlushLogQueue();
+
 	// BakkesMod helpers
 	void RegisterCVars();
 	void RegisterNotifiers();
@@ -54,22 +200,53 @@ private:
 
 	// Worker
 	void WorkerLoop();
+	void WarmStart();
+	void AdoptHandoffState();
+	void SaveHandoffState();
+	void FinishWarmStart();
+	void WakeWorker();
+	void UpdateConfig(const std::function<void(WorkerConfig&)>& edit);
+	void RefreshWorkerConfig();
+	bool ApplyThreadQoS(const ThreadQoS& qos, const char* threadName);
+	void UpdateWorkerCpuShare(std::chrono::steady_clock::time_point& windowStart, uint64_t& windowCpuUs);
 
 	// Log-based collection
-	void ScanLaunchLog();
+	bool ScanLaunchLog(const LogTailLimits& limits = LogTailLimits());
+	uint64_t ScanLogSource(LogSource& source, const LogTailLimits& limits);
+	void ApplyLogSources();
+	void AdoptSourceState(LogSource& source);
+	bool StepCapture(const LogTailLimits& limits);
+	void FinishCapture();
+	size_t StoreEndpoints(std::vector<EndpointRecord>& newEndpoints, size_t alreadyRecorded = 0);
+	static std::vector<std::pair<std::string, std::string>> ParseLogSourceSpec(const std::string& spec);
+	void LoadExtractionRules();
+	std::filesystem::path GetRulesPath();
 	static std::string GetDocumentsPath();
 	static std::string GetLaunchLogPath();
-	static void ParseLaunchLogLine(
-		const std::string& line,
-		std::string& outServerName,
-		std::string& outGameUrl);
 
 	// Utilities
 	static std::string Trim(const std::string& s);
 	static bool Contains(const std::vector<std::string>& v, const std::string& value);
 	static std::string ExtractIpOnly(const std::string& endpoint);
+	static uint64_t FileModifiedMs(const std::string& path);
+	static std::string LogDirectory(const std::string& logPath);
+	static bool SameDirectory(const std::string& a, const std::string& b);
 
 	// UI helpers
 	void RenderIpListUI();
+	void RenderEndpointTable(const std::vector<uint32_t>* filter);
+	void RenderEndpointTree(const std::vector<uint32_t>* filter);
+	void RenderLogSourcesUI();
+	void RenderExportUI();
+	void RenderThreadQoSUI();
+	void RenderLockProfileUI();
+	void RenderFrameCostUI();
 	void CopySelectedIpToClipboard();
+	std::vector<ProfiledMutex*> ProfiledLocks();
+	std::vector<RenderCostSection*> RenderCostSections();
+
+	// Export
+	std::filesystem::path GetExportPath(ExportFormat format);
+	bool StartExport(ExportFormat format, std::string path);
+	void StopExport();
 };
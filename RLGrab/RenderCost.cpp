@@ -0,0 +1,126 @@
+#include "pch.h"
+#include "RenderCost.h"
+#include "IMGUI/imgui_internal.h"
+
+#include <algorithm>
+
+namespace
+{
+	std::atomic<bool> renderCostEnabled{ false };
+
+	// Draw list sizes of every window begun this frame. A window begun for
+	// the first time inside a scope had its list cleared by Begin, and was
+	// not counted when the scope opened.
+	void CountDrawLists(uint64_t& vertices, uint64_t& indices, uint64_t& commands)
+	{
+		vertices = indices = commands = 0;
+		ImGuiContext* g = ImGui::GetCurrentContext();
+		if (!g)
+			return;
+		for (ImGuiWindow* window : g->Windows)
+		{
+			if (window->LastFrameActive != g->FrameCount || !window->DrawList)
+				continue;
+			vertices += (uint64_t)window->DrawList->VtxBuffer.Size;
+			indices += (uint64_t)window->DrawList->IdxBuffer.Size;
+			commands += (uint64_t)window->DrawList->CmdBuffer.Size;
+		}
+	}
+
+	float Delta(uint64_t before, uint64_t after)
+	{
+		return after > before ? (float)(after - before) : 0.0f;
+	}
+}
+
+const char* RenderMetricName(RenderMetric metric)
+{
+	switch (metric)
+	{
+	case RenderMetric::CpuUs: return "CPU (us)";
+	case RenderMetric::Vertices: return "Vertices";
+	case RenderMetric::Indices: return "Indices";
+	case RenderMetric::Commands: return "Draw commands";
+	}
+	return "";
+}
+
+// ----------------- RenderCostSection -----------------
+
+void RenderCostSection::SetEnabled(bool enabled)
+{
+	renderCostEnabled.store(enabled, std::memory_order_relaxed);
+}
+
+bool RenderCostSection::Enabled()
+{
+	return renderCostEnabled.load(std::memory_order_relaxed);
+}
+
+void RenderCostSection::Add(const RenderCostSample& sample)
+{
+	samples[next] = sample;
+	next = (next + 1) % kHistory;
+	count = std::min(count + 1, kHistory);
+}
+
+void RenderCostSection::Reset()
+{
+	next = 0;
+	count = 0;
+}
+
+void RenderCostSection::History(RenderMetric metric, size_t n, std::vector<float>& out) const
+{
+	n = std::min(n, count);
+	out.resize(n);
+	size_t first = (next + kHistory - n) % kHistory;
+	for (size_t i = 0; i < n; ++i)
+		out[i] = samples[(first + i) % kHistory][metric];
+}
+
+RenderCostStats RenderCostSection::Stats(RenderMetric metric) const
+{
+	RenderCostStats stats;
+	if (count == 0)
+		return stats;
+
+	std::vector<float> values;
+	History(metric, count, values);
+	std::sort(values.begin(), values.end());
+	double sum = 0.0;
+	for (float v : values)
+		sum += v;
+	stats.min = values.front();
+	stats.avg = (float)(sum / (double)values.size());
+	stats.p99 = values[std::min(values.size() - 1, (size_t)(0.99 * (double)(values.size() - 1) + 0.5))];
+	return stats;
+}
+
+// ----------------- RenderCostScope -----------------
+
+RenderCostScope::RenderCostScope(RenderCostSection& section)
+	: section(RenderCostSection::Enabled() ? &section : nullptr)
+{
+	if (!this->section)
+		return;
+	CountDrawLists(vertices, indices, commands);
+	start = std::chrono::steady_clock::now();
+}
+
+RenderCostScope::~RenderCostScope()
+{
+	if (!section)
+		return;
+	auto end = std::chrono::steady_clock::now();
+
+	uint64_t v, i, c;
+	CountDrawLists(v, i, c);
+
+	RenderCostSample sample;
+	sample.values[(size_t)RenderMetric::CpuUs] = std::chrono::duration<float, std::micro>(end - start).count();
+	sample.values[(size_t)RenderMetric::Vertices] = Delta(vertices, v);
+	sample.values[(size_t)RenderMetric::Indices] = Delta(indices, i);
+	sample.values[(size_t)RenderMetric::Commands] = Delta(commands, c);
+	section->Add(sample);
+}
@@ -0,0 +1,87 @@
+#pragma once
+
+// Per-frame cost of the plugin's render functions.
+//
+// Put a RenderCostScope at the top of a render function and each call
+// records the CPU time it took and what it added to the frame's draw lists:
+// vertices, indices and draw commands, summed over every window drawn this
+// frame so child windows, popups and tooltips opened inside count too. A
+// section keeps its last kHistory calls for the rolling graph; the stats
+// are computed from that history when the panel asks for them.
+//
+// Off until SetEnabled(true); while off a scope is one relaxed atomic load.
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+enum class RenderMetric
+{
+	CpuUs,
+	Vertices,
+	Indices,
+	Commands,
+};
+
+constexpr size_t kRenderMetricCount = 4;
+
+const char* RenderMetricName(RenderMetric metric);
+
+struct RenderCostSample
+{
+	float values[kRenderMetricCount] = {};
+
+	float operator[](RenderMetric metric) const { return values[(size_t)metric]; }
+};
+
+struct RenderCostStats
+{
+	float min = 0.0f;
+	float avg = 0.0f;
+	float p99 = 0.0f;
+};
+
+class RenderCostSection
+{
+public:
+	static constexpr size_t kHistory = 240; // calls, about 4 s at 60 fps
+
+	explicit RenderCostSection(const char* name) : name(name) {}
+
+	static void SetEnabled(bool enabled);
+	static bool Enabled();
+
+	const char* Name() const { return name; }
+	size_t Count() const { return count; }
+
+	void Add(const RenderCostSample& sample);
+	void Reset();
+
+	// The last `n` values of `metric`, oldest first; `n` <= Count().
+	void History(RenderMetric metric, size_t n, std::vector<float>& out) const;
+	RenderCostStats Stats(RenderMetric metric) const;
+
+private:
+	const char* name;
+	RenderCostSample samples[kHistory];
+	size_t next = 0;
+	size_t count = 0;
+};
+
+class RenderCostScope
+{
+public:
+	explicit RenderCostScope(RenderCostSection& section);
+	~RenderCostScope();
+
+	RenderCostScope(const RenderCostScope&) = delete;
+	RenderCostScope& operator=(const RenderCostScope&) = delete;
+
+private:
+	RenderCostSection* section; // null while profiling is off
+	std::chrono::steady_clock::time_point start;
+	uint64_t vertices = 0;
+	uint64_t indices = 0;
+	uint64_t commands = 0;
+};
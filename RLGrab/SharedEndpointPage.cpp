@@ -0,0 +1,127 @@
+#include "SharedEndpointPage.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+// Not compiled with the plugin's precompiled header: this file is shared with
+// external readers and tools and must build without the BakkesMod SDK.
+
+namespace
+{
+	void CopyField(char* dst, size_t dstSize, const char* src)
+	{
+		if (!src)
+			src = "";
+		size_t n = std::strlen(src);
+		if (n >= dstSize)
+			n = dstSize - 1;
+		std::memcpy(dst, src, n);
+		std::memset(dst + n, 0, dstSize - n);
+	}
+}
+
+SharedEndpointWriter::~SharedEndpointWriter()
+{
+	Close();
+}
+
+bool SharedEndpointWriter::Open()
+{
+	if (page)
+		return true;
+
+	void* view = nullptr;
+
+#ifdef _WIN32
+	HANDLE h = CreateFileMappingW(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE, 0, sizeof(SharedEndpointPage), kSharedEndpointName);
+	if (!h)
+		return false;
+
+	view = MapViewOfFile(h, FILE_MAP_ALL_ACCESS, 0, 0, sizeof(SharedEndpointPage));
+	if (!view)
+	{
+		CloseHandle(h);
+		return false;
+	}
+	mapping = h;
+#else
+	int f = shm_open(kSharedEndpointName, O_CREAT | O_RDWR, 0644);
+	if (f < 0)
+		return false;
+
+	if (ftruncate(f, sizeof(SharedEndpointPage)) != 0)
+	{
+		close(f);
+		return false;
+	}
+
+	view = mmap(nullptr, sizeof(SharedEndpointPage), PROT_READ | PROT_WRITE, MAP_SHARED, f, 0);
+	if (view == MAP_FAILED)
+	{
+		close(f);
+		return false;
+	}
+	fd = f;
+#endif
+
+	page = static_cast<SharedEndpointPage*>(view);
+
+	// A previous plugin instance may have left the page behind; readers only
+	// trust it once the header matches, so (re)write the header last.
+	shadow = SharedEndpointPayload{};
+	page->magic = 0;
+	SharedEndpointStore(*page, shadow);
+	page->version = kSharedEndpointVersion;
+	page->payloadSize = sizeof(SharedEndpointPayload);
+	std::atomic_thread_fence(std::memory_order_release);
+	page->magic = kSharedEndpointMagic;
+	return true;
+}
+
+void SharedEndpointWriter::Close()
+{
+	if (!page)
+		return;
+
+#ifdef _WIN32
+	UnmapViewOfFile(page);
+	CloseHandle(static_cast<HANDLE>(mapping));
+	mapping = nullptr;
+#else
+	munmap(page, sizeof(SharedEndpointPage));
+	close(fd);
+	fd = -1;
+	// Leave the name in place: readers keep their mapping and the next
+	// plugin instance reuses it.
+#endif
+
+	page = nullptr;
+}
+
+void SharedEndpointWriter::Publish(const char* serverName, const char* gameUrl, uint64_t seenUnixMs)
+{
+	if (!page)
+		return;
+
+	shadow.totalPublished++;
+
+	SharedEndpointSlot& slot = shadow.latest;
+	CopyField(slot.serverName, sizeof(slot.serverName), serverName);
+	CopyField(slot.gameUrl, sizeof(slot.gameUrl), gameUrl);
+	slot.seenUnixMs = seenUnixMs;
+	slot.serial = shadow.totalPublished;
+
+	if (shadow.historyCount > 0)
+		shadow.historyHead = (shadow.historyHead + 1) % kSharedEndpointHistory;
+	if (shadow.historyCount < kSharedEndpointHistory)
+		shadow.historyCount++;
+	shadow.history[shadow.historyHead] = slot;
+
+	SharedEndpointStore(*page, shadow);
+}
@@ -0,0 +1,135 @@
+#pragma once
+
+// Shared-memory page with the newest endpoint and a short history.
+//
+// The plugin worker is the only writer; any number of external processes
+// (overlays, stream tools) may map the page read-only and poll it at frame
+// rate. Consistency is provided by a seqlock: the writer bumps `sequence` to
+// an odd value, rewrites the payload and bumps it back to even. Readers copy
+// the payload and retry if the sequence changed or was odd. Payload words are
+// accessed through atomic_ref so the concurrent copy is well defined.
+//
+// This header only depends on the standard library so it can be dropped into
+// reader projects as-is (see SharedEndpointReader.h).
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <type_traits>
+
+constexpr uint32_t kSharedEndpointMagic   = 0x53474C52; // "RLGS"
+constexpr uint32_t kSharedEndpointVersion = 1;
+constexpr uint32_t kSharedEndpointHistory = 16;
+
+#ifdef _WIN32
+constexpr const wchar_t* kSharedEndpointName = L"Local\\RLGrabEndpoints";
+#else
+constexpr const char* kSharedEndpointName = "/rlgrab_endpoints";
+#endif
+
+struct SharedEndpointSlot
+{
+	char     serverName[64];   // NUL-terminated, truncated if longer
+	char     gameUrl[64];      // "ip:port", NUL-terminated
+	uint64_t seenUnixMs;       // wall clock when the worker saw it
+	uint64_t serial;           // 1-based publish counter, 0 = empty slot
+};
+
+struct SharedEndpointPayload
+{
+	uint64_t           totalPublished;
+	uint32_t           historyCount;  // valid entries in history, <= kSharedEndpointHistory
+	uint32_t           historyHead;   // index of the newest entry in history
+	SharedEndpointSlot latest;
+	SharedEndpointSlot history[kSharedEndpointHistory];
+};
+
+static_assert(std::is_trivially_copyable_v<SharedEndpointPayload>);
+static_assert(sizeof(SharedEndpointPayload) % sizeof(uint64_t) == 0);
+
+struct SharedEndpointPage
+{
+	uint32_t              magic;
+	uint32_t              version;
+	uint32_t              payloadSize;
+	std::atomic<uint32_t> sequence;
+	alignas(64) uint64_t  words[sizeof(SharedEndpointPayload) / sizeof(uint64_t)];
+};
+
+static_assert(std::atomic<uint32_t>::is_always_lock_free);
+static_assert(std::is_standard_layout_v<SharedEndpointPage>);
+
+// Writer side. Callers must serialize writers themselves.
+inline void SharedEndpointStore(SharedEndpointPage& page, const SharedEndpointPayload& payload)
+{
+	uint64_t src[sizeof(SharedEndpointPayload) / sizeof(uint64_t)];
+	std::memcpy(src, &payload, sizeof(payload));
+
+	uint32_t seq = page.sequence.load(std::memory_order_relaxed);
+	page.sequence.store(seq + 1, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+
+	for (size_t i = 0; i < std::size(src); ++i)
+		std::atomic_ref<uint64_t>(page.words[i]).store(src[i], std::memory_order_relaxed);
+
+	page.sequence.store(seq + 2, std::memory_order_release);
+}
+
+// Reader side. Wait-free: gives up after maxAttempts torn reads instead of
+// spinning on a writer, so a frame never stalls on the plugin.
+inline bool SharedEndpointLoad(const SharedEndpointPage& page, SharedEndpointPayload& out, int maxAttempts = 4)
+{
+	if (page.magic != kSharedEndpointMagic || page.version != kSharedEndpointVersion
+		|| page.payloadSize != sizeof(SharedEndpointPayload))
+		return false;
+
+	uint64_t dst[sizeof(SharedEndpointPayload) / sizeof(uint64_t)];
+	auto& words = const_cast<SharedEndpointPage&>(page).words;
+
+	for (int attempt = 0; attempt < maxAttempts; ++attempt)
+	{
+		uint32_t before = page.sequence.load(std::memory_order_acquire);
+		if (before & 1u)
+			continue;
+
+		for (size_t i = 0; i < std::size(dst); ++i)
+			dst[i] = std::atomic_ref<uint64_t>(words[i]).load(std::memory_order_relaxed);
+
+		std::atomic_thread_fence(std::memory_order_acquire);
+		if (page.sequence.load(std::memory_order_relaxed) == before)
+		{
+			std::memcpy(&out, dst, sizeof(out));
+			return true;
+		}
+	}
+	return false;
+}
+
+// Publishing owner of the named mapping. Lives in the plugin process.
+class SharedEndpointWriter
+{
+public:
+	SharedEndpointWriter() = default;
+	~SharedEndpointWriter();
+	SharedEndpointWriter(const SharedEndpointWriter&) = delete;
+	SharedEndpointWriter& operator=(const SharedEndpointWriter&) = delete;
+
+	bool Open();
+	void Close();
+	bool IsOpen() const { return page != nullptr; }
+
+	// Appends one endpoint to the history and makes it the latest entry.
+	void Publish(const char* serverName, const char* gameUrl, uint64_t seenUnixMs);
+
+private:
+	SharedEndpointPage*   page = nullptr;
+	SharedEndpointPayload shadow{};   // writer-private copy, republished whole
+
+#ifdef _WIN32
+	void* mapping = nullptr;
+#else
+	int fd = -1;
+#endif
+};
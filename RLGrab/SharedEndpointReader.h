@@ -0,0 +1,109 @@
+#pragma once
+
+// Header-only reader for the RLGrab shared endpoint page.
+//
+// Usage from an overlay:
+//
+//     SharedEndpointReader reader;
+//     SharedEndpointPayload snap;
+//     if (reader.Open() && reader.Read(snap))
+//         draw(snap.latest.serverName, snap.latest.gameUrl);
+//
+// Read() never makes a syscall and never blocks on the writer; call Open()
+// again later if the plugin was not loaded yet.
+
+#include "SharedEndpointPage.h"
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+class SharedEndpointReader
+{
+public:
+	SharedEndpointReader() = default;
+	~SharedEndpointReader() { Close(); }
+	SharedEndpointReader(const SharedEndpointReader&) = delete;
+	SharedEndpointReader& operator=(const SharedEndpointReader&) = delete;
+
+	bool Open()
+	{
+		if (page)
+			return true;
+
+#ifdef _WIN32
+		HANDLE h = OpenFileMappingW(FILE_MAP_READ, FALSE, kSharedEndpointName);
+		if (!h)
+			return false;
+		void* view = MapViewOfFile(h, FILE_MAP_READ, 0, 0, sizeof(SharedEndpointPage));
+		if (!view)
+		{
+			CloseHandle(h);
+			return false;
+		}
+		mapping = h;
+#else
+		int f = shm_open(kSharedEndpointName, O_RDONLY, 0);
+		if (f < 0)
+			return false;
+		void* view = mmap(nullptr, sizeof(SharedEndpointPage), PROT_READ, MAP_SHARED, f, 0);
+		close(f);
+		if (view == MAP_FAILED)
+			return false;
+#endif
+
+		page = static_cast<const SharedEndpointPage*>(view);
+		return true;
+	}
+
+	void Close()
+	{
+		if (!page)
+			return;
+#ifdef _WIN32
+		UnmapViewOfFile(page);
+		CloseHandle(static_cast<HANDLE>(mapping));
+		mapping = nullptr;
+#else
+		munmap(const_cast<SharedEndpointPage*>(page), sizeof(SharedEndpointPage));
+#endif
+		page = nullptr;
+	}
+
+	bool IsOpen() const { return page != nullptr; }
+
+	// Consistent snapshot of the page, or false if the page is not valid yet
+	// or the writer kept it busy for every attempt.
+	bool Read(SharedEndpointPayload& out, int maxAttempts = 4) const
+	{
+		return page && SharedEndpointLoad(*page, out, maxAttempts);
+	}
+
+	// Cheap change check: the sequence only moves when the writer publishes.
+	uint32_t Sequence() const
+	{
+		return page ? page->sequence.load(std::memory_order_acquire) : 0;
+	}
+
+	// History entry `age` steps back from the newest (0 = newest).
+	static const SharedEndpointSlot* HistoryAt(const SharedEndpointPayload& snap, uint32_t age)
+	{
+		if (age >= snap.historyCount)
+			return nullptr;
+		uint32_t idx = (snap.historyHead + kSharedEndpointHistory - age) % kSharedEndpointHistory;
+		return &snap.history[idx];
+	}
+
+private:
+	const SharedEndpointPage* page = nullptr;
+#ifdef _WIN32
+	void* mapping = nullptr;
+#endif
+};
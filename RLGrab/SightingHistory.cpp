@@ -0,0 +1,384 @@
+#include "SightingHistory.h"
+#include "BinaryIO.h"
+#include "EndpointQuery.h"
+
+#include <algorithm>
+
+namespace
+{
+	constexpr uint32_t kHistoryVersion = 1;
+
+	// Unpack reads 8 bytes at a time, so every block carries this much slack.
+	constexpr size_t kPackSlack = 8;
+
+	uint8_t BitsFor(uint32_t maxValue)
+	{
+		uint8_t bits = 0;
+		while (bits < 32 && (maxValue >> bits) != 0)
+			++bits;
+		return bits;
+	}
+
+	size_t PackedBytes(size_t rows, uint8_t bits)
+	{
+		return (rows * bits + 7) / 8;
+	}
+
+	template <typename Get>
+	void PackColumn(std::string& out, size_t rows, uint8_t bits, Get get)
+	{
+		if (bits == 0)
+			return;
+		uint64_t acc = 0;
+		unsigned filled = 0;
+		for (size_t i = 0; i < rows; ++i)
+		{
+			acc |= (uint64_t)get(i) << filled;
+			filled += bits;
+			while (filled >= 8)
+			{
+				out.push_back((char)(acc & 0xFF));
+				acc >>= 8;
+				filled -= 8;
+			}
+		}
+		if (filled > 0)
+			out.push_back((char)(acc & 0xFF));
+	}
+
+	uint32_t Unpack(const uint8_t* column, size_t index, uint8_t bits)
+	{
+		if (bits == 0)
+			return 0;
+		size_t bit = index * bits;
+		uint64_t word = LoadLE<uint64_t>(column + (bit >> 3));
+		return (uint32_t)((word >> (bit & 7)) & ((1ull << bits) - 1));
+	}
+}
+
+std::string HistorySighting::GameUrl() const
+{
+	std::string url(address);
+	if (port != 0)
+	{
+		url += ':';
+		url += std::to_string(port);
+	}
+	return url;
+}
+
+void SightingHistory::Clear()
+{
+	strings.clear();
+	stringIds.clear();
+	stringBytes = 0;
+	blocks.clear();
+	open.clear();
+	rows = 0;
+}
+
+uint32_t SightingHistory::Intern(std::string_view s)
+{
+	auto it = stringIds.find(s);
+	if (it != stringIds.end())
+		return it->second;
+
+	uint32_t id = (uint32_t)strings.size();
+	strings.emplace_back(s);
+	stringIds.emplace(std::string_view(strings.back()), id);
+	stringBytes += s.size();
+	return id;
+}
+
+void SightingHistory::Append(uint64_t timeMs, std::string_view serverName, std::string_view gameUrl, std::string_view source)
+{
+	// Only a plain numeric port is split off, and the address keeps its
+	// brackets ("[v6]"), so GameUrl() gives back the original text. Anything
+	// else is kept whole with port 0.
+	std::string_view host, portText;
+	SplitGameUrl(gameUrl, host, portText);
+	std::string_view address = gameUrl;
+	uint16_t port = 0;
+	uint32_t value = 0;
+	bool numeric = !portText.empty() && portText.size() <= 5 && portText[0] != '0';
+	for (char c : portText)
+	{
+		if (c < '0' || c > '9')
+			numeric = false;
+		else
+			value = value * 10 + (uint32_t)(c - '0');
+	}
+	if (numeric && value <= 65535)
+	{
+		address = gameUrl.substr(0, gameUrl.size() - portText.size() - 1);
+		port = (uint16_t)value;
+	}
+
+	open.push_back({ timeMs, Intern(serverName), Intern(address), Intern(source), port });
+	rows++;
+	if (open.size() >= kBlockRows)
+		Seal();
+}
+
+uint64_t SightingHistory::Expire(uint64_t maxRows, uint64_t minTimeMs)
+{
+	size_t drop = 0;
+	uint64_t dropped = 0;
+	while (drop < blocks.size() && (rows - dropped > maxRows || blocks[drop].maxTime < minTimeMs))
+		dropped += blocks[drop++].rows;
+	if (drop == 0)
+		return 0;
+	blocks.erase(blocks.begin(), blocks.begin() + drop);
+	rows -= dropped;
+	return dropped;
+}
+
+void SightingHistory::Seal()
+{
+	if (open.empty())
+		return;
+
+	Block block;
+	block.rows = (uint32_t)open.size();
+	block.minTime = UINT64_MAX;
+	uint32_t maxName = 0, maxAddress = 0, maxSource = 0;
+	uint16_t minPort = UINT16_MAX, maxPort = 0;
+	for (const auto& r : open)
+	{
+		block.minTime = std::min(block.minTime, r.timeMs);
+		block.maxTime = std::max(block.maxTime, r.timeMs);
+		maxName = std::max(maxName, r.name);
+		maxAddress = std::max(maxAddress, r.address);
+		maxSource = std::max(maxSource, r.source);
+		minPort = std::min(minPort, r.port);
+		maxPort = std::max(maxPort, r.port);
+	}
+	block.minPort = minPort;
+	block.nameBits = BitsFor(maxName);
+	block.addressBits = BitsFor(maxAddress);
+	block.portBits = BitsFor((uint32_t)(maxPort - minPort));
+	block.sourceBits = BitsFor(maxSource);
+
+	// Sightings arrive at a fairly steady cadence, so the second difference
+	// of the timestamps is mostly tiny.
+	BinaryWriter times;
+	int64_t previousDelta = 0;
+	for (size_t i = 0; i < open.size(); ++i)
+	{
+		if (i == 0)
+		{
+			times.VarU64(open[0].timeMs);
+			continue;
+		}
+		int64_t delta = (int64_t)(open[i].timeMs - open[i - 1].timeMs);
+		times.VarI64(delta - previousDelta);
+		previousDelta = delta;
+	}
+	block.timeBytes = (uint32_t)times.Size();
+
+	std::string& data = block.data;
+	data.reserve(times.Size() + PackedBytes(open.size(), block.nameBits) + PackedBytes(open.size(), block.addressBits)
+		+ PackedBytes(open.size(), block.portBits) + PackedBytes(open.size(), block.sourceBits) + kPackSlack);
+	data = times.Data();
+	PackColumn(data, open.size(), block.nameBits, [&](size_t i) { return open[i].name; });
+	PackColumn(data, open.size(), block.addressBits, [&](size_t i) { return open[i].address; });
+	PackColumn(data, open.size(), block.portBits, [&](size_t i) { return (uint32_t)(open[i].port - minPort); });
+	PackColumn(data, open.size(), block.sourceBits, [&](size_t i) { return open[i].source; });
+	data.append(kPackSlack, '\0');
+	data.shrink_to_fit();
+
+	blocks.push_back(std::move(block));
+	open.clear();
+}
+
+void SightingHistory::DecodeTimes(const Block& block, std::vector<uint64_t>& times) const
+{
+	times.resize(block.rows);
+	BinaryReader r(block.data.data(), block.timeBytes);
+	uint64_t t = r.VarU64();
+	int64_t delta = 0;
+	times[0] = t;
+	for (uint32_t i = 1; i < block.rows; ++i)
+	{
+		delta += r.VarI64();
+		t += (uint64_t)delta;
+		times[i] = t;
+	}
+}
+
+uint64_t SightingHistory::Query(uint64_t fromMs, uint64_t toMs, const std::function<bool(const HistorySighting&)>& fn) const
+{
+	uint64_t visited = 0;
+	HistorySighting s;
+	std::vector<uint64_t> times;
+
+	for (const Block& block : blocks)
+	{
+		if (block.maxTime < fromMs || block.minTime > toMs)
+			continue;
+
+		DecodeTimes(block, times);
+
+		const uint8_t* base = reinterpret_cast<const uint8_t*>(block.data.data()) + block.timeBytes;
+		const uint8_t* names = base;
+		const uint8_t* addresses = names + PackedBytes(block.rows, block.nameBits);
+		const uint8_t* ports = addresses + PackedBytes(block.rows, block.addressBits);
+		const uint8_t* sources = ports + PackedBytes(block.rows, block.portBits);
+
+		for (uint32_t i = 0; i < block.rows; ++i)
+		{
+			if (times[i] < fromMs || times[i] > toMs)
+				continue;
+			s.timeMs = times[i];
+			s.serverName = strings[Unpack(names, i, block.nameBits)];
+			s.address = strings[Unpack(addresses, i, block.addressBits)];
+			s.port = (uint16_t)(block.minPort + Unpack(ports, i, block.portBits));
+			s.source = strings[Unpack(sources, i, block.sourceBits)];
+			visited++;
+			if (!fn(s))
+				return visited;
+		}
+	}
+
+	for (const OpenRow& r : open)
+	{
+		if (r.timeMs < fromMs || r.timeMs > toMs)
+			continue;
+		s.timeMs = r.timeMs;
+		s.serverName = strings[r.name];
+		s.address = strings[r.address];
+		s.port = r.port;
+		s.source = strings[r.source];
+		visited++;
+		if (!fn(s))
+			return visited;
+	}
+	return visited;
+}
+
+SightingHistory::Stats SightingHistory::GetStats() const
+{
+	Stats st;
+	st.rows = rows;
+	st.sealedBlocks = blocks.size();
+	for (const Block& b : blocks)
+		st.encodedBytes += sizeof(Block) + b.data.capacity();
+	// Each dictionary entry: the string, its deque slot and a hash node.
+	st.dictionaryBytes = stringBytes + strings.size() * (sizeof(std::string) + sizeof(std::string_view) + 3 * sizeof(void*));
+	st.openBytes = open.capacity() * sizeof(OpenRow);
+	return st;
+}
+
+std::string SightingHistory::Save() const
+{
+	BinaryWriter w;
+	w.U32(kHistoryVersion);
+	w.U64(rows);
+
+	w.VarU64(strings.size());
+	for (const auto& s : strings)
+		w.Str(s);
+
+	w.VarU64(blocks.size());
+	for (const Block& b : blocks)
+	{
+		w.U64(b.minTime);
+		w.U64(b.maxTime);
+		w.U32(b.rows);
+		w.U32(b.minPort);
+		w.U8(b.nameBits);
+		w.U8(b.addressBits);
+		w.U8(b.portBits);
+		w.U8(b.sourceBits);
+		w.U32(b.timeBytes);
+		w.Str(b.data);
+	}
+
+	w.VarU64(open.size());
+	for (const OpenRow& r : open)
+	{
+		w.U64(r.timeMs);
+		w.VarU64(r.name);
+		w.VarU64(r.address);
+		w.VarU64(r.source);
+		w.VarU64(r.port);
+	}
+	return std::move(w.Data());
+}
+
+bool SightingHistory::Load(std::string_view data)
+{
+	Clear();
+	auto fail = [&]()
+		{
+			Clear();
+			return false;
+		};
+
+	BinaryReader r(data.data(), data.size());
+	if (r.U32() != kHistoryVersion)
+		return fail();
+	uint64_t totalRows = r.U64();
+
+	uint64_t stringCount = r.VarU64();
+	for (uint64_t i = 0; i < stringCount && r.ok(); ++i)
+		if (Intern(r.StrView()) != i)
+			return fail(); // duplicate dictionary entry
+
+	auto validId = [&](uint64_t id) { return id < strings.size(); };
+
+	uint64_t blockCount = r.VarU64();
+	for (uint64_t i = 0; i < blockCount && r.ok(); ++i)
+	{
+		Block b;
+		b.minTime = r.U64();
+		b.maxTime = r.U64();
+		b.rows = r.U32();
+		b.minPort = (uint16_t)r.U32();
+		b.nameBits = r.U8();
+		b.addressBits = r.U8();
+		b.portBits = r.U8();
+		b.sourceBits = r.U8();
+		b.timeBytes = r.U32();
+		b.data = r.Str();
+
+		size_t expected = (size_t)b.timeBytes + PackedBytes(b.rows, b.nameBits) + PackedBytes(b.rows, b.addressBits)
+			+ PackedBytes(b.rows, b.portBits) + PackedBytes(b.rows, b.sourceBits) + kPackSlack;
+		if (!r.ok() || b.rows == 0 || b.data.size() != expected
+			|| b.nameBits > 32 || b.addressBits > 32 || b.sourceBits > 32 || b.portBits > 16)
+			return fail();
+
+		// Ids decoded later index the dictionary directly; check them once here.
+		const uint8_t* base = reinterpret_cast<const uint8_t*>(b.data.data()) + b.timeBytes;
+		const uint8_t* names = base;
+		const uint8_t* addresses = names + PackedBytes(b.rows, b.nameBits);
+		const uint8_t* sources = addresses + PackedBytes(b.rows, b.addressBits) + PackedBytes(b.rows, b.portBits);
+		for (uint32_t k = 0; k < b.rows; ++k)
+			if (!validId(Unpack(names, k, b.nameBits)) || !validId(Unpack(addresses, k, b.addressBits)) || !validId(Unpack(sources, k, b.sourceBits)))
+				return fail();
+
+		blocks.push_back(std::move(b));
+	}
+
+	uint64_t openCount = r.VarU64();
+	for (uint64_t i = 0; i < openCount && r.ok(); ++i)
+	{
+		OpenRow row;
+		row.timeMs = r.U64();
+		uint64_t name = r.VarU64();
+		uint64_t address = r.VarU64();
+		uint64_t source = r.VarU64();
+		row.port = (uint16_t)r.VarU64();
+		if (!validId(name) || !validId(address) || !validId(source))
+			return fail();
+		row.name = (uint32_t)name;
+		row.address = (uint32_t)address;
+		row.source = (uint32_t)source;
+		open.push_back(row);
+	}
+
+	if (!r.ok() || r.Remaining() != 0)
+		return fail();
+	rows = totalRows;
+	return true;
+}
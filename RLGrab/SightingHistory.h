@@ -0,0 +1,114 @@
+#pragma once
+
+// Every sighting of every endpoint, kept in a compressed columnar layout.
+//
+// The endpoint list keeps one record per label; this store keeps each time
+// a label was seen, which adds up over months. Rows are appended to a small
+// open block and sealed into an immutable encoded block every kBlockRows:
+//   time     delta-of-delta, zigzag varint (first row absolute)
+//   name     dictionary id, bit-packed at the block's widest id
+//   address  dictionary id of the GameURL host part, bit-packed
+//   port     offset from the block's lowest port, bit-packed
+//   source   dictionary id, bit-packed
+// Server names, addresses and sources share one string dictionary.
+//
+// Blocks remember their time range, so a query decodes only the blocks that
+// overlap it, and within a block decodes the fixed-width columns only for
+// the rows whose timestamps fall inside.
+//
+// Portable, no SDK dependencies.
+
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+struct HistorySighting
+{
+	uint64_t timeMs = 0;
+	std::string_view serverName;
+	std::string_view address;  // "1.2.3.4", "[2001:db8::1]" or a whole non ip:port GameURL
+	uint16_t port = 0;         // 0 when the GameURL had none
+	std::string_view source;
+
+	// The GameURL as it was logged.
+	std::string GameUrl() const;
+};
+
+class SightingHistory
+{
+public:
+	static constexpr size_t kBlockRows = 4096;
+
+	struct Stats
+	{
+		uint64_t rows = 0;
+		uint64_t sealedBlocks = 0;
+		uint64_t encodedBytes = 0;    // sealed block payloads
+		uint64_t dictionaryBytes = 0; // strings plus lookup table estimate
+		uint64_t openBytes = 0;       // rows not sealed yet
+		uint64_t TotalBytes() const { return encodedBytes + dictionaryBytes + openBytes; }
+	};
+
+	void Clear();
+	void Append(uint64_t timeMs, std::string_view serverName, std::string_view gameUrl, std::string_view source);
+
+	// Retention: drops sealed blocks from the oldest end while more than
+	// maxRows rows are kept or the block's newest sighting is older than
+	// minTimeMs. The open block is never dropped; dictionary strings stay
+	// (one per distinct name/address, which the endpoint list bounds anyway).
+	// Returns the number of rows dropped.
+	uint64_t Expire(uint64_t maxRows, uint64_t minTimeMs);
+
+	// Calls fn for every sighting with fromMs <= time <= toMs, oldest block
+	// first. Views stay valid until the next Append or Clear. Returns the
+	// number of sightings visited; fn returning false stops the walk.
+	uint64_t Query(uint64_t fromMs, uint64_t toMs, const std::function<bool(const HistorySighting&)>& fn) const;
+
+	Stats GetStats() const;
+	uint64_t Rows() const { return rows; }
+
+	// Self-contained snapshot (dictionary, sealed blocks, open rows) for the
+	// reload handoff; Load replaces the current contents.
+	std::string Save() const;
+	bool Load(std::string_view data);
+
+private:
+	struct Block
+	{
+		uint64_t minTime = 0;
+		uint64_t maxTime = 0;
+		uint32_t rows = 0;
+		uint16_t minPort = 0;
+		uint8_t nameBits = 0;
+		uint8_t addressBits = 0;
+		uint8_t portBits = 0;
+		uint8_t sourceBits = 0;
+		uint32_t timeBytes = 0;  // varint section length; packed columns follow
+		std::string data;
+	};
+
+	struct OpenRow
+	{
+		uint64_t timeMs;
+		uint32_t name;
+		uint32_t address;
+		uint32_t source;
+		uint16_t port;
+	};
+
+	uint32_t Intern(std::string_view s);
+	void Seal();
+	void DecodeTimes(const Block& block, std::vector<uint64_t>& times) const;
+
+	std::deque<std::string> strings;                            // id -> string, stable addresses
+	std::unordered_map<std::string_view, uint32_t> stringIds;   // views into `strings`
+	uint64_t stringBytes = 0;
+
+	std::vector<Block> blocks;
+	std::vector<OpenRow> open;
+	uint64_t rows = 0;
+};
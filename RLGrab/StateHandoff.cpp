@@ -0,0 +1,341 @@
+#include "StateHandoff.h"
+#include "BinaryIO.h"
+#include "MappedFile.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <system_error>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <Windows.h>
+#else
+#include <signal.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+	constexpr uint32_t kHandoffMagic = 0x48474C52; // "RLGH"
+	constexpr uint32_t kHandoffVersion = 1;
+
+	// Describes the payload field order. Any change to what is written below
+	// must change this string, which changes the layout hash and makes older
+	// files fall back to a rescan.
+	constexpr const char* kHandoffLayout =
+		"endpoints[label,serverName,gameUrl,source,display,fields[k,v],firstSeenMs,lastSeenMs,seenCount];"
+		"selectedIndex;"
+		"sources[name,path,offset,head,currentServerName,currentGameUrl,logOpenMs,extras[k,v],bytesRead,endpointsFound,restarts,historyOffset];"
+		"history";
+
+	// A file older than this belongs to a crashed session whose pid was reused.
+	constexpr auto kMaxHandoffAge = std::chrono::minutes(15);
+
+	uint64_t LayoutHash()
+	{
+		std::string_view layout(kHandoffLayout);
+		return Fnv1a64(layout.data(), layout.size());
+	}
+
+	uint64_t NowUnixMs()
+	{
+		return (uint64_t)std::chrono::duration_cast<std::chrono::milliseconds>(
+			std::chrono::system_clock::now().time_since_epoch()).count();
+	}
+
+	struct HandoffHeader
+	{
+		uint32_t magic;
+		uint32_t version;
+		uint64_t layoutHash;
+		uint64_t createdUnixMs;
+		uint64_t payloadSize;
+		uint64_t payloadHash;
+	};
+
+	constexpr const char* kHandoffPrefix = "rlgrab_handoff_";
+
+	bool ProcessAlive(unsigned long pid)
+	{
+#ifdef _WIN32
+		HANDLE process = OpenProcess(SYNCHRONIZE, FALSE, pid);
+		if (!process)
+			return GetLastError() == ERROR_ACCESS_DENIED; // exists, just not ours to open
+		bool alive = WaitForSingleObject(process, 0) == WAIT_TIMEOUT;
+		CloseHandle(process);
+		return alive;
+#else
+		return kill((pid_t)pid, 0) == 0;
+#endif
+	}
+
+	// A game that exits (rather than reloads the plugin) leaves its file
+	// behind. Files of other live games are theirs to adopt, unless they are
+	// too old to be adopted anyway.
+	void SweepStaleHandoffs(const std::filesystem::path& keep)
+	{
+		std::error_code ec;
+		const auto now = std::filesystem::file_time_type::clock::now();
+		for (std::filesystem::directory_iterator it(keep.parent_path(), ec), end; !ec && it != end; it.increment(ec))
+		{
+			std::string name = it->path().filename().string();
+			if (name.compare(0, std::strlen(kHandoffPrefix), kHandoffPrefix) != 0 || it->path() == keep)
+				continue;
+			size_t dot = name.find('.');
+			if (dot == std::string::npos || (name.compare(dot, std::string::npos, ".bin") != 0 && name.compare(dot, std::string::npos, ".bin.tmp") != 0))
+				continue;
+
+			std::error_code fileEc;
+			unsigned long pid = std::strtoul(name.c_str() + std::strlen(kHandoffPrefix), nullptr, 10);
+			auto written = std::filesystem::last_write_time(it->path(), fileEc);
+			bool expired = fileEc || now - written > kMaxHandoffAge;
+			if (expired || !ProcessAlive(pid))
+				std::filesystem::remove(it->path(), fileEc);
+		}
+	}
+
+	void WriteHeader(BinaryWriter& w, const HandoffHeader& h)
+	{
+		w.U32(h.magic);
+		w.U32(h.version);
+		w.U64(h.layoutHash);
+		w.U64(h.createdUnixMs);
+		w.U64(h.payloadSize);
+		w.U64(h.payloadHash);
+	}
+
+	HandoffHeader ReadHeader(BinaryReader& r)
+	{
+		HandoffHeader h;
+		h.magic = r.U32();
+		h.version = r.U32();
+		h.layoutHash = r.U64();
+		h.createdUnixMs = r.U64();
+		h.payloadSize = r.U64();
+		h.payloadHash = r.U64();
+		return h;
+	}
+
+	void WritePairs(BinaryWriter& w, const std::vector<std::pair<std::string, std::string>>& pairs)
+	{
+		w.VarU64(pairs.size());
+		for (const auto& [k, v] : pairs)
+		{
+			w.Str(k);
+			w.Str(v);
+		}
+	}
+
+	void ReadPairs(BinaryReader& r, std::vector<std::pair<std::string, std::string>>& pairs)
+	{
+		uint64_t n = r.VarU64();
+		for (uint64_t i = 0; i < n && r.ok(); ++i)
+		{
+			std::string k = r.Str();
+			std::string v = r.Str();
+			pairs.emplace_back(std::move(k), std::move(v));
+		}
+	}
+}
+
+std::string DefaultHandoffPath()
+{
+#ifdef _WIN32
+	unsigned long pid = GetCurrentProcessId();
+#else
+	unsigned long pid = (unsigned long)getpid();
+#endif
+	std::error_code ec;
+	std::filesystem::path dir = std::filesystem::temp_directory_path(ec);
+	if (ec)
+		dir = ".";
+	return (dir / (kHandoffPrefix + std::to_string(pid) + ".bin")).string();
+}
+
+bool SaveHandoff(const std::string& path, const HandoffState& state, std::string* error)
+{
+	BinaryWriter payload;
+
+	payload.VarU64(state.endpoints.size());
+	for (const auto& ep : state.endpoints)
+	{
+		payload.Str(ep.label);
+		payload.Str(ep.serverName);
+		payload.Str(ep.gameUrl);
+		payload.Str(ep.source);
+		payload.Str(ep.display);
+		WritePairs(payload, ep.fields);
+		payload.U64(ep.firstSeenMs);
+		payload.U64(ep.lastSeenMs);
+		payload.VarU64(ep.seenCount);
+	}
+
+	payload.I32(state.selectedIndex);
+
+	payload.VarU64(state.sources.size());
+	for (const auto& src : state.sources)
+	{
+		payload.Str(src.name);
+		payload.Str(src.path);
+		payload.U64(src.offset);
+		payload.Str(src.head);
+		payload.Str(src.currentServerName);
+		payload.Str(src.currentGameUrl);
+		payload.U64(src.logOpenMs);
+		WritePairs(payload, src.extras);
+		payload.U64(src.bytesRead);
+		payload.U64(src.endpointsFound);
+		payload.U64(src.restarts);
+		payload.U64(src.historyOffset);
+	}
+
+	payload.Str(state.history);
+
+	HandoffHeader header{};
+	header.magic = kHandoffMagic;
+	header.version = kHandoffVersion;
+	header.layoutHash = LayoutHash();
+	header.createdUnixMs = NowUnixMs();
+	header.payloadSize = payload.Size();
+	header.payloadHash = Fnv1a64(payload.Data().data(), payload.Size());
+	BinaryWriter headerBytes;
+	WriteHeader(headerBytes, header);
+
+	// Write-then-rename so a crash mid-write never leaves a half file behind.
+	std::string tmp = path + ".tmp";
+	{
+		std::ofstream out(tmp, std::ios::out | std::ios::binary | std::ios::trunc);
+		if (!out.is_open())
+		{
+			if (error)
+				*error = "cannot create " + tmp;
+			return false;
+		}
+		out.write(headerBytes.Data().data(), (std::streamsize)headerBytes.Size());
+		out.write(payload.Data().data(), (std::streamsize)payload.Size());
+		if (!out)
+		{
+			if (error)
+				*error = "short write to " + tmp;
+			return false;
+		}
+	}
+
+	std::error_code ec;
+	std::filesystem::rename(tmp, path, ec);
+	if (ec)
+	{
+		if (error)
+			*error = "cannot rename " + tmp + ": " + ec.message();
+		std::filesystem::remove(tmp, ec);
+		return false;
+	}
+	return true;
+}
+
+HandoffResult LoadHandoff(const std::string& path, HandoffState& out, std::string* reason)
+{
+	SweepStaleHandoffs(path);
+
+	std::error_code ec;
+	if (!std::filesystem::exists(path, ec))
+		return HandoffResult::Missing;
+
+	HandoffResult result = HandoffResult::Rejected;
+	{
+		MappedFile file;
+		std::string error;
+		if (!file.Open(path, &error))
+		{
+			if (reason)
+				*reason = error;
+		}
+		else
+		{
+			BinaryReader r(file.data(), file.size());
+			HandoffHeader header = ReadHeader(r);
+
+			if (!r.ok() || header.magic != kHandoffMagic)
+			{
+				if (reason)
+					*reason = "not a handoff file";
+			}
+			else if (header.version != kHandoffVersion || header.layoutHash != LayoutHash())
+			{
+				if (reason)
+					*reason = "written by a plugin build with a different state layout";
+			}
+			else if (NowUnixMs() - header.createdUnixMs > (uint64_t)std::chrono::duration_cast<std::chrono::milliseconds>(kMaxHandoffAge).count())
+			{
+				if (reason)
+					*reason = "stale";
+			}
+			else if (header.payloadSize != r.Remaining()
+				|| Fnv1a64(r.Cursor(), r.Remaining()) != header.payloadHash)
+			{
+				if (reason)
+					*reason = "checksum mismatch";
+			}
+			else
+			{
+				HandoffState state;
+
+				uint64_t endpointCount = r.VarU64();
+				for (uint64_t i = 0; i < endpointCount && r.ok(); ++i)
+				{
+					EndpointRecord ep;
+					ep.label = r.Str();
+					ep.serverName = r.Str();
+					ep.gameUrl = r.Str();
+					ep.source = r.Str();
+					ep.display = r.Str();
+					ReadPairs(r, ep.fields);
+					ep.firstSeenMs = r.U64();
+					ep.lastSeenMs = r.U64();
+					ep.seenCount = (uint32_t)r.VarU64();
+					state.endpoints.push_back(std::move(ep));
+				}
+
+				state.selectedIndex = r.I32();
+
+				uint64_t sourceCount = r.VarU64();
+				for (uint64_t i = 0; i < sourceCount && r.ok(); ++i)
+				{
+					HandoffSource src;
+					src.name = r.Str();
+					src.path = r.Str();
+					src.offset = r.U64();
+					src.head = r.Str();
+					src.currentServerName = r.Str();
+					src.currentGameUrl = r.Str();
+					src.logOpenMs = r.U64();
+					ReadPairs(r, src.extras);
+					src.bytesRead = r.U64();
+					src.endpointsFound = r.U64();
+					src.restarts = r.U64();
+					src.historyOffset = r.U64();
+					state.sources.push_back(std::move(src));
+				}
+
+				state.history = r.Str();
+
+				if (r.ok() && r.Remaining() == 0)
+				{
+					out = std::move(state);
+					result = HandoffResult::Adopted;
+				}
+				else if (reason)
+				{
+					*reason = "truncated payload";
+				}
+			}
+		}
+	}
+
+	// One-shot: adopted or not, the next load must not see it again.
+	std::filesystem::remove(path, ec);
+	return result;
+}
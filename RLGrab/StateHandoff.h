@@ -0,0 +1,65 @@
+#pragma once
+
+// State handed from one plugin instance to the next across
+// `plugin reload rlgrab`.
+//
+// onUnload writes the endpoint store, sighting history, per-source tail
+// offsets and parser state to a small binary file keyed by the game's
+// process id; the next instance maps it, checks magic, format version,
+// layout tag and checksum, and adopts it instead of rescanning. Anything that does not match is
+// rejected and the normal warm start runs.
+//
+// Adoption is linear in the store: every record is decoded and indexed once.
+// That is still far cheaper than rescanning the logs the records came from,
+// and it runs on the worker while the UI shows the warming state.
+//
+// Portable, no SDK dependencies.
+
+#include "EndpointRecord.h"
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+struct HandoffSource
+{
+	std::string name;
+	std::string path;
+	uint64_t    offset = 0;        // LogTail cursor
+	std::string head;              // LogTail head signature
+	std::string currentServerName; // pairing state
+	std::string currentGameUrl;
+	uint64_t    logOpenMs = 0;     // times the lines after the cursor
+	std::vector<std::pair<std::string, std::string>> extras; // sticky rule fields by name
+	uint64_t    bytesRead = 0;
+	uint64_t    endpointsFound = 0;
+	uint64_t    restarts = 0;
+	uint64_t    historyOffset = 0; // sightings before this byte are in the history
+};
+
+struct HandoffState
+{
+	std::vector<EndpointRecord> endpoints; // newest first
+	int32_t selectedIndex = -1;
+	std::vector<HandoffSource> sources;
+	std::string history; // SightingHistory::Save()
+};
+
+enum class HandoffResult
+{
+	Missing,  // nothing to adopt
+	Adopted,
+	Rejected, // present but stale, corrupt or from another layout
+};
+
+// %TEMP%/rlgrab_handoff_<pid>.bin: one per game process, so concurrent games
+// never adopt each other's state.
+std::string DefaultHandoffPath();
+
+bool SaveHandoff(const std::string& path, const HandoffState& state, std::string* error = nullptr);
+
+// Loads and deletes the handoff file, adopted or not. Files left by games
+// that exited, or too old to be adopted, are deleted along the way.
+// `reason` explains a rejection.
+HandoffResult LoadHandoff(const std::string& path, HandoffState& out, std::string* reason = nullptr);
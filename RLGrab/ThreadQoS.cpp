@@ -0,0 +1,292 @@
+#include "ThreadQoS.h"
+
+#include <cctype>
+#include <cstdlib>
+#include <thread>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <Windows.h>
+#elif defined(__linux__)
+#include <sched.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+#endif
+
+namespace
+{
+	void AddError(std::string* error, const std::string& what)
+	{
+		if (!error)
+			return;
+		if (!error->empty())
+			*error += "; ";
+		*error += what;
+	}
+
+#ifdef _WIN32
+	thread_local bool inBackgroundMode = false;
+
+	int WindowsPriority(ThreadPriority priority)
+	{
+		switch (priority)
+		{
+		case ThreadPriority::Normal: return THREAD_PRIORITY_NORMAL;
+		case ThreadPriority::BelowNormal: return THREAD_PRIORITY_BELOW_NORMAL;
+		case ThreadPriority::Lowest: return THREAD_PRIORITY_LOWEST;
+		case ThreadPriority::Idle: return THREAD_PRIORITY_IDLE;
+		}
+		return THREAD_PRIORITY_NORMAL;
+	}
+#elif defined(__linux__)
+	// linux/ioprio.h is not always installed; the ABI is stable.
+	constexpr int kIoprioWhoProcess = 1;
+	constexpr int kIoprioClassShift = 13;
+	constexpr int kIoprioClassNone = 0;
+	constexpr int kIoprioClassIdle = 3;
+
+	int NiceValue(ThreadPriority priority)
+	{
+		switch (priority)
+		{
+		case ThreadPriority::Normal: return 0;
+		case ThreadPriority::BelowNormal: return 5;
+		case ThreadPriority::Lowest: return 10;
+		case ThreadPriority::Idle: return 19;
+		}
+		return 0;
+	}
+#endif
+}
+
+bool ParseThreadPriority(const std::string& text, ThreadPriority& out)
+{
+	std::string s;
+	for (char c : text)
+		if (!std::isspace((unsigned char)c))
+			s += (char)std::tolower((unsigned char)c);
+
+	if (s == "normal" || s == "0")
+		out = ThreadPriority::Normal;
+	else if (s == "below_normal" || s == "belownormal" || s == "1")
+		out = ThreadPriority::BelowNormal;
+	else if (s == "lowest" || s == "2")
+		out = ThreadPriority::Lowest;
+	else if (s == "idle" || s == "3")
+		out = ThreadPriority::Idle;
+	else
+		return false;
+	return true;
+}
+
+const char* ThreadPriorityName(ThreadPriority priority)
+{
+	switch (priority)
+	{
+	case ThreadPriority::Normal: return "normal";
+	case ThreadPriority::BelowNormal: return "below_normal";
+	case ThreadPriority::Lowest: return "lowest";
+	case ThreadPriority::Idle: return "idle";
+	}
+	return "normal";
+}
+
+bool ParseAffinityMask(const std::string& text, uint64_t& out)
+{
+	std::string s;
+	for (char c : text)
+		if (!std::isspace((unsigned char)c))
+			s += c;
+
+	if (s.empty() || s == "0")
+	{
+		out = 0;
+		return true;
+	}
+
+	if (s.size() > 2 && s[0] == '0' && (s[1] == 'x' || s[1] == 'X'))
+	{
+		if (s.size() > 18)
+			return false;
+		char* end = nullptr;
+		out = std::strtoull(s.c_str() + 2, &end, 16);
+		return end && *end == '\0';
+	}
+
+	// Core list: "2-5,7"
+	uint64_t mask = 0;
+	size_t pos = 0;
+	while (pos < s.size())
+	{
+		size_t comma = s.find(',', pos);
+		std::string item = s.substr(pos, comma == std::string::npos ? std::string::npos : comma - pos);
+		pos = comma == std::string::npos ? s.size() : comma + 1;
+
+		size_t dash = item.find('-');
+		std::string a = item.substr(0, dash);
+		std::string b = dash == std::string::npos ? a : item.substr(dash + 1);
+		if (a.empty() || b.empty() || a.size() > 2 || b.size() > 2
+			|| a.find_first_not_of("0123456789") != std::string::npos || b.find_first_not_of("0123456789") != std::string::npos)
+			return false;
+
+		int first = std::atoi(a.c_str());
+		int last = std::atoi(b.c_str());
+		if (first > last || last > 63)
+			return false;
+		for (int core = first; core <= last; ++core)
+			mask |= 1ull << core;
+	}
+	out = mask;
+	return true;
+}
+
+std::string FormatAffinityMask(uint64_t mask)
+{
+	if (mask == 0)
+		return "0";
+
+	// Back to a core list, which is what people type.
+	std::string out;
+	for (int core = 0; core < 64;)
+	{
+		if (!(mask & (1ull << core)))
+		{
+			++core;
+			continue;
+		}
+		int last = core;
+		while (last + 1 < 64 && (mask & (1ull << (last + 1))))
+			++last;
+		if (!out.empty())
+			out += ',';
+		out += std::to_string(core);
+		if (last > core)
+			out += "-" + std::to_string(last);
+		core = last + 1;
+	}
+	return out;
+}
+
+unsigned LogicalCoreCount()
+{
+	unsigned n = std::thread::hardware_concurrency();
+	return n ? n : 1;
+}
+
+#ifdef _WIN32
+
+uint64_t CurrentThreadCpuUs()
+{
+	FILETIME created, exited, kernel, user;
+	if (!GetThreadTimes(GetCurrentThread(), &created, &exited, &kernel, &user))
+		return 0;
+	auto ticks = [](const FILETIME& t) { return ((uint64_t)t.dwHighDateTime << 32) | t.dwLowDateTime; };
+	return (ticks(kernel) + ticks(user)) / 10; // 100 ns units
+}
+
+bool ApplyCurrentThreadQoS(const ThreadQoS& qos, std::string* error)
+{
+	bool ok = true;
+	HANDLE self = GetCurrentThread();
+
+	// Background mode first: it resets the CPU priority, which is set after.
+	if (qos.backgroundIo != inBackgroundMode)
+	{
+		if (SetThreadPriority(self, qos.backgroundIo ? THREAD_MODE_BACKGROUND_BEGIN : THREAD_MODE_BACKGROUND_END))
+			inBackgroundMode = qos.backgroundIo;
+		else
+		{
+			ok = false;
+			AddError(error, "background mode: error " + std::to_string(GetLastError()));
+		}
+	}
+
+	if (!SetThreadPriority(self, WindowsPriority(qos.priority)))
+	{
+		ok = false;
+		AddError(error, "priority: error " + std::to_string(GetLastError()));
+	}
+
+	DWORD_PTR processMask = 0, systemMask = 0;
+	if (!GetProcessAffinityMask(GetCurrentProcess(), &processMask, &systemMask))
+		processMask = (DWORD_PTR)-1;
+	DWORD_PTR mask = qos.affinityMask ? (DWORD_PTR)qos.affinityMask & processMask : processMask;
+	if (mask == 0)
+	{
+		ok = false;
+		AddError(error, "affinity: no allowed core in " + FormatAffinityMask(qos.affinityMask));
+	}
+	else if (!SetThreadAffinityMask(self, mask))
+	{
+		ok = false;
+		AddError(error, "affinity: error " + std::to_string(GetLastError()));
+	}
+	return ok;
+}
+
+#elif defined(__linux__)
+
+uint64_t CurrentThreadCpuUs()
+{
+	timespec ts;
+	if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts) != 0)
+		return 0;
+	return (uint64_t)ts.tv_sec * 1000000 + (uint64_t)ts.tv_nsec / 1000;
+}
+
+bool ApplyCurrentThreadQoS(const ThreadQoS& qos, std::string* error)
+{
+	bool ok = true;
+	const pid_t tid = (pid_t)syscall(SYS_gettid);
+
+	// Per-thread on Linux: the nice value of a tid applies to that thread only.
+	if (setpriority(PRIO_PROCESS, (id_t)tid, NiceValue(qos.priority)) != 0)
+	{
+		ok = false;
+		AddError(error, std::string("priority: ") + std::strerror(errno));
+	}
+
+	int ioClass = qos.backgroundIo ? kIoprioClassIdle : kIoprioClassNone;
+	if (syscall(SYS_ioprio_set, kIoprioWhoProcess, tid, ioClass << kIoprioClassShift) != 0)
+	{
+		ok = false;
+		AddError(error, std::string("I/O priority: ") + std::strerror(errno));
+	}
+
+	cpu_set_t set;
+	CPU_ZERO(&set);
+	unsigned cores = LogicalCoreCount();
+	for (unsigned core = 0; core < cores && core < CPU_SETSIZE; ++core)
+		if (qos.affinityMask == 0 || (core < 64 && (qos.affinityMask & (1ull << core))))
+			CPU_SET(core, &set);
+	if (CPU_COUNT(&set) == 0)
+	{
+		ok = false;
+		AddError(error, "affinity: no allowed core in " + FormatAffinityMask(qos.affinityMask));
+	}
+	else if (sched_setaffinity(0, sizeof(set), &set) != 0)
+	{
+		ok = false;
+		AddError(error, std::string("affinity: ") + std::strerror(errno));
+	}
+	return ok;
+}
+
+#else
+
+uint64_t CurrentThreadCpuUs()
+{
+	return 0;
+}
+
+bool ApplyCurrentThreadQoS(const ThreadQoS&, std::string* error)
+{
+	AddError(error, "thread QoS is not supported on this platform");
+	return false;
+}
+
+#endif
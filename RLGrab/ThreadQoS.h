@@ -0,0 +1,55 @@
+#pragma once
+
+// Scheduling class for background threads: CPU priority, I/O priority and
+// core affinity, applied by a thread to itself.
+//
+// Windows uses SetThreadPriority, THREAD_MODE_BACKGROUND_BEGIN/END (low I/O
+// and memory priority) and SetThreadAffinityMask; Linux uses the thread's
+// nice value, ioprio_set and sched_setaffinity. Background mode and the
+// previous settings are tracked per thread, so applying a new QoS to a
+// thread that already has one moves it in either direction.
+//
+// Portable, no SDK dependencies.
+
+#include <cstdint>
+#include <string>
+
+enum class ThreadPriority
+{
+	Normal,
+	BelowNormal,
+	Lowest,
+	Idle,
+};
+
+struct ThreadQoS
+{
+	ThreadPriority priority = ThreadPriority::BelowNormal;
+	bool backgroundIo = true;   // lowest I/O (and on Windows memory) priority
+	uint64_t affinityMask = 0;  // bit n = logical core n; 0 = any core
+
+	bool operator==(const ThreadQoS& other) const
+	{
+		return priority == other.priority && backgroundIo == other.backgroundIo && affinityMask == other.affinityMask;
+	}
+	bool operator!=(const ThreadQoS& other) const { return !(*this == other); }
+};
+
+// "normal", "below_normal", "lowest" or "idle".
+bool ParseThreadPriority(const std::string& text, ThreadPriority& out);
+const char* ThreadPriorityName(ThreadPriority priority);
+
+// "" or "0" = any core, "0xF0" = hex mask, "2-5,7" = core list (cores 0..63).
+bool ParseAffinityMask(const std::string& text, uint64_t& out);
+std::string FormatAffinityMask(uint64_t mask);
+
+unsigned LogicalCoreCount();
+
+// CPU time (user + kernel) the calling thread has used so far, in
+// microseconds; 0 where the platform cannot tell. Windows counts it in
+// scheduler ticks, so only differences over a second or so are meaningful.
+uint64_t CurrentThreadCpuUs();
+
+// Applies `qos` to the calling thread. Each part is attempted; `error`
+// collects what failed (e.g. raising priority without the right on Linux).
+bool ApplyCurrentThreadQoS(const ThreadQoS& qos, std::string* error = nullptr);
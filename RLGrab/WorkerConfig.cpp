@@ -0,0 +1,53 @@
+#include "WorkerConfig.h"
+
+#include <algorithm>
+
+void WorkerConfig::Normalize()
+{
+	pollIntervalMs = std::clamp(pollIntervalMs, 1000, 60000);
+	scanBudgetUs = std::clamp(scanBudgetUs, 250, 1000000);
+	scanBudgetKb = std::clamp(scanBudgetKb, 16, 1024 * 1024);
+	scanCpuPercent = std::clamp(scanCpuPercent, 1, 100);
+	historyMaxRows = std::clamp(historyMaxRows, 10000, 100000000);
+	historyMaxDays = std::clamp(historyMaxDays, 1, 3650);
+	if (logSources.empty())
+		logSources = "default";
+}
+
+bool WorkerConfig::AffectsScheduling(const WorkerConfig& previous) const
+{
+	return pollIntervalMs != previous.pollIntervalMs
+		|| scanBudgetUs != previous.scanBudgetUs
+		|| scanBudgetKb != previous.scanBudgetKb
+		|| scanCpuPercent != previous.scanCpuPercent
+		|| logSources != previous.logSources
+		|| threadQoS != previous.threadQoS;
+}
+
+WorkerConfigStore::WorkerConfigStore()
+	: current(std::make_shared<const WorkerConfig>())
+{
+}
+
+WorkerConfigStore::Snapshot WorkerConfigStore::Current() const
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	return current;
+}
+
+bool WorkerConfigStore::Update(const std::function<void(WorkerConfig&)>& edit)
+{
+	std::lock_guard<std::mutex> lock(mutex);
+
+	auto next = std::make_shared<WorkerConfig>(*current);
+	edit(*next);
+	next->Normalize();
+	if (static_cast<const WorkerSettings&>(*next) == *current)
+		return false;
+
+	next->version = current->version + 1;
+	bool wake = next->AffectsScheduling(*current);
+	current = std::move(next);
+	version.store(current->version, std::memory_order_release);
+	return wake;
+}
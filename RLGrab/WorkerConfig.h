@@ -0,0 +1,74 @@
+#pragma once
+
+// Worker settings as immutable, versioned snapshots.
+//
+// The game thread (cvar callbacks, settings UI) edits a copy and publishes it
+// whole; the worker takes the current snapshot at each tick boundary and
+// reads nothing else for the rest of that tick. New tunables are just new
+// fields here, never new shared members on the plugin.
+//
+// Portable, no SDK dependencies.
+
+#include "ThreadQoS.h"
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+
+// The tunables themselves. Publishing compares these as a whole, so a new
+// field here is picked up without touching WorkerConfigStore::Update.
+struct WorkerSettings
+{
+	int  pollIntervalMs = 3000;         // idle wait between readiness checks
+	bool logDuplicates = false;         // keep endpoints already in the list
+	int  scanBudgetUs = 4000;           // per-slice parsing budget (time)
+	int  scanBudgetKb = 1024;           // per-slice parsing budget (bytes)
+	int  scanCpuPercent = 25;           // worker CPU cap while a backlog is pending
+	std::string logSources = "default"; // rlgrab_log_sources spec
+	int  historyMaxRows = 2000000;      // sighting history retention (rows)
+	int  historyMaxDays = 90;           // sighting history retention (age)
+	ThreadQoS threadQoS;                // worker and export threads
+
+	bool operator==(const WorkerSettings& other) const = default;
+};
+
+struct WorkerConfig : WorkerSettings
+{
+	uint64_t version = 0;               // bumped on every published change
+
+	// Clamps every field into its valid range.
+	void Normalize();
+
+	// True if going from `previous` to this changes how the worker sleeps or
+	// what it watches, i.e. the worker should be woken rather than wait out
+	// its current interval.
+	bool AffectsScheduling(const WorkerConfig& previous) const;
+};
+
+class WorkerConfigStore
+{
+public:
+	using Snapshot = std::shared_ptr<const WorkerConfig>;
+
+	WorkerConfigStore();
+
+	// Current snapshot; never null. Cheap enough to call every tick.
+	Snapshot Current() const;
+
+	// Version of the current snapshot without taking the lock, so a reader
+	// can tell whether its copy is stale.
+	uint64_t Version() const { return version.load(std::memory_order_acquire); }
+
+	// Applies `edit` to a copy of the current config, normalizes it and
+	// publishes it as a new version. Returns true if the change affects
+	// scheduling; an edit that changes nothing publishes nothing.
+	bool Update(const std::function<void(WorkerConfig&)>& edit);
+
+private:
+	mutable std::mutex mutex;
+	Snapshot current;
+	std::atomic<uint64_t> version{ 0 };
+};
@@ -0,0 +1,153 @@
+#include "HistoryBench.h"
+#include "SightingHistory.h"
+
+#include <chrono>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace
+{
+	constexpr size_t kRows = 5000000;
+	constexpr uint32_t kNames = 400;
+	constexpr uint32_t kAddresses = 20000;
+	constexpr size_t kRangeRows = 10000;
+
+	struct Sightings
+	{
+		std::vector<std::string> names;
+		std::vector<std::string> urls;
+		std::vector<uint64_t> times;
+		std::vector<uint32_t> name;
+		std::vector<uint32_t> url;
+	};
+
+	Sightings MakeSightings()
+	{
+		std::mt19937_64 rng(7);
+		Sightings s;
+		for (uint32_t i = 0; i < kNames; ++i)
+			s.names.push_back("EU-Frankfurt-" + std::to_string(i));
+		for (uint32_t i = 0; i < kAddresses; ++i)
+			s.urls.push_back(std::to_string(rng() % 256) + "." + std::to_string(rng() % 256) + ".7." + std::to_string(rng() % 256)
+				+ ":" + std::to_string(7000 + rng() % 800));
+
+		uint64_t t = 1760000000000ull;
+		s.times.resize(kRows);
+		s.name.resize(kRows);
+		s.url.resize(kRows);
+		for (size_t i = 0; i < kRows; ++i)
+		{
+			t += 1000 + rng() % 200;
+			s.times[i] = t;
+			s.name[i] = (uint32_t)(rng() % kNames);
+			s.url[i] = (uint32_t)(rng() % kAddresses);
+		}
+		return s;
+	}
+
+	// Heap held by a vector of strings: the string objects, plus a malloc
+	// chunk (8-byte header, 16-byte granularity) per string too long for
+	// the small-string buffer.
+	uint64_t LabelBytes(const std::vector<std::string>& labels)
+	{
+		const size_t inlineCapacity = std::string().capacity();
+		uint64_t bytes = labels.capacity() * sizeof(std::string);
+		for (const auto& label : labels)
+			if (label.capacity() > inlineCapacity)
+				bytes += (label.capacity() + 1 + 8 + 15) & ~(size_t)15;
+		return bytes;
+	}
+
+	// Every row of the store in order, compared with the generated input.
+	bool SameRows(const SightingHistory& history, const Sightings& s)
+	{
+		size_t i = 0;
+		bool same = true;
+		history.Query(0, UINT64_MAX, [&](const HistorySighting& row)
+			{
+				same = i < kRows && row.timeMs == s.times[i] && row.serverName == s.names[s.name[i]]
+					&& row.GameUrl() == s.urls[s.url[i]] && row.source == "default";
+				++i;
+				return same;
+			});
+		return same && i == kRows;
+	}
+
+	double SecondsSince(std::chrono::steady_clock::time_point start)
+	{
+		return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	}
+}
+
+bool RunHistoryBench(std::FILE* out)
+{
+	Sightings s = MakeSightings();
+
+	std::vector<std::string> labels;
+	labels.reserve(kRows);
+	for (size_t i = 0; i < kRows; ++i)
+		labels.push_back(s.names[s.name[i]] + " (" + s.urls[s.url[i]] + ")");
+
+	SightingHistory history;
+	auto start = std::chrono::steady_clock::now();
+	for (size_t i = 0; i < kRows; ++i)
+		history.Append(s.times[i], s.names[s.name[i]], s.urls[s.url[i]], "default");
+	double appendSeconds = SecondsSince(start);
+
+	// The same work per row on both sides: touch the text of each one.
+	uint64_t sink = 0;
+	start = std::chrono::steady_clock::now();
+	for (const auto& label : labels)
+		sink += label.size();
+	double walkSeconds = SecondsSince(start);
+
+	start = std::chrono::steady_clock::now();
+	uint64_t decoded = history.Query(0, UINT64_MAX, [&](const HistorySighting& row)
+		{
+			sink += row.serverName.size() + row.address.size() + row.port;
+			return true;
+		});
+	double decodeSeconds = SecondsSince(start);
+
+	const uint64_t labelBytes = LabelBytes(labels);
+	const SightingHistory::Stats stats = history.GetStats();
+	std::fprintf(out, "%zu sightings, %u names, %u addresses (append %.1f M rows/s)\n",
+		kRows, kNames, kAddresses, (double)kRows / appendSeconds / 1e6);
+	std::fprintf(out, "%-16s %10s %10s %14s\n", "", "MB", "bytes/row", "walk M rows/s");
+	std::fprintf(out, "%-16s %10.1f %10.1f %14.1f   (labels only, no times)\n", "vector<string>",
+		(double)labelBytes / 1e6, (double)labelBytes / kRows, (double)kRows / walkSeconds / 1e6);
+	std::fprintf(out, "%-16s %10.1f %10.1f %14.1f   (full decode)\n", "SightingHistory",
+		(double)stats.TotalBytes() / 1e6, (double)stats.TotalBytes() / kRows, (double)decoded / decodeSeconds / 1e6);
+
+	const uint64_t from = s.times[kRows / 2];
+	const uint64_t to = s.times[kRows / 2 + kRangeRows - 1];
+	start = std::chrono::steady_clock::now();
+	uint64_t inRange = history.Query(from, to, [](const HistorySighting&) { return true; });
+	std::fprintf(out, "range query: %llu rows in %.2f ms\n", (unsigned long long)inRange, SecondsSince(start) * 1e3);
+
+	bool ok = true;
+	if (decoded != kRows || inRange != kRangeRows || !SameRows(history, s))
+	{
+		std::fprintf(out, "mismatch: decoded rows differ from the input\n");
+		ok = false;
+	}
+
+	std::string blob = history.Save();
+	SightingHistory loaded;
+	if (!loaded.Load(blob) || !SameRows(loaded, s))
+	{
+		std::fprintf(out, "mismatch: Save/Load round trip differs\n");
+		ok = false;
+	}
+	SightingHistory truncated;
+	if (truncated.Load(std::string_view(blob).substr(0, blob.size() - 3)))
+	{
+		std::fprintf(out, "mismatch: a truncated snapshot loaded\n");
+		ok = false;
+	}
+	std::fprintf(out, "snapshot: %.1f MB, round trip %s\n", (double)blob.size() / 1e6, ok ? "exact" : "FAILED");
+
+	return ok && sink != 0;
+}
@@ -0,0 +1,18 @@
+#pragma once
+
+// Sighting history store against the vector<string> of labels the plugin
+// kept before (what logDuplicates grows), over 5M synthetic sightings of
+// 400 server names and 20k addresses.
+//
+// Prints memory per row (the store's own accounting; for the labels the
+// string objects plus one malloc chunk per label past the small-string
+// buffer), a full decode against a plain walk of the labels, and a 10k-row
+// time range query. Every decoded row is checked against the input, and so
+// is a Save/Load round trip; a truncated snapshot must be rejected.
+//
+// Portable, no SDK dependencies.
+
+#include <cstdio>
+
+// Prints the comparison to `out`. Returns false on a mismatch.
+bool RunHistoryBench(std::FILE* out);
@@ -0,0 +1,339 @@
+#include "ParserCrossCheck.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <regex>
+#include <sstream>
+
+namespace
+{
+	// Excerpts in the shape Launch.log uses around a match join, plus the
+	// awkward cases the pairing rules exist for.
+	const char* const kBuiltinSeeds[] = {
+		"[0012.48] Log: Joining ServerName=\"EU-Frankfurt-42\" Playlist=13\r\n"
+		"[0012.91] Log: Browse: GameURL=\"185.60.112.7:7791\" MatchType=Online\r\n"
+		"[0013.02] Log: PendingConnection: Connecting\r\n",
+
+		"[0101.00] Log: ServerName=\"USE5-Ashburn\" GameURL=\"[2600:1f18::12]:7777\"\n"
+		"[0101.20] Log: GameURL=\"[2600:1f18::12]:7777\"\n"
+		"[0102.00] Log: GameURL=\"104.44.1.9:7800\" ServerName=\"USE6-Ashburn\"\n",
+
+		"[0200.00] Log: GameURL=\"10.0.0.1:7777?Lan\"\n"
+		"[0200.10] Log: ServerName=\"\" GameURL=\"\"\n"
+		"[0200.20] Log: ServerName=\"Private \\\"quoted\\\"\" GameURL=\"10.0.0.2:7777\"\n"
+		"[0200.30] Log: ServerName=\"unterminated GameURL=\"10.0.0.3:7777\"\n",
+
+		"ServerName=\"ServerName=\"x\"\"\nGameURL=\"GameURL=\"1.1.1.1:1\"\n"
+		"ServerName=\"a\"ServerName=\"b\"\nGameURL=\"2.2.2.2:2\"GameURL=\"3.3.3.3:3\"\n"
+		"ServerNam=\"no\" GameURl=\"no\" ServerName= \"no\"\n\n\r\n",
+	};
+
+	const char* const kTokens[] = {
+		"ServerName=\"", "GameURL=\"", "\"", "\r\n", "\n", "\r", "=", "ServerName=", "GameURL",
+		"GameURL=\"\"", "ServerName=\"\"", "127.0.0.1:7777", " ", "Server", "Name=\"",
+	};
+
+	bool SameEndpoint(const EndpointRecord& a, const EndpointRecord& b)
+	{
+		return a.label == b.label && a.serverName == b.serverName && a.gameUrl == b.gameUrl;
+	}
+
+	std::string Describe(const EndpointRecord& ep)
+	{
+		std::string s = "label=\"";
+		AppendEscaped(s, ep.label);
+		s += "\" serverName=\"";
+		AppendEscaped(s, ep.serverName);
+		s += "\" gameUrl=\"";
+		AppendEscaped(s, ep.gameUrl);
+		s += '"';
+		return s;
+	}
+
+	void ReferenceParseLine(const std::string& line, std::string& outServerName, std::string& outGameUrl)
+	{
+		static const std::regex serverNameRegex(R"(ServerName="([^"]*)\")");
+		static const std::regex gameUrlRegex(R"(GameURL="([^"]*)\")");
+
+		std::smatch m;
+		if (std::regex_search(line, m, serverNameRegex) && m.size() > 1)
+			outServerName = m[1].str();
+		if (std::regex_search(line, m, gameUrlRegex) && m.size() > 1)
+			outGameUrl = m[1].str();
+	}
+}
+
+void ReferenceParseLaunchLog(std::string_view text, std::vector<EndpointRecord>& out)
+{
+	std::string currentServerName;
+	std::string currentGameUrl;
+	std::string line;
+
+	size_t pos = 0;
+	while (pos < text.size())
+	{
+		// std::getline on a text-mode stream: CRLF arrives as LF, a final
+		// unterminated line is still delivered.
+		size_t nl = text.find('\n', pos);
+		size_t end = nl == std::string_view::npos ? text.size() : nl;
+		line.assign(text.substr(pos, end - pos));
+		if (nl != std::string_view::npos && !line.empty() && line.back() == '\r')
+			line.pop_back();
+		pos = nl == std::string_view::npos ? text.size() : nl + 1;
+
+		std::string serverName;
+		std::string gameUrl;
+		ReferenceParseLine(line, serverName, gameUrl);
+
+		if (!serverName.empty())
+			currentServerName = serverName;
+		if (!gameUrl.empty())
+			currentGameUrl = gameUrl;
+
+		if (!currentGameUrl.empty())
+		{
+			std::ostringstream ss;
+			if (!currentServerName.empty())
+				ss << currentServerName << " (" << currentGameUrl << ")";
+			else
+				ss << currentGameUrl;
+
+			EndpointRecord ep;
+			ep.label = ss.str();
+			ep.serverName = currentServerName;
+			ep.gameUrl = currentGameUrl;
+			out.push_back(std::move(ep));
+
+			currentGameUrl.clear();
+		}
+	}
+}
+
+void AppendEscaped(std::string& out, std::string_view text)
+{
+	for (unsigned char c : text)
+	{
+		switch (c)
+		{
+		case '\n': out += "\\n"; break;
+		case '\r': out += "\\r"; break;
+		case '\t': out += "\\t"; break;
+		case '\\': out += "\\\\"; break;
+		default:
+			if (c < 0x20 || c >= 0x7F)
+			{
+				char buf[8];
+				std::snprintf(buf, sizeof(buf), "\\x%02x", c);
+				out += buf;
+			}
+			else
+			{
+				out += (char)c;
+			}
+		}
+	}
+}
+
+void ParserCrossCheck::AddVariant(std::string name, Parser parser)
+{
+	variants.push_back({ std::move(name), std::move(parser) });
+}
+
+void ParserCrossCheck::AddSeed(std::string text)
+{
+	if (text.empty())
+		return;
+	if (text.back() != '\n')
+		text += '\n';
+
+	size_t pos = 0;
+	while (pos < text.size())
+	{
+		size_t nl = text.find('\n', pos);
+		seedLines.push_back(text.substr(pos, nl + 1 - pos));
+		pos = nl + 1;
+	}
+	seeds.push_back(std::move(text));
+}
+
+void ParserCrossCheck::AddBuiltinSeeds()
+{
+	for (const char* seed : kBuiltinSeeds)
+		AddSeed(seed);
+}
+
+int ParserCrossCheck::FirstMismatch(std::string_view input, std::string* detail)
+{
+	expected.clear();
+	ReferenceParseLaunchLog(input, expected);
+
+	for (size_t v = 0; v < variants.size(); ++v)
+	{
+		actual.clear();
+		variants[v].parser(input, actual);
+
+		size_t common = std::min(expected.size(), actual.size());
+		size_t i = 0;
+		while (i < common && SameEndpoint(expected[i], actual[i]))
+			++i;
+		if (i == common && expected.size() == actual.size())
+			continue;
+
+		if (detail)
+		{
+			*detail = "reference emitted " + std::to_string(expected.size()) + " endpoint(s), "
+				+ variants[v].name + " " + std::to_string(actual.size()) + "; first difference at #" + std::to_string(i) + ":\n";
+			*detail += "  reference: " + (i < expected.size() ? Describe(expected[i]) : std::string("(none)")) + "\n";
+			*detail += "  " + variants[v].name + ": " + (i < actual.size() ? Describe(actual[i]) : std::string("(none)"));
+		}
+		return (int)v;
+	}
+	return -1;
+}
+
+std::string ParserCrossCheck::Shrink(std::string input, int variant)
+{
+	auto stillFails = [&](const std::string& candidate)
+		{
+			if (candidate.empty() || candidate.back() != '\n')
+				return false;
+			return FirstMismatch(candidate, nullptr) == variant;
+		};
+
+	// Whole lines first, then ever smaller byte ranges.
+	for (bool progress = true; progress;)
+	{
+		progress = false;
+		for (size_t start = 0; start < input.size();)
+		{
+			size_t nl = input.find('\n', start);
+			std::string candidate = input.substr(0, start) + input.substr(nl + 1);
+			if (stillFails(candidate))
+			{
+				input = std::move(candidate);
+				progress = true;
+			}
+			else
+			{
+				start = nl + 1;
+			}
+		}
+	}
+
+	for (size_t chunk = std::max<size_t>(1, input.size() / 2); chunk > 0; chunk /= 2)
+	{
+		for (size_t start = 0; start + chunk < input.size();)
+		{
+			std::string candidate = input.substr(0, start) + input.substr(start + chunk);
+			if (stillFails(candidate))
+				input = std::move(candidate);
+			else
+				start += chunk;
+		}
+	}
+	return input;
+}
+
+std::string ParserCrossCheck::Mutate(std::mt19937_64& rng, size_t maxBytes)
+{
+	auto pick = [&](size_t n) { return (size_t)(rng() % n); };
+
+	std::string s;
+	if (!seedLines.empty() && pick(2) == 0)
+	{
+		// Splice random lines from every seed.
+		size_t lines = 1 + pick(16);
+		for (size_t i = 0; i < lines; ++i)
+			s += seedLines[pick(seedLines.size())];
+	}
+	else if (!seeds.empty())
+	{
+		s = seeds[pick(seeds.size())];
+	}
+
+	size_t ops = 1 + pick(8);
+	for (size_t op = 0; op < ops; ++op)
+	{
+		size_t at = s.empty() ? 0 : pick(s.size() + 1);
+		switch (pick(7))
+		{
+		case 0:
+		case 1:
+			s.insert(at, kTokens[pick(std::size(kTokens))]);
+			break;
+		case 2:
+			if (!seedLines.empty())
+				s.insert(at, seedLines[pick(seedLines.size())]);
+			break;
+		case 3:
+			if (at < s.size())
+				s.erase(at, 1 + pick(std::min<size_t>(16, s.size() - at)));
+			break;
+		case 4:
+			if (at < s.size())
+				s[at] = (char)rng();
+			break;
+		case 5:
+			s.insert(at, 1, (char)(pick(4) == 0 ? rng() : 0x20 + pick(0x5F)));
+			break;
+		case 6:
+			if (at < s.size())
+			{
+				size_t len = 1 + pick(std::min<size_t>(64, s.size() - at));
+				s.insert(pick(s.size() + 1), s.substr(at, len));
+			}
+			break;
+		}
+	}
+
+	if (s.size() >= maxBytes)
+		s.resize(maxBytes - 1);
+	if (s.empty() || s.back() != '\n')
+		s += '\n';
+	return s;
+}
+
+bool ParserCrossCheck::Check(std::string_view input, CrossCheckReport& report)
+{
+	std::string detail;
+	int variant = FirstMismatch(input, &detail);
+
+	report.iterations++;
+	report.bytes += input.size();
+	report.endpoints += expected.size();
+	if (variant < 0)
+		return true;
+
+	if (report.divergences++ == 0)
+	{
+		report.variant = variants[variant].name;
+		report.input = Shrink(std::string(input), variant);
+		FirstMismatch(report.input, &report.detail);
+	}
+	return false;
+}
+
+CrossCheckReport ParserCrossCheck::Run(const CrossCheckOptions& options)
+{
+	CrossCheckReport report;
+	std::mt19937_64 rng(options.seed);
+	auto start = std::chrono::steady_clock::now();
+	auto deadline = start + std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(options.seconds));
+
+	// Seeds as they are first, then mutations.
+	bool ok = true;
+	for (size_t i = 0; i < seeds.size() && ok; ++i)
+		ok = Check(seeds[i], report);
+
+	while (ok && (options.maxIterations == 0 || report.iterations < options.maxIterations))
+	{
+		// The clock is not free next to a small input; look every 64 runs.
+		if ((report.iterations & 63) == 0 && std::chrono::steady_clock::now() >= deadline)
+			break;
+		ok = Check(Mutate(rng, std::max<size_t>(options.maxInputBytes, 2)), report);
+	}
+
+	report.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	return report;
+}
@@ -0,0 +1,97 @@
+#pragma once
+
+// Differential checking of Launch.log parsers against the original
+// regex implementation.
+//
+// The reference is the plugin's first parser, kept verbatim in behaviour:
+// std::getline over the whole text (CRLF folded as a text-mode stream
+// does), regex_search for ServerName="..." and GameURL="...", a sticky
+// server name that persists across GameURLs, and a pending GameURL that is
+// cleared after every emitted endpoint. Every faster path has to produce
+// the same endpoint sequence for any input.
+//
+// Variants are plain callbacks, so the scanner can register its mapped
+// buffer path, the tailing path and rule sets with extra fields. Inputs are
+// the seed corpus and random mutations of it; a divergence is shrunk to a
+// small reproducer before it is reported.
+//
+// Portable, no SDK dependencies.
+
+#include "EndpointRecord.h"
+
+#include <cstdint>
+#include <functional>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Parses a whole log text the way the original ScanLaunchLog did.
+void ReferenceParseLaunchLog(std::string_view text, std::vector<EndpointRecord>& out);
+
+// Appends `text` with control and non-ASCII bytes escaped, for reports.
+void AppendEscaped(std::string& out, std::string_view text);
+
+struct CrossCheckOptions
+{
+	double   seconds = 10.0;          // stop after this long...
+	uint64_t maxIterations = 0;       // ...or this many inputs (0 = no limit)
+	uint64_t seed = 1;
+	size_t   maxInputBytes = 64 * 1024;
+};
+
+struct CrossCheckReport
+{
+	uint64_t iterations = 0;
+	uint64_t bytes = 0;        // input bytes fed to each parser
+	uint64_t endpoints = 0;    // reference endpoints seen
+	uint64_t divergences = 0;
+	double   seconds = 0.0;
+
+	// First divergence, shrunk.
+	std::string variant;
+	std::string input;
+	std::string detail;
+};
+
+class ParserCrossCheck
+{
+public:
+	using Parser = std::function<void(std::string_view text, std::vector<EndpointRecord>& out)>;
+
+	// `text` always ends with a line break: the tailing paths hold back an
+	// unterminated last line by design, so inputs never have one.
+	void AddVariant(std::string name, Parser parser);
+
+	// Seeds are split into lines and spliced by the mutator. A few
+	// representative excerpts are built in.
+	void AddSeed(std::string text);
+	void AddBuiltinSeeds();
+	size_t SeedCount() const { return seeds.size(); }
+
+	// Runs one input through the reference and every variant. Records the
+	// first divergence (shrunk) in `report`; returns false on divergence.
+	bool Check(std::string_view input, CrossCheckReport& report);
+
+	// Mutation loop until the time or iteration budget runs out. Stops at
+	// the first divergence.
+	CrossCheckReport Run(const CrossCheckOptions& options);
+
+private:
+	struct Variant
+	{
+		std::string name;
+		Parser parser;
+	};
+
+	// Index of the first variant that disagrees with the reference, or -1.
+	int FirstMismatch(std::string_view input, std::string* detail);
+	std::string Shrink(std::string input, int variant);
+	std::string Mutate(std::mt19937_64& rng, size_t maxBytes);
+
+	std::vector<Variant> variants;
+	std::vector<std::string> seeds;
+	std::vector<std::string> seedLines;
+	std::vector<EndpointRecord> expected;
+	std::vector<EndpointRecord> actual;
+};
@@ -0,0 +1,100 @@
+#include "PcapCheck.h"
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+namespace
+{
+	// Tiny, uneven budgets so slice boundaries land inside every kind of block.
+	constexpr uint64_t kSliceBytes[] = { 1, 7, 64, 1500 };
+
+	bool ReadText(const std::string& path, std::string& out)
+	{
+		std::ifstream file(path, std::ios::in | std::ios::binary);
+		if (!file.is_open())
+			return false;
+		std::stringstream text;
+		text << file.rdbuf();
+		out = text.str();
+		out.erase(std::remove(out.begin(), out.end(), '\r'), out.end());
+		return true;
+	}
+}
+
+std::string DescribePcapScan(const std::vector<PcapFlow>& flows, const PcapScanStats& stats)
+{
+	std::ostringstream ss;
+	ss << "packets=" << stats.packets << " udp=" << stats.udpPackets << " skipped=" << stats.skipped
+		<< " candidates=" << stats.candidateFlows << "\n";
+	for (const auto& flow : flows)
+	{
+		ss << flow.Endpoint() << " first=" << flow.firstSeenUs << " last=" << flow.lastSeenUs
+			<< " from=" << flow.packetsFromServer << " to=" << flow.packetsToServer << " bytes=" << flow.bytes << "\n";
+	}
+	return ss.str();
+}
+
+bool CheckPcapSample(const std::string& capturePath, std::string& detail)
+{
+	std::string expectedPath = std::filesystem::path(capturePath).replace_extension(".expected").string();
+	std::string expected;
+	bool haveExpected = ReadText(expectedPath, expected);
+
+	PcapScanOptions options;
+	std::vector<PcapFlow> flows;
+	PcapScanStats stats;
+	std::string error;
+	if (!ScanPcapFile(capturePath, options, flows, &stats, &error))
+	{
+		detail = "scan failed: " + error;
+		return false;
+	}
+	std::string whole = DescribePcapScan(flows, stats);
+
+	if (!haveExpected)
+	{
+		detail = "no " + expectedPath + "; this scan gives:\n" + whole;
+		return false;
+	}
+	if (whole != expected)
+	{
+		detail = "one-shot scan differs\n--- expected\n" + expected + "--- actual\n" + whole;
+		return false;
+	}
+
+	for (uint64_t sliceBytes : kSliceBytes)
+	{
+		PcapScanner scanner;
+		if (!scanner.Open(capturePath, options, &error))
+		{
+			detail = "scanner open failed: " + error;
+			return false;
+		}
+
+		uint64_t steps = 0;
+		while (scanner.Step(sliceBytes, std::chrono::steady_clock::time_point::max()))
+			steps++;
+		std::vector<PcapFlow> sliced;
+		scanner.Finish(sliced);
+
+		std::string text = DescribePcapScan(sliced, scanner.Stats());
+		if (text != expected)
+		{
+			detail = "scan in " + std::to_string(sliceBytes) + "-byte slices (" + std::to_string(steps)
+				+ " steps) differs\n--- expected\n" + expected + "--- actual\n" + text;
+			return false;
+		}
+	}
+	return true;
+}
+
+bool IsCaptureFile(const std::filesystem::path& path)
+{
+	std::string ext = path.extension().string();
+	std::transform(ext.begin(), ext.end(), ext.begin(), [](unsigned char c) { return (char)std::tolower(c); });
+	return ext == ".pcap" || ext == ".pcapng" || ext == ".cap";
+}
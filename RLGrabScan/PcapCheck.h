@@ -0,0 +1,30 @@
+#pragma once
+
+// Regression check for the capture reader against bundled sample captures.
+//
+// Every capture (*.pcap, *.pcapng) is scanned twice: in one go with
+// ScanPcapFile, and through PcapScanner in slices of a few bytes, the way
+// the plugin worker walks a large file. Both must print exactly the lines
+// of the capture's .expected file next to it ("x.pcap" -> "x.expected").
+// samples/ holds captures for each framing the reader supports: classic
+// pcap in both byte orders and resolutions, pcapng with several interfaces
+// and decimal or binary if_tsresol, Ethernet with VLAN tags, Linux SLL, raw
+// IP, IPv6 and a truncated tail.
+//
+// Portable, no SDK dependencies.
+
+#include "PcapReader.h"
+
+#include <filesystem>
+#include <string>
+#include <vector>
+
+// One line per reported flow plus a stats line, the .expected format.
+std::string DescribePcapScan(const std::vector<PcapFlow>& flows, const PcapScanStats& stats);
+
+// Checks one capture against its expected description. On mismatch,
+// `detail` holds both descriptions.
+bool CheckPcapSample(const std::string& capturePath, std::string& detail);
+
+// True for the file extensions CheckPcapSample accepts.
+bool IsCaptureFile(const std::filesystem::path& path);
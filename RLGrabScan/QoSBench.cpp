@@ -0,0 +1,136 @@
+#include "QoSBench.h"
+#include "ExtractionRules.h"
+#include "LaunchLogParser.h"
+#include "ThreadQoS.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace
+{
+	using Clock = std::chrono::steady_clock;
+
+	constexpr auto kFrameWork = std::chrono::microseconds(2000);
+	constexpr auto kFramePeriod = std::chrono::microseconds(6944); // 144 Hz
+	constexpr double kLateMs = 7.5;
+
+	struct Case
+	{
+		const char* name;
+		bool scan;
+		ThreadQoS qos;
+	};
+
+	std::string MakeLog()
+	{
+		std::string text;
+		text.reserve(4u << 20);
+		for (unsigned i = 0; text.size() < (4u << 20); ++i)
+		{
+			text += "[0012.10] Log: Texture streaming pool size now 1200 MB\r\n";
+			text += "[0012.13] ScriptLog: PsyNet RPC Products/GetPlayerProducts completed\r\n";
+			if (i % 4 == 0)
+			{
+				text += "[0013.00] Log: Joining ServerName=\"EU-Frankfurt-" + std::to_string(i % 97) + "\"\r\n";
+				text += "[0013.01] Log: Browse: GameURL=\"185.60.112." + std::to_string(i % 251) + ":" + std::to_string(7000 + i % 997) + "\"\r\n";
+			}
+		}
+		return text;
+	}
+
+	void ScanLoop(std::string_view text, const ExtractionEngine& engine, std::atomic<bool>& stop)
+	{
+		LaunchLogParser parser(engine);
+		std::vector<EndpointRecord> out;
+		while (!stop.load(std::memory_order_relaxed))
+		{
+			LaunchLogState state;
+			out.clear();
+			size_t pos = 0;
+			while (pos < text.size() && !stop.load(std::memory_order_relaxed))
+			{
+				size_t nl = text.find('\n', pos);
+				size_t end = nl == std::string_view::npos ? text.size() : nl;
+				std::string_view line = text.substr(pos, end - pos);
+				if (!line.empty() && line.back() == '\r')
+					line.remove_suffix(1);
+				parser.Feed(line, state, "bench", out);
+				pos = end + 1;
+			}
+		}
+	}
+
+	// Frame intervals in milliseconds.
+	std::vector<double> RenderLoop(double seconds)
+	{
+		std::vector<double> intervals;
+		volatile uint64_t sink = 0;
+		auto end = Clock::now() + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(seconds));
+		auto last = Clock::now();
+		while (last < end)
+		{
+			auto frameStart = Clock::now();
+			while (Clock::now() - frameStart < kFrameWork)
+				sink = sink + 1;
+			std::this_thread::sleep_until(frameStart + kFramePeriod);
+
+			auto now = Clock::now();
+			intervals.push_back(std::chrono::duration<double, std::milli>(now - last).count());
+			last = now;
+		}
+		return intervals;
+	}
+}
+
+void RunQoSBench(std::FILE* out, const QoSBenchOptions& options)
+{
+	ExtractionEngine engine;
+	engine.Compile(ExtractionEngine::DefaultRules());
+	const std::string log = MakeLog();
+	const unsigned threads = options.scanThreads ? options.scanThreads : std::max(1u, LogicalCoreCount());
+
+	const Case cases[] = {
+		{ "no scan", false, ThreadQoS{ ThreadPriority::Normal, false, 0 } },
+		{ "normal", true, ThreadQoS{ ThreadPriority::Normal, false, options.affinityMask } },
+		{ "below_normal+bgio", true, ThreadQoS{ ThreadPriority::BelowNormal, true, options.affinityMask } },
+		{ "lowest+bgio", true, ThreadQoS{ ThreadPriority::Lowest, true, options.affinityMask } },
+		{ "idle+bgio", true, ThreadQoS{ ThreadPriority::Idle, true, options.affinityMask } },
+	};
+
+	std::fprintf(out, "%u scan thread(s), %.1f s per case, frames over %.1f ms are late\n", threads, options.secondsPerCase, kLateMs);
+	std::fprintf(out, "%-18s %7s %8s %8s %8s %6s\n", "scan QoS", "frames", "p50 ms", "p99 ms", "max ms", "late");
+
+	for (const Case& c : cases)
+	{
+		std::atomic<bool> stop{ false };
+		std::atomic<unsigned> qosFailures{ 0 };
+		std::vector<std::thread> scanners;
+		for (unsigned i = 0; c.scan && i < threads; ++i)
+		{
+			scanners.emplace_back([&]()
+				{
+					if (!ApplyCurrentThreadQoS(c.qos))
+						qosFailures++;
+					ScanLoop(log, engine, stop);
+				});
+		}
+
+		std::vector<double> intervals = RenderLoop(options.secondsPerCase);
+		stop = true;
+		for (auto& t : scanners)
+			t.join();
+
+		std::sort(intervals.begin(), intervals.end());
+		auto quantile = [&](double q) { return intervals.empty() ? 0.0 : intervals[(size_t)(q * (double)(intervals.size() - 1))]; };
+		size_t late = (size_t)(intervals.end() - std::upper_bound(intervals.begin(), intervals.end(), kLateMs));
+
+		std::fprintf(out, "%-18s %7zu %8.2f %8.2f %8.2f %6zu%s\n", c.name, intervals.size(), quantile(0.5), quantile(0.99),
+			intervals.empty() ? 0.0 : intervals.back(), late, qosFailures ? "  (QoS not fully applied)" : "");
+	}
+}
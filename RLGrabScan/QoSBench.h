@@ -0,0 +1,25 @@
+#pragma once
+
+// Frame pacing of a render loop while background threads scan, under each
+// thread QoS the plugin offers.
+//
+// A thread at normal priority simulates a 144 Hz game: 2 ms of work per
+// frame, then it sleeps until the next 6.94 ms boundary. Scan threads, one
+// per core unless told otherwise, parse an in-memory Launch.log in a loop
+// at the QoS under test. Reported per QoS: the frame interval's median,
+// p99 and maximum, and how many frames overran 7.5 ms. A run with no scan
+// threads gives the baseline.
+//
+// Portable, no SDK dependencies.
+
+#include <cstdint>
+#include <cstdio>
+
+struct QoSBenchOptions
+{
+	double   secondsPerCase = 4.0;
+	unsigned scanThreads = 0;     // 0 = one per logical core
+	uint64_t affinityMask = 0;    // applied to scan threads in every case
+};
+
+void RunQoSBench(std::FILE* out, const QoSBenchOptions& options);
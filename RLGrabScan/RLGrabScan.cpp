@@ -0,0 +1,795 @@
+// rlgrab_scan: headless batch scanner for archived Launch.log files.
+//
+// Runs the plugin's portable core (extraction rules, line parser, dedup)
+// over many files or directories in parallel and writes deduplicated
+// endpoint records as JSON Lines or CSV. Output order is deterministic: files
+// are emitted in sorted path order and the first record per label wins, no
+// matter how many threads parse.
+//
+// --fuzz SECONDS runs the differential parser check instead: the original
+// regex parser against the mapped buffer path, the same path with extra
+// overlapping rules, and the LogTail path fed in random appends. Given
+// files seed the corpus. Exit status 1 means a divergence was found; the
+// shrunk input is printed.
+//
+// --pcap-check runs the capture reader over the given captures (samples/
+// ships one per supported framing) and compares each with its .expected
+// file, scanning once in one go and once in small slices.
+//
+// --seqlock-stress SECONDS hammers a private shared endpoint page with one
+// writer and -j reader threads and checks every snapshot for tearing.
+//
+// --bench NAME prints a benchmark table to stdout:
+//   rules   compiled extraction automaton vs a regex per rule, 8-128 rules
+//   qos     144 Hz frame pacing next to -j scan threads under each thread QoS
+//           (--affinity pins the scan threads)
+//   search  endpoint list filter over 100k labels: index build, typing,
+//           backspacing and fresh queries
+//   history sighting history store vs a vector<string> of labels over 5M
+//           sightings: bytes/row, decode rate, range query
+//
+// --tree-check round-trips random TreeView and FlatTreeView trees through
+// the binary format, loads truncated and bit-flipped copies, and times
+// save/load of a 200k node tree. Builds the vendored ImGui sources; pch.h
+// here stands in for the plugin's.
+//
+// Windows: build RLGrabScan.vcxproj from RLGrab.sln.
+// Linux, from this directory (one command):
+//   g++ -std=c++20 -O2 -pthread -I. -I../RLGrab -I../RLGrab/IMGUI -o rlgrab_scan RLGrabScan.cpp
+//     ../RLGrab/EndpointExport.cpp ../RLGrab/ExtractionRules.cpp ../RLGrab/LaunchLogParser.cpp
+//     ../RLGrab/LogTail.cpp ../RLGrab/MappedFile.cpp ../RLGrab/ThreadQoS.cpp ParserCrossCheck.cpp
+//     ../RLGrab/PcapReader.cpp PcapCheck.cpp SeqlockStress.cpp
+//     RuleBench.cpp QoSBench.cpp SearchBench.cpp ../RLGrab/EndpointSearch.cpp
+//     HistoryBench.cpp ../RLGrab/SightingHistory.cpp ../RLGrab/EndpointQuery.cpp
+//     TreeViewCheck.cpp ../RLGrab/IMGUI/imguivariouscontrols.cpp ../RLGrab/IMGUI/imgui.cpp
+//     ../RLGrab/IMGUI/imgui_draw.cpp ../RLGrab/IMGUI/imgui_widgets.cpp
+// Add -DRLGRAB_LIBFUZZER -fsanitize=fuzzer,address to build the same check
+// as a libFuzzer target (no main; corpus handling is libFuzzer's).
+
+#include "EndpointExport.h"
+#include "EndpointRecord.h"
+#include "ExtractionRules.h"
+#include "HistoryBench.h"
+#include "LaunchLogParser.h"
+#include "LogTail.h"
+#include "MappedFile.h"
+#include "ParserCrossCheck.h"
+#include "PcapCheck.h"
+#include "QoSBench.h"
+#include "RuleBench.h"
+#include "SearchBench.h"
+#include "SeqlockStress.h"
+#include "ThreadQoS.h"
+#include "TreeViewCheck.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+	enum class OutputFormat
+	{
+		JsonLines,
+		Csv,
+	};
+
+	struct Options
+	{
+		std::vector<std::string> inputs;
+		std::string rulesPath;
+		std::string outputPath;  // empty = stdout
+		OutputFormat format = OutputFormat::JsonLines;
+		unsigned threads = 0;    // 0 = hardware concurrency
+		bool keepDuplicates = false;
+		bool setQoS = false;       // --priority/--background-io/--affinity given
+		ThreadQoS qos{ ThreadPriority::Normal, false, 0 };
+		double fuzzSeconds = 0.0;  // > 0: run the parser cross-check instead
+		uint64_t fuzzSeed = 1;
+		bool pcapCheck = false;    // check the inputs as sample captures
+		double stressSeconds = 0.0; // > 0: run the seqlock stress instead
+		std::string bench;         // non-empty: run this benchmark instead
+		bool treeCheck = false;    // run the tree view binary format check instead
+	};
+
+	// Per input file; filled by a parser thread, drained in order by main.
+	struct FileResult
+	{
+		std::vector<EndpointRecord> endpoints;
+		std::string error;
+		uint64_t bytes = 0;
+		uint64_t lines = 0;
+		bool done = false;
+	};
+
+	void PrintUsage()
+	{
+		std::fprintf(stderr,
+			"usage: rlgrab_scan [options] <file|dir>...\n"
+			"  -f, --format jsonl|csv  output format (default jsonl)\n"
+			"  -o, --output FILE       write records to FILE instead of stdout\n"
+			"  -j, --threads N         parser threads (default: all cores)\n"
+			"  -r, --rules FILE        extra extraction rules, field|prefix|terminator per line\n"
+			"  -a, --all               keep duplicate endpoints\n"
+			"  -p, --priority P        parser thread priority: normal, below_normal, lowest, idle\n"
+			"      --background-io     parser threads use background I/O priority\n"
+			"      --affinity CORES    pin parser threads, e.g. 2-5,7 or 0x3C\n"
+			"      --fuzz SECONDS      cross-check every parser path against the regex reference;\n"
+			"                          inputs, if any, seed the corpus\n"
+			"      --seed N            random seed for --fuzz and --tree-check (default 1)\n"
+			"      --pcap-check        scan the input captures and compare each with its .expected file\n"
+			"      --seqlock-stress SECONDS\n"
+			"                          one writer against -j readers on a private shared endpoint page\n"
+			"      --bench NAME        print a benchmark: rules (automaton vs regex, 8-128 rules),\n"
+			"                          qos (144 Hz frame pacing next to -j scan threads per thread QoS),\n"
+			"                          search (endpoint list filter over 100k labels),\n"
+			"                          history (sighting store vs vector<string>, 5M sightings)\n"
+			"      --tree-check        round-trip and corrupt tree view saves, time a 200k node load\n"
+			"Directories are searched recursively for *.log files.\n");
+	}
+
+	bool ParseArgs(int argc, char** argv, Options& opt)
+	{
+		for (int i = 1; i < argc; ++i)
+		{
+			std::string arg = argv[i];
+			auto value = [&]() -> const char*
+				{
+					return i + 1 < argc ? argv[++i] : nullptr;
+				};
+
+			if (arg == "-h" || arg == "--help")
+				return false;
+			else if (arg == "-a" || arg == "--all")
+				opt.keepDuplicates = true;
+			else if (arg == "-f" || arg == "--format")
+			{
+				const char* v = value();
+				if (!v)
+					return false;
+				if (std::strcmp(v, "jsonl") == 0)
+					opt.format = OutputFormat::JsonLines;
+				else if (std::strcmp(v, "csv") == 0)
+					opt.format = OutputFormat::Csv;
+				else
+				{
+					std::fprintf(stderr, "rlgrab_scan: unknown format '%s'\n", v);
+					return false;
+				}
+			}
+			else if (arg == "-o" || arg == "--output")
+			{
+				const char* v = value();
+				if (!v)
+					return false;
+				opt.outputPath = v;
+			}
+			else if (arg == "-j" || arg == "--threads")
+			{
+				const char* v = value();
+				if (!v)
+					return false;
+				opt.threads = (unsigned)std::max(1, std::atoi(v));
+			}
+			else if (arg == "-r" || arg == "--rules")
+			{
+				const char* v = value();
+				if (!v)
+					return false;
+				opt.rulesPath = v;
+			}
+			else if (arg == "-p" || arg == "--priority")
+			{
+				const char* v = value();
+				if (!v || !ParseThreadPriority(v, opt.qos.priority))
+					return false;
+				opt.setQoS = true;
+			}
+			else if (arg == "--background-io")
+			{
+				opt.qos.backgroundIo = true;
+				opt.setQoS = true;
+			}
+			else if (arg == "--affinity")
+			{
+				const char* v = value();
+				if (!v || !ParseAffinityMask(v, opt.qos.affinityMask))
+					return false;
+				opt.setQoS = true;
+			}
+			else if (arg == "--fuzz")
+			{
+				const char* v = value();
+				if (!v)
+					return false;
+				opt.fuzzSeconds = std::atof(v);
+				if (opt.fuzzSeconds <= 0.0)
+					return false;
+			}
+			else if (arg == "--pcap-check")
+				opt.pcapCheck = true;
+			else if (arg == "--seqlock-stress")
+			{
+				const char* v = value();
+				if (!v)
+					return false;
+				opt.stressSeconds = std::atof(v);
+				if (opt.stressSeconds <= 0.0)
+					return false;
+			}
+			else if (arg == "--tree-check")
+				opt.treeCheck = true;
+			else if (arg == "--bench")
+			{
+				const char* v = value();
+				if (!v)
+					return false;
+				opt.bench = v;
+			}
+			else if (arg == "--seed")
+			{
+				const char* v = value();
+				if (!v)
+					return false;
+				opt.fuzzSeed = std::strtoull(v, nullptr, 10);
+			}
+			else if (arg.size() > 1 && arg[0] == '-')
+			{
+				std::fprintf(stderr, "rlgrab_scan: unknown option '%s'\n", arg.c_str());
+				return false;
+			}
+			else
+				opt.inputs.push_back(arg);
+		}
+		return !opt.inputs.empty() || opt.fuzzSeconds > 0.0 || opt.stressSeconds > 0.0 || !opt.bench.empty() || opt.treeCheck;
+	}
+
+	bool IsLogFile(const std::filesystem::path& path)
+	{
+		std::string ext = path.extension().string();
+		std::transform(ext.begin(), ext.end(), ext.begin(), [](unsigned char c) { return (char)std::tolower(c); });
+		return ext == ".log";
+	}
+
+	// Explicit files are taken as-is; directories contribute their *.log
+	// files, or whatever `wanted` accepts.
+	std::vector<std::string> CollectFiles(const std::vector<std::string>& inputs, bool (*wanted)(const std::filesystem::path&) = IsLogFile)
+	{
+		std::vector<std::string> files;
+		for (const auto& input : inputs)
+		{
+			std::error_code ec;
+			if (std::filesystem::is_directory(input, ec))
+			{
+				auto options = std::filesystem::directory_options::skip_permission_denied;
+				for (auto it = std::filesystem::recursive_directory_iterator(input, options, ec);
+					!ec && it != std::filesystem::recursive_directory_iterator(); it.increment(ec))
+				{
+					if (it->is_regular_file(ec) && wanted(it->path()))
+						files.push_back(it->path().string());
+				}
+				if (ec)
+					std::fprintf(stderr, "rlgrab_scan: %s: %s\n", input.c_str(), ec.message().c_str());
+			}
+			else
+			{
+				files.push_back(input);
+			}
+		}
+
+		std::sort(files.begin(), files.end());
+		files.erase(std::unique(files.begin(), files.end()), files.end());
+		return files;
+	}
+
+	bool LoadRules(const std::string& path, ExtractionEngine& engine)
+	{
+		// Same layering as the plugin: built-in rules, then the user's file.
+		std::vector<ExtractionRule> rules = ExtractionEngine::DefaultRules();
+		if (!path.empty())
+		{
+			std::ifstream file(path, std::ios::in | std::ios::binary);
+			if (!file.is_open())
+			{
+				std::fprintf(stderr, "rlgrab_scan: cannot open rules file %s\n", path.c_str());
+				return false;
+			}
+			std::stringstream text;
+			text << file.rdbuf();
+			std::string error;
+			if (!ExtractionEngine::ParseRules(text.str(), rules, &error))
+			{
+				std::fprintf(stderr, "rlgrab_scan: %s: %s\n", path.c_str(), error.c_str());
+				return false;
+			}
+		}
+
+		std::string error;
+		if (!engine.Compile(rules, &error))
+		{
+			std::fprintf(stderr, "rlgrab_scan: rules failed to compile: %s\n", error.c_str());
+			return false;
+		}
+		return true;
+	}
+
+	// Whole buffer through one LaunchLogState. Returns the line count.
+	uint64_t ScanBuffer(std::string_view text, LaunchLogParser& parser, const std::string& source, std::vector<EndpointRecord>& out)
+	{
+		const char* p = text.data();
+		const char* end = p + text.size();
+		LaunchLogState state;
+		uint64_t lines = 0;
+		while (p < end)
+		{
+			const char* nl = static_cast<const char*>(std::memchr(p, '\n', (size_t)(end - p)));
+			const char* lineEnd = nl ? nl : end;
+			std::string_view line(p, (size_t)(lineEnd - p));
+			if (!line.empty() && line.back() == '\r')
+				line.remove_suffix(1);
+
+			parser.Feed(line, state, source, out);
+			lines++;
+			p = nl ? nl + 1 : end;
+		}
+		return lines;
+	}
+
+	// Whole file, straight out of the mapping.
+	void ScanFile(const std::string& path, LaunchLogParser& parser, FileResult& result)
+	{
+		MappedFile file;
+		if (!file.Open(path, &result.error))
+			return;
+
+		std::string_view text(reinterpret_cast<const char*>(file.data()), file.size());
+		result.lines = ScanBuffer(text, parser, path, result.endpoints);
+		result.bytes = file.size();
+	}
+
+	// ----------------- Parser cross-check -----------------
+
+	// Extra rules whose prefixes overlap the built-in ones, so the automaton
+	// has to report several rules per state without disturbing the fields
+	// the pairing logic reads.
+	const char* const kOverlappingRules =
+		"Server|Server|=\n"
+		"Name|Name=\"|\"\n"
+		"URL|URL=\"|EOL\n"
+		"Quoted|\"|\"\n"
+		"Tail|GameURL=\"|EOL\n";
+
+	// Everything the plugin and the scanner parse with, wired to one checker.
+	class CrossCheckHarness
+	{
+	public:
+		bool Init(std::string* error)
+		{
+			std::vector<ExtractionRule> rules = ExtractionEngine::DefaultRules();
+			if (!defaultEngine.Compile(rules, error))
+				return false;
+			if (!ExtractionEngine::ParseRules(kOverlappingRules, rules, error) || !extendedEngine.Compile(rules, error))
+				return false;
+
+			defaultParser = std::make_unique<LaunchLogParser>(defaultEngine);
+			extendedParser = std::make_unique<LaunchLogParser>(extendedEngine);
+			tailPath = (std::filesystem::temp_directory_path() / ("rlgrab_fuzz_" + std::to_string(std::random_device()()) + ".log")).string();
+
+			check.AddVariant("scanner", [this](std::string_view text, std::vector<EndpointRecord>& out)
+				{
+					ScanBuffer(text, *defaultParser, "fuzz", out);
+				});
+			check.AddVariant("scanner+rules", [this](std::string_view text, std::vector<EndpointRecord>& out)
+				{
+					ScanBuffer(text, *extendedParser, "fuzz", out);
+				});
+			check.AddVariant("tail", [this](std::string_view text, std::vector<EndpointRecord>& out)
+				{
+					TailInChunks(text, out);
+				});
+			check.AddBuiltinSeeds();
+			return true;
+		}
+
+		~CrossCheckHarness()
+		{
+			std::error_code ec;
+			if (!tailPath.empty())
+				std::filesystem::remove(tailPath, ec);
+		}
+
+		ParserCrossCheck& Check() { return check; }
+
+	private:
+		// Appends the text in random pieces and polls after each, with small
+		// byte budgets, the way the worker sees a log that is being written.
+		void TailInChunks(std::string_view text, std::vector<EndpointRecord>& out)
+		{
+			std::ofstream file(tailPath, std::ios::out | std::ios::binary | std::ios::trunc);
+			LogTail tail(tailPath);
+			LaunchLogState state;
+			auto onLine = [&](const std::string& line) { defaultParser->Feed(line, state, "fuzz", out); };
+			auto onRestart = [&]() { state.Clear(); };
+
+			size_t pos = 0;
+			while (pos < text.size())
+			{
+				size_t piece = std::min<size_t>(text.size() - pos, 1 + rng() % 256);
+				file.write(text.data() + pos, (std::streamsize)piece);
+				file.flush();
+				pos += piece;
+
+				LogTailLimits limits;
+				limits.maxBytes = 1 + rng() % 512;
+				while (tail.Poll(onLine, onRestart, limits).more)
+				{
+				}
+			}
+		}
+
+		ExtractionEngine defaultEngine;
+		ExtractionEngine extendedEngine;
+		std::unique_ptr<LaunchLogParser> defaultParser;
+		std::unique_ptr<LaunchLogParser> extendedParser;
+		std::string tailPath;
+		std::mt19937_64 rng{ 1 };
+		ParserCrossCheck check;
+	};
+
+	// Real logs are cut into excerpts around their GameURL lines.
+	void AddFileSeeds(ParserCrossCheck& check, const std::vector<std::string>& files)
+	{
+		constexpr size_t kExcerptBytes = 4096;
+		constexpr size_t kMaxSeeds = 512;
+		for (const auto& path : files)
+		{
+			MappedFile file;
+			std::string error;
+			if (!file.Open(path, &error))
+			{
+				std::fprintf(stderr, "rlgrab_scan: %s: %s\n", path.c_str(), error.c_str());
+				continue;
+			}
+
+			std::string_view text(reinterpret_cast<const char*>(file.data()), file.size());
+			for (size_t at = text.find("GameURL"); at != std::string_view::npos && check.SeedCount() < kMaxSeeds;
+				at = text.find("GameURL", at + kExcerptBytes))
+			{
+				size_t begin = text.rfind('\n', at > kExcerptBytes / 2 ? at - kExcerptBytes / 2 : 0);
+				begin = begin == std::string_view::npos ? 0 : begin + 1;
+				size_t end = text.find('\n', std::min(text.size(), begin + kExcerptBytes));
+				end = end == std::string_view::npos ? text.size() : end + 1;
+				check.AddSeed(std::string(text.substr(begin, end - begin)));
+			}
+		}
+	}
+
+	void PrintDivergence(const CrossCheckReport& report)
+	{
+		std::string input;
+		AppendEscaped(input, report.input);
+		std::fprintf(stderr, "rlgrab_scan: %s diverges from the reference parser\n%s\n  input (%zu bytes): \"%s\"\n",
+			report.variant.c_str(), report.detail.c_str(), report.input.size(), input.c_str());
+	}
+
+	int RunCrossCheck(const Options& opt)
+	{
+		CrossCheckHarness harness;
+		std::string error;
+		if (!harness.Init(&error))
+		{
+			std::fprintf(stderr, "rlgrab_scan: cross-check setup failed: %s\n", error.c_str());
+			return 2;
+		}
+		AddFileSeeds(harness.Check(), CollectFiles(opt.inputs));
+
+		CrossCheckOptions options;
+		options.seconds = opt.fuzzSeconds;
+		options.seed = opt.fuzzSeed;
+		CrossCheckReport report = harness.Check().Run(options);
+
+		double mib = (double)report.bytes / (1024.0 * 1024.0);
+		std::fprintf(stderr,
+			"rlgrab_scan: cross-checked %llu input(s) from %zu seed(s), %.1f MiB, %llu reference endpoint(s) in %.1f s: %.0f inputs/s, %.2f MiB/s\n",
+			(unsigned long long)report.iterations, harness.Check().SeedCount(), mib, (unsigned long long)report.endpoints,
+			report.seconds, report.seconds > 0 ? report.iterations / report.seconds : 0.0, report.seconds > 0 ? mib / report.seconds : 0.0);
+
+		if (report.divergences == 0)
+			return 0;
+		PrintDivergence(report);
+		return 1;
+	}
+
+	// ----------------- Capture reader check -----------------
+
+	int RunPcapCheck(const Options& opt)
+	{
+		std::vector<std::string> files = CollectFiles(opt.inputs, IsCaptureFile);
+		if (files.empty())
+		{
+			std::fprintf(stderr, "rlgrab_scan: no capture files found\n");
+			return 1;
+		}
+
+		size_t failed = 0;
+		for (const auto& path : files)
+		{
+			std::string detail;
+			if (CheckPcapSample(path, detail))
+				continue;
+			failed++;
+			std::fprintf(stderr, "rlgrab_scan: %s: %s\n", path.c_str(), detail.c_str());
+		}
+
+		std::fprintf(stderr, "rlgrab_scan: %zu of %zu capture(s) match\n", files.size() - failed, files.size());
+		return failed == 0 ? 0 : 1;
+	}
+
+	// ----------------- Seqlock stress -----------------
+
+	int RunPageStress(const Options& opt)
+	{
+		SeqlockStressOptions options;
+		options.seconds = opt.stressSeconds;
+		// Leave the writer a core of its own when there are several.
+		unsigned cores = std::max(1u, std::thread::hardware_concurrency());
+		options.readers = opt.threads ? opt.threads : std::max(2u, cores - 1);
+
+		SeqlockStressReport report = RunSeqlockStress(options);
+		std::fprintf(stderr,
+			"rlgrab_scan: %llu publish(es), %u reader(s), %llu snapshot(s), %llu load(s) gave up in %.1f s: %llu torn, %llu out of order\n",
+			(unsigned long long)report.publishes, options.readers, (unsigned long long)report.reads, (unsigned long long)report.gaveUp,
+			report.seconds, (unsigned long long)report.mismatches, (unsigned long long)report.regressions);
+
+		if (report.mismatches == 0 && report.regressions == 0)
+			return 0;
+		std::fprintf(stderr, "rlgrab_scan: %s\n", report.detail.c_str());
+		return 1;
+	}
+
+	// ----------------- Benchmarks -----------------
+
+	int RunBench(const Options& opt)
+	{
+		bool ok;
+		if (opt.bench == "rules")
+			ok = RunRuleBench(stdout);
+		else if (opt.bench == "qos")
+		{
+			QoSBenchOptions options;
+			options.scanThreads = opt.threads;
+			options.affinityMask = opt.qos.affinityMask;
+			RunQoSBench(stdout, options);
+			ok = true;
+		}
+		else if (opt.bench == "search")
+			ok = RunSearchBench(stdout);
+		else if (opt.bench == "history")
+			ok = RunHistoryBench(stdout);
+		else
+		{
+			std::fprintf(stderr, "rlgrab_scan: unknown benchmark '%s'\n", opt.bench.c_str());
+			return 2;
+		}
+		return ok ? 0 : 1;
+	}
+
+	// ----------------- Tree view format -----------------
+
+	int RunTreeCheck(const Options& opt)
+	{
+		TreeViewCheckOptions options;
+		options.seed = opt.fuzzSeed;
+		return RunTreeViewCheck(stdout, options) ? 0 : 1;
+	}
+}
+
+#ifdef RLGRAB_LIBFUZZER
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size)
+{
+	static CrossCheckHarness* harness = []()
+		{
+			auto* h = new CrossCheckHarness();
+			std::string error;
+			if (!h->Init(&error))
+				std::abort();
+			return h;
+		}();
+
+	std::string input(reinterpret_cast<const char*>(data), size);
+	if (input.empty() || input.back() != '\n')
+		input += '\n';
+
+	CrossCheckReport report;
+	if (!harness->Check().Check(input, report))
+	{
+		PrintDivergence(report);
+		std::abort();
+	}
+	return 0;
+}
+
+#else
+
+
+int main(int argc, char** argv)
+{
+	Options opt;
+	if (!ParseArgs(argc, argv, opt))
+	{
+		PrintUsage();
+		return 2;
+	}
+
+	if (opt.fuzzSeconds > 0.0)
+		return RunCrossCheck(opt);
+	if (opt.pcapCheck)
+		return RunPcapCheck(opt);
+	if (opt.stressSeconds > 0.0)
+		return RunPageStress(opt);
+	if (!opt.bench.empty())
+		return RunBench(opt);
+	if (opt.treeCheck)
+		return RunTreeCheck(opt);
+
+	ExtractionEngine engine;
+	if (!LoadRules(opt.rulesPath, engine))
+		return 2;
+
+	std::vector<std::string> files = CollectFiles(opt.inputs);
+	if (files.empty())
+	{
+		std::fprintf(stderr, "rlgrab_scan: no log files found\n");
+		return 1;
+	}
+
+	std::ofstream fileOut;
+	if (!opt.outputPath.empty())
+	{
+		fileOut.open(opt.outputPath, std::ios::out | std::ios::binary | std::ios::trunc);
+		if (!fileOut.is_open())
+		{
+			std::fprintf(stderr, "rlgrab_scan: cannot create %s\n", opt.outputPath.c_str());
+			return 2;
+		}
+	}
+	else
+	{
+		std::ios::sync_with_stdio(false);
+	}
+	std::ostream& out = opt.outputPath.empty() ? std::cout : fileOut;
+
+	// CSV gets one column per extra rule field, in rule order.
+	std::vector<std::string> extraColumns;
+	for (size_t f = 0; f < engine.FieldCount(); ++f)
+		if (engine.FieldName(f) != "ServerName" && engine.FieldName(f) != "GameURL")
+			extraColumns.push_back(engine.FieldName(f));
+
+	// Records are encoded into one buffer that goes out in large writes.
+	std::string buffer;
+	if (opt.format == OutputFormat::Csv)
+		AppendCsvHeader(buffer, extraColumns, false);
+
+	unsigned threadCount = opt.threads ? opt.threads : std::max(1u, std::thread::hardware_concurrency());
+	threadCount = std::min<unsigned>(threadCount, (unsigned)files.size());
+
+	auto start = std::chrono::steady_clock::now();
+
+	// Threads claim files in order; main writes results in the same order as
+	// soon as the next one is done. A thread waits before parsing a file more
+	// than `window` files past the last one written, so at most that many
+	// parsed files are held in memory however slow the first one is.
+	std::vector<FileResult> results(files.size());
+	std::atomic<size_t> nextFile{ 0 };
+	std::mutex doneMutex;
+	std::condition_variable doneCv;
+	std::condition_variable windowCv;
+	const size_t window = (size_t)threadCount * 2;
+	size_t filesWritten = 0; // guarded by doneMutex
+
+	std::vector<std::thread> threads;
+	for (unsigned t = 0; t < threadCount; ++t)
+	{
+		threads.emplace_back([&]()
+			{
+				std::string qosError;
+				if (opt.setQoS && !ApplyCurrentThreadQoS(opt.qos, &qosError))
+					std::fprintf(stderr, "rlgrab_scan: thread QoS only partly applied: %s\n", qosError.c_str());
+				LaunchLogParser parser(engine);
+				for (size_t i = nextFile++; i < files.size(); i = nextFile++)
+				{
+					{
+						std::unique_lock<std::mutex> lock(doneMutex);
+						windowCv.wait(lock, [&]() { return i < filesWritten + window; });
+					}
+					ScanFile(files[i], parser, results[i]);
+					{
+						std::lock_guard<std::mutex> lock(doneMutex);
+						results[i].done = true;
+					}
+					doneCv.notify_one();
+				}
+			});
+	}
+
+	EndpointDeduplicator dedup;
+	uint64_t totalBytes = 0;
+	uint64_t totalLines = 0;
+	uint64_t totalEndpoints = 0;
+	uint64_t written = 0;
+	size_t failed = 0;
+
+	for (size_t i = 0; i < files.size(); ++i)
+	{
+		{
+			std::unique_lock<std::mutex> lock(doneMutex);
+			doneCv.wait(lock, [&]() { return results[i].done; });
+		}
+
+		FileResult& r = results[i];
+		if (!r.error.empty())
+		{
+			std::fprintf(stderr, "rlgrab_scan: %s: %s\n", files[i].c_str(), r.error.c_str());
+			failed++;
+		}
+
+		totalBytes += r.bytes;
+		totalLines += r.lines;
+		totalEndpoints += r.endpoints.size();
+		for (const auto& ep : r.endpoints)
+		{
+			if (!dedup.Accept(ep) && !opt.keepDuplicates)
+				continue;
+			if (opt.format == OutputFormat::JsonLines)
+				AppendJsonRecord(buffer, ep, false);
+			else
+				AppendCsvRecord(buffer, ep, extraColumns, false);
+			written++;
+		}
+		if (buffer.size() >= (1 << 20))
+		{
+			out.write(buffer.data(), (std::streamsize)buffer.size());
+			buffer.clear();
+		}
+
+		std::vector<EndpointRecord>().swap(r.endpoints);
+		{
+			std::lock_guard<std::mutex> lock(doneMutex);
+			filesWritten = i + 1;
+		}
+		windowCv.notify_all();
+	}
+
+	for (auto& t : threads)
+		t.join();
+	out.write(buffer.data(), (std::streamsize)buffer.size());
+	out.flush();
+
+	double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	double mib = (double)totalBytes / (1024.0 * 1024.0);
+	std::fprintf(stderr,
+		"rlgrab_scan: %zu file(s), %.1f MiB, %llu lines, %llu endpoint(s), %llu unique, %llu written"
+		" in %.3f s on %u thread(s): %.1f MiB/s, %.0f lines/s\n",
+		files.size() - failed, mib, (unsigned long long)totalLines, (unsigned long long)totalEndpoints,
+		(unsigned long long)dedup.Size(), (unsigned long long)written,
+		elapsed, threadCount, elapsed > 0 ? mib / elapsed : 0.0, elapsed > 0 ? totalLines / elapsed : 0.0);
+
+	return failed ? 1 : 0;
+}
+
+#endif
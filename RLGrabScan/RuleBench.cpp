@@ -0,0 +1,207 @@
+#include "RuleBench.h"
+#include "ExtractionRules.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <random>
+#include <regex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace
+{
+	constexpr size_t kCorpusBytes = 8u << 20;
+	constexpr double kRegexSeconds = 1.0;
+	constexpr int kAutomatonPasses = 5;
+	constexpr size_t kRuleCounts[] = { 8, 16, 32, 64, 128 };
+
+	// Extra rules look like the ones users add: Key="..." pairs and a few
+	// that run to the end of the line.
+	std::vector<ExtractionRule> MakeRules(size_t count)
+	{
+		std::vector<ExtractionRule> rules = ExtractionEngine::DefaultRules();
+		for (size_t i = rules.size(); i < count; ++i)
+		{
+			std::string key = "Field" + std::to_string(i);
+			if (i % 8 == 7)
+				rules.push_back({ key, key + ": ", kEndOfLine });
+			else
+				rules.push_back({ key, key + "=\"", '"' });
+		}
+		return rules;
+	}
+
+	// Mostly unrelated engine chatter, some join lines, and lines carrying
+	// the extra keys so their rules match now and then.
+	std::vector<std::string> MakeCorpus(size_t extraKeys)
+	{
+		static const char* const kChatter[] = {
+			"[0012.01] Log: LoadMap: /Game/Maps/Park_P?Game=TAGame.GameInfo_Soccar_TA",
+			"[0012.05] DevNet: Browse: 185.60.112.7:7791/Game/Maps/Park_P",
+			"[0012.10] Log: Texture streaming pool size now 1200 MB",
+			"[0012.13] ScriptLog: PsyNet RPC Products/GetPlayerProducts completed",
+			"[0012.20] Log: Server=\"none\" Name=\"quoted\" GameUR=\"almost\" Serve",
+			"[0012.30] DevOnline: OnlineSubsystem LoginStatus changed to LoggedIn",
+		};
+
+		std::mt19937_64 rng(1);
+		std::vector<std::string> lines;
+		size_t bytes = 0;
+		while (bytes < kCorpusBytes)
+		{
+			std::string line;
+			uint64_t r = rng() % 100;
+			if (r < 80)
+				line = kChatter[rng() % std::size(kChatter)];
+			else if (r < 90)
+				line = "[0013.00] Log: Joining ServerName=\"EU-Frankfurt-" + std::to_string(rng() % 100)
+					+ "\" GameURL=\"185.60.112." + std::to_string(rng() % 256) + ":" + std::to_string(7000 + rng() % 1000) + "\"";
+			else
+			{
+				line = "[0013.50] Log: Match";
+				for (int k = 0; k < 3; ++k)
+				{
+					size_t key = 2 + rng() % std::max<size_t>(extraKeys, 1);
+					if (key % 8 == 7)
+						line += " Field" + std::to_string(key) + ": tail " + std::to_string(rng() % 1000);
+					else
+						line += " Field" + std::to_string(key) + "=\"v" + std::to_string(rng() % 1000) + "\"";
+				}
+			}
+			bytes += line.size() + 1;
+			lines.push_back(std::move(line));
+		}
+		return lines;
+	}
+
+	std::string EscapeRegex(const std::string& s)
+	{
+		std::string out;
+		for (char c : s)
+		{
+			if (std::strchr("\\^$.|?*+()[]{}", c))
+				out += '\\';
+			out += c;
+		}
+		return out;
+	}
+
+	// One regex_search per rule per line; first match per field wins, as
+	// in the automaton.
+	class RegexExtractor
+	{
+	public:
+		explicit RegexExtractor(const std::vector<ExtractionRule>& rules)
+		{
+			for (const auto& rule : rules)
+			{
+				std::string value = rule.terminator == kEndOfLine
+					? "(.*)"
+					: "([^" + EscapeRegex(std::string(1, (char)rule.terminator)) + "]*)" + EscapeRegex(std::string(1, (char)rule.terminator));
+				auto it = std::find(fields.begin(), fields.end(), rule.field);
+				patterns.push_back({ (uint32_t)(it - fields.begin()), std::regex(EscapeRegex(rule.prefix) + value) });
+				if (it == fields.end())
+					fields.push_back(rule.field);
+			}
+		}
+
+		// Rules are tried in order; a field keeps its earliest match.
+		void ExtractLine(const std::string& line, std::vector<std::string_view>& out) const
+		{
+			out.assign(fields.size(), std::string_view());
+			std::vector<size_t> at(fields.size(), SIZE_MAX);
+			std::smatch m;
+			for (const auto& p : patterns)
+			{
+				if (!std::regex_search(line, m, p.regex))
+					continue;
+				size_t pos = (size_t)m.position(1);
+				if (pos < at[p.field])
+				{
+					at[p.field] = pos;
+					out[p.field] = std::string_view(line.data() + pos, (size_t)m.length(1));
+				}
+			}
+		}
+
+	private:
+		struct Pattern
+		{
+			uint32_t field;
+			std::regex regex;
+		};
+		std::vector<std::string> fields;
+		std::vector<Pattern> patterns;
+	};
+
+	bool SameValues(const std::vector<std::string_view>& a, const std::vector<std::string_view>& b)
+	{
+		for (size_t i = 0; i < a.size(); ++i)
+		{
+			if ((a[i].data() == nullptr) != (b[i].data() == nullptr) || a[i] != b[i])
+				return false;
+		}
+		return true;
+	}
+}
+
+bool RunRuleBench(std::FILE* out)
+{
+	std::fprintf(out, "%6s %14s %12s %8s\n", "rules", "automaton MB/s", "regex MB/s", "speedup");
+
+	for (size_t ruleCount : kRuleCounts)
+	{
+		std::vector<ExtractionRule> rules = MakeRules(ruleCount);
+		std::vector<std::string> corpus = MakeCorpus(ruleCount - 2);
+
+		ExtractionEngine engine;
+		std::string error;
+		if (!engine.Compile(rules, &error))
+		{
+			std::fprintf(out, "rules failed to compile: %s\n", error.c_str());
+			return false;
+		}
+		RegexExtractor regex(rules);
+
+		// Automaton: the whole corpus, best of a few passes.
+		ExtractedFields extracted;
+		uint64_t bytes = 0;
+		for (const auto& line : corpus)
+			bytes += line.size() + 1;
+		double automatonSeconds = 1e30;
+		for (int pass = 0; pass < kAutomatonPasses; ++pass)
+		{
+			auto start = std::chrono::steady_clock::now();
+			for (const auto& line : corpus)
+				engine.ExtractLine(line, extracted);
+			automatonSeconds = std::min(automatonSeconds, std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+		}
+		double automatonMBs = (double)bytes / 1e6 / automatonSeconds;
+
+		// Regex: as many lines as fit the time box, each checked against
+		// the automaton outside the timed part.
+		std::vector<std::string_view> values;
+		uint64_t regexBytes = 0;
+		double regexSeconds = 0.0;
+		for (size_t i = 0; i < corpus.size() && regexSeconds < kRegexSeconds; ++i)
+		{
+			auto lineStart = std::chrono::steady_clock::now();
+			regex.ExtractLine(corpus[i], values);
+			regexSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - lineStart).count();
+			regexBytes += corpus[i].size() + 1;
+
+			engine.ExtractLine(corpus[i], extracted);
+			if (!SameValues(values, extracted.values))
+			{
+				std::fprintf(out, "%zu rules: regex and automaton disagree on line %zu: %s\n", ruleCount, i, corpus[i].c_str());
+				return false;
+			}
+		}
+		double regexMBs = (double)regexBytes / 1e6 / regexSeconds;
+
+		std::fprintf(out, "%6zu %14.1f %12.2f %7.0fx\n", ruleCount, automatonMBs, regexMBs, automatonMBs / regexMBs);
+	}
+	return true;
+}
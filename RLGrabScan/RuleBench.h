@@ -0,0 +1,16 @@
+#pragma once
+
+// Throughput of the compiled extraction automaton against a regex per rule,
+// the way the plugin extracted fields before rules were compiled.
+//
+// Both paths run over the same synthetic Launch.log text at 8 to 128 rules;
+// the automaton takes the best of 5 passes, the regex path is time-boxed
+// because it slows down with every rule. Both must extract the same values
+// from every line or the run fails.
+//
+// Portable, no SDK dependencies.
+
+#include <cstdio>
+
+// Prints one row per rule count to `out`. Returns false on a mismatch.
+bool RunRuleBench(std::FILE* out);
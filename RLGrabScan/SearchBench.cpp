@@ -0,0 +1,110 @@
+#include "SearchBench.h"
+#include "EndpointSearch.h"
+
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace
+{
+	constexpr uint32_t kEndpoints = 100000;
+	constexpr uint32_t kAddedRows = 1000;
+
+	std::vector<std::string> MakeLabels(uint32_t count)
+	{
+		static const char* const kRegions[] = {
+			"EU-Frankfurt", "EU-Paris", "EU-London", "USE-Ashburn", "USW-SanJose",
+			"OCE-Sydney", "SAM-SaoPaulo", "ASC-Singapore", "ME-Bahrain", "ASM-Tokyo",
+		};
+
+		std::mt19937 rng(3);
+		std::vector<std::string> labels;
+		labels.reserve(count);
+		for (uint32_t i = 0; i < count; ++i)
+		{
+			char buf[128];
+			std::snprintf(buf, sizeof(buf), "%s-%u (%u.%u.7.%u:%u)", kRegions[rng() % std::size(kRegions)],
+				(unsigned)(rng() % 400), (unsigned)(rng() % 256), (unsigned)(rng() % 256), (unsigned)(rng() % 256),
+				7000u + (unsigned)(rng() % 800));
+			labels.push_back(buf);
+		}
+		return labels;
+	}
+
+	// Same contract as EndpointSearch: every folded word occurs in the folded label.
+	size_t CountMatches(const std::vector<std::string>& folded, const std::string& query)
+	{
+		std::string q;
+		EndpointSearchIndex::Fold(query, q);
+		std::vector<std::string> words;
+		for (size_t p = q.find_first_not_of(' '); p != std::string::npos; p = q.find_first_not_of(' ', p))
+		{
+			size_t e = std::min(q.find(' ', p), q.size());
+			words.push_back(q.substr(p, e - p));
+			p = e;
+		}
+
+		size_t n = 0;
+		for (const auto& label : folded)
+			n += std::all_of(words.begin(), words.end(), [&](const std::string& w) { return label.find(w) != std::string::npos; });
+		return n;
+	}
+}
+
+bool RunSearchBench(std::FILE* out)
+{
+	std::vector<std::string> labels = MakeLabels(kEndpoints);
+	std::vector<std::string> folded(labels.size());
+	for (size_t i = 0; i < labels.size(); ++i)
+		EndpointSearchIndex::Fold(labels[i], folded[i]);
+
+	EndpointSearchIndex index;
+	auto start = std::chrono::steady_clock::now();
+	for (uint32_t i = 0; i < labels.size(); ++i)
+		index.Insert(i, labels[i]);
+	double buildMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+	std::fprintf(out, "index build, %u labels: %.1f ms\n", kEndpoints, buildMs);
+	std::fprintf(out, "%-10s %-24s %7s %10s %-8s %10s\n", "step", "query", "hits", "candidates", "narrowed", "us");
+
+	EndpointSearch search;
+	bool ok = true;
+	auto run = [&](const char* step, const std::string& query)
+		{
+			auto t = std::chrono::steady_clock::now();
+			search.Update(index, query);
+			double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - t).count();
+
+			std::fprintf(out, "%-10s %-24s %7zu %10llu %-8s %10.1f\n", step, ("\"" + query + "\"").c_str(), search.Results().size(),
+				(unsigned long long)search.LastStats().candidates, search.LastStats().narrowed ? "yes" : "no", us);
+
+			size_t expected = CountMatches(folded, query);
+			if (expected != search.Results().size())
+			{
+				std::fprintf(out, "  mismatch: a full scan finds %zu\n", expected);
+				ok = false;
+			}
+		};
+
+	const std::string typed = "eu-frankfurt-12 185";
+	for (size_t i = 1; i <= typed.size(); ++i)
+		run("type", typed.substr(0, i));
+	for (size_t i = typed.size(); i-- > 0;)
+		if (i % 4 == 0)
+			run("backspace", typed.substr(0, i));
+
+	for (const char* query : { "7.1", "sydney", "zzz", "PARIS 7777" })
+		run("fresh", query);
+
+	// Rows stored while a filter is active are checked on their own.
+	for (uint32_t i = 0; i < kAddedRows; ++i)
+	{
+		index.Insert((uint32_t)labels.size(), labels[i]);
+		labels.push_back(labels[i]);
+		folded.push_back(folded[i]);
+	}
+	run("+1k rows", "PARIS 7777");
+
+	return ok;
+}
@@ -0,0 +1,15 @@
+#pragma once
+
+// Type-to-filter search at scale: 100k synthetic endpoint labels.
+//
+// Times the trigram index build, then a query typed one key at a time,
+// backspaced, a few fresh queries, and one more after rows were added to
+// a filtered list. Every result is checked against a brute-force scan of
+// the folded labels outside the timed part.
+//
+// Portable, no SDK dependencies.
+
+#include <cstdio>
+
+// Prints one row per search step to `out`. Returns false on a mismatch.
+bool RunSearchBench(std::FILE* out);
@@ -0,0 +1,133 @@
+#include "SeqlockStress.h"
+#include "SharedEndpointPage.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace
+{
+	// Distinct text and numbers per serial, long enough to span several
+	// payload words.
+	void FillSlot(SharedEndpointSlot& slot, uint64_t serial)
+	{
+		std::memset(&slot, 0, sizeof(slot));
+		std::snprintf(slot.serverName, sizeof(slot.serverName), "EU-Stress-%llu-%llx",
+			(unsigned long long)serial, (unsigned long long)(serial * 0x9E3779B97F4A7C15ull));
+		std::snprintf(slot.gameUrl, sizeof(slot.gameUrl), "10.%u.%u.%u:%u",
+			(unsigned)(serial >> 16) & 0xFF, (unsigned)(serial >> 8) & 0xFF, (unsigned)serial & 0xFF,
+			7000u + (unsigned)(serial % 3000));
+		slot.seenUnixMs = 1700000000000ull + serial;
+		slot.serial = serial;
+	}
+
+	// What SharedEndpointWriter::Publish leaves behind after `count` publishes.
+	void ExpectedPayload(uint64_t count, SharedEndpointPayload& out)
+	{
+		std::memset(&out, 0, sizeof(out));
+		out.totalPublished = count;
+		if (count == 0)
+			return;
+
+		FillSlot(out.latest, count);
+		out.historyCount = (uint32_t)std::min<uint64_t>(count, kSharedEndpointHistory);
+		out.historyHead = (uint32_t)((count - 1) % kSharedEndpointHistory);
+		for (uint32_t age = 0; age < out.historyCount; ++age)
+		{
+			uint32_t idx = (out.historyHead + kSharedEndpointHistory - age) % kSharedEndpointHistory;
+			FillSlot(out.history[idx], count - age);
+		}
+	}
+}
+
+SeqlockStressReport RunSeqlockStress(const SeqlockStressOptions& options)
+{
+	SeqlockStressReport report;
+
+	auto page = std::make_unique<SharedEndpointPage>();
+	page->magic = kSharedEndpointMagic;
+	page->version = kSharedEndpointVersion;
+	page->payloadSize = sizeof(SharedEndpointPayload);
+	page->sequence.store(0);
+	SharedEndpointPayload shadow;
+	ExpectedPayload(0, shadow);
+	SharedEndpointStore(*page, shadow);
+
+	std::atomic<bool> stop{ false };
+	std::atomic<uint64_t> reads{ 0 }, gaveUp{ 0 }, mismatches{ 0 }, regressions{ 0 };
+	std::mutex detailMutex;
+
+	auto fail = [&](std::atomic<uint64_t>& counter, std::string what)
+		{
+			counter++;
+			std::lock_guard<std::mutex> lock(detailMutex);
+			if (report.detail.empty())
+				report.detail = std::move(what);
+		};
+
+	std::vector<std::thread> readers;
+	for (unsigned r = 0; r < std::max(1u, options.readers); ++r)
+	{
+		readers.emplace_back([&]()
+			{
+				SharedEndpointPayload snap, expected;
+				uint64_t last = 0, localReads = 0, localGaveUp = 0;
+				while (!stop.load(std::memory_order_relaxed))
+				{
+					if (!SharedEndpointLoad(*page, snap, options.maxAttempts))
+					{
+						localGaveUp++;
+						continue;
+					}
+					localReads++;
+
+					if (snap.totalPublished < last)
+						fail(regressions, "publish count went from " + std::to_string(last) + " to " + std::to_string(snap.totalPublished));
+					last = snap.totalPublished;
+
+					ExpectedPayload(snap.totalPublished, expected);
+					if (std::memcmp(&snap, &expected, sizeof(snap)) != 0)
+						fail(mismatches, "torn snapshot at publish " + std::to_string(snap.totalPublished)
+							+ ": latest \"" + std::string(snap.latest.gameUrl, std::find(std::begin(snap.latest.gameUrl), std::end(snap.latest.gameUrl), '\0'))
+							+ "\" serial " + std::to_string(snap.latest.serial));
+				}
+				reads += localReads;
+				gaveUp += localGaveUp;
+			});
+	}
+
+	// The writer updates its shadow the way Publish does and stores it whole.
+	auto start = std::chrono::steady_clock::now();
+	auto end = start + std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(options.seconds));
+	uint64_t count = 0;
+	while ((count & 1023) != 0 || std::chrono::steady_clock::now() < end)
+	{
+		count++;
+		FillSlot(shadow.latest, count);
+		if (shadow.historyCount > 0)
+			shadow.historyHead = (shadow.historyHead + 1) % kSharedEndpointHistory;
+		if (shadow.historyCount < kSharedEndpointHistory)
+			shadow.historyCount++;
+		shadow.history[shadow.historyHead] = shadow.latest;
+		shadow.totalPublished = count;
+		SharedEndpointStore(*page, shadow);
+	}
+	stop = true;
+	for (auto& t : readers)
+		t.join();
+
+	report.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	report.publishes = count;
+	report.reads = reads;
+	report.gaveUp = gaveUp;
+	report.mismatches = mismatches;
+	report.regressions = regressions;
+	return report;
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+// Stress check for the shared endpoint page's seqlock (SharedEndpointPage.h).
+//
+// One writer republishes the payload as fast as it can while reader threads
+// take snapshots with SharedEndpointLoad, the same call overlays make every
+// frame. Every payload is a pure function of its publish count, history
+// ring included, so a reader can rebuild what it should have seen and any
+// torn copy shows up as a mismatch. Readers also check that the publish
+// count never goes backwards.
+//
+// The page is private to the process, so a running plugin's page and the
+// overlays reading it are left alone.
+//
+// Portable, no SDK dependencies.
+
+#include <cstdint>
+#include <string>
+
+struct SeqlockStressOptions
+{
+	double   seconds = 5.0;
+	unsigned readers = 4;
+	int      maxAttempts = 4;     // per SharedEndpointLoad, as the reader header defaults
+};
+
+struct SeqlockStressReport
+{
+	uint64_t publishes = 0;
+	uint64_t reads = 0;           // snapshots returned
+	uint64_t gaveUp = 0;          // loads that hit the writer on every attempt
+	uint64_t mismatches = 0;      // snapshot differs from the payload of its count
+	uint64_t regressions = 0;     // publish count went backwards within a reader
+	double   seconds = 0.0;
+	std::string detail;           // first failure
+};
+
+SeqlockStressReport RunSeqlockStress(const SeqlockStressOptions& options);
@@ -0,0 +1,295 @@
+#include "TreeViewCheck.h"
+
+#include "imgui.h"
+#include "imguivariouscontrols.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace
+{
+	using Clock = std::chrono::steady_clock;
+
+	double MsSince(Clock::time_point start)
+	{
+		return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+	}
+
+	// ----------------- Tree dumps -----------------
+
+	void DumpTreeView(const ImGui::TreeViewNode* node, std::string& out, int depth)
+	{
+		for (int i = 0; i < node->getNumChildNodes(); ++i)
+		{
+			const ImGui::TreeViewNode* c = node->getChildNode(i);
+			char buf[64];
+			std::snprintf(buf, sizeof(buf), "%d|%d|%d|%d|", depth, c->state, c->getUserId(), (int)c->isLeafNode());
+			out += buf;
+			out += c->getDisplayName();
+			out += '|';
+			out += c->getTooltip() ? c->getTooltip() : "<null>";
+			out += '|';
+			out += c->getUserText() ? c->getUserText() : "<null>";
+			out += '\n';
+			DumpTreeView(c, out, depth + 1);
+		}
+	}
+
+	std::string DumpTreeView(const ImGui::TreeView& tree)
+	{
+		std::string out;
+		char buf[64];
+		std::snprintf(buf, sizeof(buf), "options %d %d %d\n", (int)tree.allowMultipleSelection,
+			tree.getCollapseNodesToLeafNodesAtDepth(), (int)tree.checkboxMode);
+		out += buf;
+		for (int i = 0; const ImGui::TreeViewNode* root = tree.getRootNode(i); ++i)
+		{
+			out += "root\n";
+			DumpTreeView(root, out, 0);
+		}
+		return out;
+	}
+
+	std::string DumpFlatTreeView(ImGui::FlatTreeView& tree)
+	{
+		std::string out;
+		char buf[128];
+		std::snprintf(buf, sizeof(buf), "options %d %d\n", (int)tree.allowMultipleSelection, (int)tree.showCheckboxes);
+		out += buf;
+		for (int i = 0; i < tree.getNumNodes(); ++i)
+		{
+			int states = 0;
+			for (int k = 0; k < ImGui::FlatTreeView::STATE_COUNT; ++k)
+				if (tree.isStatePresent(i, 1 << k))
+					states |= 1 << k;
+			std::snprintf(buf, sizeof(buf), "%d %d %d %d %d %d %d|", tree.getParentNode(i), tree.getFirstChildNode(i),
+				tree.getNextSiblingNode(i), tree.getNumChildNodes(i), tree.getDepth(i), tree.getUserId(i), states);
+			out += buf;
+			out += tree.getDisplayName(i);
+			out += '\n';
+		}
+		for (int r = 0, rows = tree.getNumVisibleRows(); r < rows; ++r)
+		{
+			std::snprintf(buf, sizeof(buf), "%d,", tree.getVisibleRowNode(r));
+			out += buf;
+		}
+		return out;
+	}
+
+	// No state may name a node past the end, nor leak into nodes added later.
+	bool StatesInRange(ImGui::FlatTreeView& tree)
+	{
+		const int n = tree.getNumNodes();
+		ImVector<int> nodes;
+		for (int k = 0; k < ImGui::FlatTreeView::STATE_COUNT; ++k)
+		{
+			tree.getAllNodesWithState(nodes, 1 << k);
+			for (int node : nodes)
+				if (node < 0 || node >= n)
+					return false;
+		}
+
+		int added = tree.addNode("added after load");
+		for (int k = 0; k < ImGui::FlatTreeView::STATE_COUNT; ++k)
+			if (tree.isStatePresent(added, 1 << k))
+				return false;
+		return true;
+	}
+
+	// Sets every bit of each state's last bitset word in the "STAT" block
+	// (see the format notes in imguivariouscontrols.cpp).
+	void SetStatePadding(ImVector<char>& buf)
+	{
+		size_t off = 16;
+		while (off + 8 <= (size_t)buf.Size)
+		{
+			ImU32 tag, size;
+			std::memcpy(&tag, buf.Data + off, 4);
+			std::memcpy(&size, buf.Data + off + 4, 4);
+			if (std::memcmp(&tag, "STAT", 4) == 0 && size >= 8)
+			{
+				ImU32 counts[2];
+				std::memcpy(counts, buf.Data + off + 8, sizeof(counts));
+				for (ImU32 s = 0; s < counts[0] && counts[1] > 0; ++s)
+				{
+					size_t word = off + 16 + ((size_t)s * counts[1] + counts[1] - 1) * 4;
+					if (word + 4 <= off + 8 + size)
+						std::memset(buf.Data + word, 0xFF, 4);
+				}
+				return;
+			}
+			off += 8 + size + ((4 - (size & 3)) & 3);
+		}
+	}
+
+	void Corrupt(std::mt19937& rng, const ImVector<char>& in, ImVector<char>& out, int k)
+	{
+		out = in;
+		if (k < 10)
+			out.resize((int)(rng() % (in.Size + 1)));
+		else if (out.Size > 0)
+			out[(int)(rng() % out.Size)] ^= (char)(1 + rng() % 255);
+	}
+
+	// ----------------- Random trees -----------------
+
+	void RandomTreeView(std::mt19937& rng, ImGui::TreeView& tree)
+	{
+		tree.setCollapseNodesToLeafNodesAtDepth((int)(rng() % 3) - 1);
+		std::vector<ImGui::TreeViewNode*> all;
+		const int count = (int)(rng() % 300);
+		for (int i = 0; i < count; ++i)
+		{
+			std::string name = "n" + std::to_string(rng());
+			const char* tooltip = rng() % 3 == 0 ? "tip" : nullptr;
+			const char* userText = rng() % 4 == 0 ? "ut\nx" : nullptr;
+			ImGui::TreeViewNode* parent = all.empty() || rng() % 4 == 0 ? nullptr : all[rng() % all.size()];
+			ImGui::TreeViewNode::Data data(name.c_str(), tooltip, userText, (int)rng());
+			bool childVector = rng() % 5 == 0;
+			ImGui::TreeViewNode* node = parent ? parent->addChildNode(data, -1, childVector) : tree.addRootNode(data, -1, childVector);
+			node->state = (int)(rng() & 0xFFFF);
+			all.push_back(node);
+		}
+	}
+
+	void RandomFlatTreeView(std::mt19937& rng, ImGui::FlatTreeView& tree)
+	{
+		const int count = (int)(rng() % 500);
+		for (int i = 0; i < count; ++i)
+		{
+			int parent = i == 0 || rng() % 4 == 0 ? -1 : (int)(rng() % i);
+			tree.addNode(("f" + std::to_string(rng() % 1000)).c_str(), parent, (int)rng());
+			if (rng() % 2)
+				tree.addState((int)(rng() % (i + 1)), 1 << (rng() % 8));
+			if (rng() % 20 == 0)
+				tree.setDisplayName((int)(rng() % (i + 1)), "renamed");
+		}
+	}
+}
+
+bool RunTreeViewCheck(std::FILE* out, const TreeViewCheckOptions& options)
+{
+	// The trees allocate through ImGui and read style colours on construction.
+	ImGuiContext* context = ImGui::CreateContext();
+
+	std::mt19937 rng((uint32_t)options.seed);
+	uint64_t mismatches = 0, corruptLoads = 0, corruptAccepted = 0, paddingLeaks = 0;
+	std::string firstMismatch;
+	auto mismatch = [&](const std::string& what)
+		{
+			if (mismatches++ == 0)
+				firstMismatch = what;
+		};
+
+	for (uint64_t it = 0; it < options.iterations; ++it)
+	{
+		ImGui::TreeView tree(ImGui::TreeViewNode::MODE_ALL, (rng() & 1) != 0, ImGui::TreeViewNode::MODE_LEAF);
+		RandomTreeView(rng, tree);
+		ImVector<char> buf;
+		tree.saveBinary(buf);
+		ImGui::TreeView loaded;
+		if (!loaded.loadBinary(buf.Data, (size_t)buf.Size))
+			mismatch("TreeView iteration " + std::to_string(it) + ": its own save does not load");
+		else if (DumpTreeView(tree) != DumpTreeView(loaded))
+			mismatch("TreeView iteration " + std::to_string(it) + ": loaded tree differs");
+
+		ImVector<char> bad;
+		for (int k = 0; k < 20; ++k)
+		{
+			Corrupt(rng, buf, bad, k);
+			ImGui::TreeView t;
+			corruptAccepted += t.loadBinary(bad.Data, (size_t)bad.Size);
+			corruptLoads++;
+		}
+
+		ImGui::FlatTreeView flat((rng() & 1) != 0, (rng() & 1) != 0);
+		RandomFlatTreeView(rng, flat);
+		flat.saveBinary(buf);
+		ImGui::FlatTreeView flatLoaded;
+		if (!flatLoaded.loadBinary(buf.Data, (size_t)buf.Size))
+			mismatch("FlatTreeView iteration " + std::to_string(it) + ": its own save does not load");
+		else if (DumpFlatTreeView(flat) != DumpFlatTreeView(flatLoaded))
+			mismatch("FlatTreeView iteration " + std::to_string(it) + ": loaded tree differs");
+
+		// Padding bits in the state bitsets are ignored, whatever the file says.
+		ImVector<char> padded = buf;
+		SetStatePadding(padded);
+		ImGui::FlatTreeView paddedLoaded;
+		if (paddedLoaded.loadBinary(padded.Data, (size_t)padded.Size) && !StatesInRange(paddedLoaded))
+			paddingLeaks++;
+
+		for (int k = 0; k < 20; ++k)
+		{
+			Corrupt(rng, buf, bad, k);
+			ImGui::FlatTreeView t;
+			if (t.loadBinary(bad.Data, (size_t)bad.Size))
+			{
+				corruptAccepted++;
+				if (!StatesInRange(t))
+					paddingLeaks++;
+				t.getNumVisibleRows();
+			}
+			corruptLoads++;
+		}
+	}
+
+	std::fprintf(out, "round trips: %llu of each kind, %llu mismatch(es); corrupted loads: %llu, %llu accepted; state bits past the last node: %llu\n",
+		(unsigned long long)options.iterations, (unsigned long long)mismatches, (unsigned long long)corruptLoads,
+		(unsigned long long)corruptAccepted, (unsigned long long)paddingLeaks);
+	if (!firstMismatch.empty())
+		std::fprintf(out, "first mismatch: %s\n", firstMismatch.c_str());
+
+	// Timing: 50 regions x 2000 servers x 1 address = 200k nodes.
+	const int regions = 50, servers = 2000;
+	ImGui::TreeView tree;
+	ImGui::FlatTreeView flat;
+	char name[64];
+	for (int a = 0; a < regions; ++a)
+	{
+		std::snprintf(name, sizeof(name), "region %d", a);
+		ImGui::TreeViewNode* regionNode = tree.addRootNode(ImGui::TreeViewNode::Data(name), -1, true);
+		int regionFlat = flat.addNode(name);
+		for (int s = 0; s < servers; ++s)
+		{
+			std::snprintf(name, sizeof(name), "server %d", s);
+			ImGui::TreeViewNode* serverNode = regionNode->addChildNode(ImGui::TreeViewNode::Data(name), -1, true);
+			int serverFlat = flat.addNode(name, regionFlat);
+			std::snprintf(name, sizeof(name), "10.%d.%d.1:7777", a, s);
+			serverNode->addChildNode(ImGui::TreeViewNode::Data(name, "tooltip"), -1);
+			flat.addNode(name, serverFlat, a * servers + s);
+		}
+	}
+
+	ImVector<char> treeBuf, flatBuf;
+	auto start = Clock::now();
+	tree.saveBinary(treeBuf);
+	double treeSaveMs = MsSince(start);
+	start = Clock::now();
+	flat.saveBinary(flatBuf);
+	double flatSaveMs = MsSince(start);
+
+	double treeLoadMs = 1e30, flatLoadMs = 1e30;
+	for (int i = 0; i < 5; ++i)
+	{
+		ImGui::TreeView t;
+		start = Clock::now();
+		t.loadBinary(treeBuf.Data, (size_t)treeBuf.Size);
+		treeLoadMs = std::min(treeLoadMs, MsSince(start));
+
+		ImGui::FlatTreeView f;
+		start = Clock::now();
+		f.loadBinary(flatBuf.Data, (size_t)flatBuf.Size);
+		flatLoadMs = std::min(flatLoadMs, MsSince(start));
+	}
+
+	std::fprintf(out, "%d nodes, best of 5 loads:\n", flat.getNumNodes());
+	std::fprintf(out, "  TreeView      %9d bytes  save %7.2f ms  load %7.2f ms\n", treeBuf.Size, treeSaveMs, treeLoadMs);
+	std::fprintf(out, "  FlatTreeView  %9d bytes  save %7.2f ms  load %7.2f ms\n", flatBuf.Size, flatSaveMs, flatLoadMs);
+
+	ImGui::DestroyContext(context);
+	return mismatches == 0 && paddingLeaks == 0;
+}
@@ -0,0 +1,15 @@
+#pragma once
+
+// Stand-in for the plugin's precompiled header. The vendored ImGui sources
+// include "pch.h" first; the scanner builds them for --tree-check without
+// the BakkesMod SDK, so this one only pulls in the standard headers and
+// ImGui. The include path lists this directory before ../RLGrab so it wins
+// over the plugin's.
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "imgui.h"